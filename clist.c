@@ -0,0 +1,302 @@
+#include "clist.h"
+#include "llist_epoch.h"
+
+#include <errno.h>
+#include <sched.h>
+#include <stdlib.h>
+
+/// Attempts before a waiting thread yields the processor.
+#define CLIST_SPIN_LIMIT 64
+
+struct clist {
+    /// Sentinels ordered before and after every element; never marked, never removed.
+    ///
+    ///     +----+    +------+         +------+    +----+
+    ///     |head|--->| node |-->...-->| node |--->|tail|
+    ///     +----+    +------+         +------+    +----+
+    ///
+    /// Nodes are only ever reached by following @c next, so a singly-linked chain suffices.
+    struct clist_node head;
+    struct clist_node tail;
+    atomic_size_t size;
+    size_t offset;
+    int (*cmp)(const void *, const void *);
+};
+
+struct clist *clist_new(size_t offset, int (*cmp)(const void *, const void *))
+{
+    struct clist *l;
+
+    if (!cmp) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    if ((offset % sizeof(void *)) != 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    l = calloc(1, sizeof(struct clist));
+    if (!l) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    atomic_init(&l->head.next, &l->tail);
+    atomic_init(&l->head.marked, false);
+    atomic_flag_clear(&l->head.lock);
+    atomic_init(&l->tail.next, NULL);
+    atomic_init(&l->tail.marked, false);
+    atomic_flag_clear(&l->tail.lock);
+    atomic_init(&l->size, 0);
+    l->offset = offset;
+    l->cmp = cmp;
+    return l;
+}
+
+void clist_delete(struct clist *l, void (*destructor)(void *))
+{
+    struct clist_node *node;
+
+    if (!l) {
+        return;
+    }
+
+    node = atomic_load_explicit(&l->head.next, memory_order_relaxed);
+    while (node != &l->tail) {
+        struct clist_node *next = atomic_load_explicit(&node->next, memory_order_relaxed);
+        if (destructor) {
+            destructor((char *)node - l->offset);
+        }
+        node = next;
+    }
+
+    free(l);
+}
+
+size_t clist_size(const struct clist *l)
+{
+    if (!l) {
+        return 0;
+    }
+
+    return atomic_load_explicit(&l->size, memory_order_relaxed);
+}
+
+static void impl_lock(struct clist_node *node)
+{
+    unsigned spins = 0;
+
+    while (atomic_flag_test_and_set_explicit(&node->lock, memory_order_acquire)) {
+        if (++spins == CLIST_SPIN_LIMIT) {
+            spins = 0;
+            sched_yield();
+        }
+    }
+}
+
+static void impl_unlock(struct clist_node *node)
+{
+    atomic_flag_clear_explicit(&node->lock, memory_order_release);
+}
+
+static struct clist_node *impl_next(struct clist_node *node)
+{
+    return atomic_load_explicit(&node->next, memory_order_acquire);
+}
+
+/// Compare the element of @c node to @c key.
+/// @return Less than, equal to, or greater than zero; the tail sentinel compares greater than any key.
+static int impl_cmp(const struct clist *l, const struct clist_node *node, const void *key)
+{
+    if (node == &l->tail) {
+        return 1;
+    }
+
+    return l->cmp((const char *)node - l->offset, key);
+}
+
+/// Find the first node not less than @c key, and its predecessor.
+/// @note Caller must be in an epoch section. Takes no locks.
+static void impl_locate(struct clist *l, const void *key, struct clist_node **pred, struct clist_node **curr)
+{
+    struct clist_node *p = &l->head;
+    struct clist_node *c = impl_next(p);
+
+    while (impl_cmp(l, c, key) < 0) {
+        p = c;
+        c = impl_next(c);
+    }
+
+    *pred = p;
+    *curr = c;
+}
+
+/// Lock @c pred and @c curr, and check that both are still linked and adjacent.
+/// @return True with both nodes locked, or false with neither locked.
+static bool impl_lock_validate(struct clist_node *pred, struct clist_node *curr)
+{
+    impl_lock(pred);
+    impl_lock(curr);
+
+    if (!atomic_load(&pred->marked) && !atomic_load(&curr->marked) &&
+        atomic_load_explicit(&pred->next, memory_order_relaxed) == curr) {
+        return true;
+    }
+
+    impl_unlock(curr);
+    impl_unlock(pred);
+    return false;
+}
+
+int clist_insert(struct clist *l, void *element)
+{
+    struct clist_node *node;
+    struct clist_node *pred;
+    struct clist_node *curr;
+    int r;
+
+    if (!l || !element) {
+        return -EFAULT;
+    }
+
+    r = list_epoch_enter();
+    if (r < 0) {
+        return r;
+    }
+
+    node = (struct clist_node *)((char *)element + l->offset);
+    atomic_init(&node->marked, false);
+    atomic_flag_clear(&node->lock);
+
+    do {
+        impl_locate(l, element, &pred, &curr);
+    } while (!impl_lock_validate(pred, curr));
+
+    if (impl_cmp(l, curr, element) == 0) {
+        r = -EEXIST;
+    } else {
+        atomic_store_explicit(&node->next, curr, memory_order_relaxed);
+        // Publish: readers that see the node also see its initialised fields.
+        atomic_store_explicit(&pred->next, node, memory_order_release);
+        atomic_fetch_add_explicit(&l->size, 1, memory_order_relaxed);
+    }
+
+    impl_unlock(curr);
+    impl_unlock(pred);
+    list_epoch_exit();
+    return r;
+}
+
+int clist_remove(struct clist *l, const void *key, void (*destructor)(void *))
+{
+    struct list_epoch_retired *record;
+    struct clist_node *pred;
+    struct clist_node *curr;
+    int r;
+
+    if (!l || !key) {
+        return -EFAULT;
+    }
+
+    // Allocate up front, so that nothing can fail once the element is unlinked.
+    record = malloc(sizeof(struct list_epoch_retired));
+    if (!record) {
+        return -ENOMEM;
+    }
+
+    r = list_epoch_enter();
+    if (r < 0) {
+        free(record);
+        return r;
+    }
+
+    do {
+        impl_locate(l, key, &pred, &curr);
+    } while (!impl_lock_validate(pred, curr));
+
+    if (impl_cmp(l, curr, key) != 0) {
+        r = -ENOENT;
+    } else {
+        // Logical removal first: concurrent searches that already reached the node now report it absent.
+        atomic_store(&curr->marked, true);
+        atomic_store_explicit(&pred->next, atomic_load_explicit(&curr->next, memory_order_relaxed),
+                              memory_order_release);
+        atomic_fetch_sub_explicit(&l->size, 1, memory_order_relaxed);
+    }
+
+    impl_unlock(curr);
+    impl_unlock(pred);
+    list_epoch_exit();
+
+    if (r < 0) {
+        free(record);
+        return r;
+    }
+
+    list_epoch_retire(record, (char *)curr - l->offset, destructor);
+    return 0;
+}
+
+bool clist_contains(struct clist *l, const void *key)
+{
+    struct clist_node *node;
+    bool found;
+    int r;
+
+    if (!l || !key) {
+        errno = EFAULT;
+        return false;
+    }
+
+    r = list_epoch_enter();
+    if (r < 0) {
+        errno = -r;
+        return false;
+    }
+
+    node = impl_next(&l->head);
+    while (impl_cmp(l, node, key) < 0) {
+        node = impl_next(node);
+    }
+
+    found = impl_cmp(l, node, key) == 0 && !atomic_load(&node->marked);
+
+    list_epoch_exit();
+    return found;
+}
+
+int clist_for_each(struct clist *l, int (*fn)(void *element, void *ctx), void *ctx)
+{
+    struct clist_node *node;
+    int r;
+
+    if (!l || !fn) {
+        return -EFAULT;
+    }
+
+    r = list_epoch_enter();
+    if (r < 0) {
+        return r;
+    }
+
+    for (node = impl_next(&l->head); node != &l->tail; node = impl_next(node)) {
+        if (atomic_load(&node->marked)) {
+            continue;
+        }
+
+        r = fn((char *)node - l->offset, ctx);
+        if (r) {
+            break;
+        }
+    }
+
+    list_epoch_exit();
+    return r;
+}
+
+void clist_synchronize(void)
+{
+    list_epoch_synchronize();
+}
@@ -0,0 +1,109 @@
+#ifndef LIBLIST_CLIST_H_
+#define LIBLIST_CLIST_H_
+
+/// Concurrent ordered list (lazy list).
+///
+/// A sorted set of elements that many threads may search and update at once, based on the "lazy list" of Heller et
+/// al.: updates lock only the two nodes around the change, removal first marks the node as deleted and then unlinks
+/// it, and searches and traversals take no locks at all.
+///
+/// Elements embed @c CLIST_NODE, and are ordered by a comparison function given to @c clist_new.
+///
+/// Example:
+///
+///     struct my_item {
+///         int key;
+///         CLIST_NODE(link);
+///     };
+///
+///     struct clist *set = clist_new(offsetof(my_item, link), cmp_key);
+///
+/// Return conventions follow @c llist.h.
+///
+/// Memory reclamation: removed elements may still be visible to concurrent readers, so their destructor is deferred
+/// until every operation in progress at removal time has finished (epoch-based reclamation).
+///
+/// @note Requires C11 atomics.
+/// @note @c clist_new and @c clist_delete must not run concurrently with other operations on the same list.
+
+#define CLIST_NODE(name) struct clist_node name
+
+#include "llist.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/// Concurrent list object.
+struct clist;
+
+struct clist_node {
+    _Atomic(struct clist_node *) next;
+    /// Set when the node is logically deleted; never cleared while the node is linked.
+    atomic_bool marked;
+    atomic_flag lock;
+};
+
+/// Constructor.
+/// @param offset The offset to @c clist_node in list elements.
+/// @param cmp Comparison function returning less than, equal to, or greater than zero if the first element is
+///            respectively less than, equal to, or greater than the second.
+/// @return Pointer to list on success.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Offset invalid.
+///   - ENOMEM: Insufficient memory.
+/// @note Memory ownership: Caller must clist_delete() the returned pointer.
+struct clist *clist_new(size_t offset, int (*cmp)(const void *, const void *)) PUBLIC;
+
+/// Destructor.
+/// @see list_delete.
+/// @note Elements removed earlier may still be awaiting their deferred destructor; see @c clist_synchronize.
+void clist_delete(struct clist *, void (*destructor)(void *)) PUBLIC;
+
+/// Get number of elements in list.
+/// @return The number of elements in the list, or zero if NULL.
+/// @note Under concurrent updates the value may be out of date as soon as it is returned.
+size_t clist_size(const struct clist *) PUBLIC;
+
+/// Insert @c element in order.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EEXIST: An equal element is already present.
+///   - ENOMEM: Insufficient memory.
+/// @note Locks the two nodes around the insertion point.
+int clist_insert(struct clist *, void *element) PUBLIC;
+
+/// Remove the element equal to @c key.
+/// @param key Element, or an object of the element type with the compared fields set.
+/// @param destructor Called for the removed element once no concurrent operation can still reference it, or NULL.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - ENOENT: No equal element.
+///   - ENOMEM: Insufficient memory.
+/// @note If @c destructor is NULL, the caller regains ownership once @c clist_synchronize returns.
+int clist_remove(struct clist *, const void *key, void (*destructor)(void *)) PUBLIC;
+
+/// Test whether an element equal to @c key is present.
+/// @return True if present.
+/// @return False if absent, or on failure; errno is then set to:
+///   - EFAULT: NULL pointer argument.
+///   - ENOMEM: Insufficient memory.
+/// @note Wait-free: takes no locks, and never retries.
+bool clist_contains(struct clist *, const void *key) PUBLIC;
+
+/// Call @c fn for each element, in order.
+/// Elements inserted or removed concurrently may or may not be visited.
+/// @param fn Function called with each element and @c ctx; a non-zero return value stops the traversal.
+/// @return Zero on success, or the first non-zero value returned by @c fn.
+/// @return Negative errno on failure:
+///   - EFAULT: NULL pointer argument.
+///   - ENOMEM: Insufficient memory.
+/// @note Wait-free: takes no locks. @c fn may insert and remove elements.
+int clist_for_each(struct clist *, int (*fn)(void *element, void *ctx), void *ctx) PUBLIC;
+
+/// Wait until all elements removed before the call have been destroyed.
+/// @warning Must not be called from within @c clist_for_each.
+void clist_synchronize(void) PUBLIC;
+
+#endif
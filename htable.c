@@ -0,0 +1,336 @@
+#include "htable.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// Initial number of buckets; a power of two.
+#define HTABLE_BUCKETS_MIN 16
+
+/// Bucket array. Each bucket is the head of a circular chain of @c list_node; a zeroed head is an empty bucket, so
+/// that arrays need no initialisation beyond @c calloc.
+struct htable_buckets {
+    struct list_node *heads;
+    size_t mask;
+};
+
+struct htable {
+    /// Buckets that new elements go to.
+    struct htable_buckets cur;
+    /// Buckets being rehashed into @c cur while the table grows; @c old.heads is NULL otherwise.
+    struct htable_buckets old;
+    /// Old buckets below this index are already rehashed.
+    size_t migrated;
+    size_t size;
+    size_t offset;
+    size_t key_offset;
+    size_t (*hash)(const void *);
+    int (*cmp)(const void *, const void *);
+};
+
+struct htable *htable_new(size_t offset, size_t key_offset, size_t (*hash)(const void *),
+                          int (*cmp)(const void *, const void *))
+{
+    struct htable *t;
+
+    if (!hash || !cmp) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    if ((offset % sizeof(void *)) != 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    t = calloc(1, sizeof(struct htable));
+    if (!t) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    t->cur.heads = calloc(HTABLE_BUCKETS_MIN, sizeof(struct list_node));
+    if (!t->cur.heads) {
+        free(t);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    t->cur.mask = HTABLE_BUCKETS_MIN - 1;
+    t->offset = offset;
+    t->key_offset = key_offset;
+    t->hash = hash;
+    t->cmp = cmp;
+    return t;
+}
+
+static struct htable_node *impl_node(const struct htable *t, const void *element)
+{
+    return (struct htable_node *)((char *)element + t->offset);
+}
+
+static void *impl_element(const struct htable *t, struct list_node *link)
+{
+    return (char *)link - t->offset;
+}
+
+static const void *impl_key(const struct htable *t, struct list_node *link)
+{
+    return (char *)impl_element(t, link) + t->key_offset;
+}
+
+/// Call @c fn for each element in @c b, stopping at the first non-zero return value.
+/// @c fn may unlink the element it is given.
+static int impl_walk(const struct htable *t, const struct htable_buckets *b, size_t first,
+                     int (*fn)(void *, void *), void *ctx)
+{
+    if (!b->heads) {
+        return 0;
+    }
+
+    for (size_t i = first; i <= b->mask; i++) {
+        struct list_node *head = &b->heads[i];
+        struct list_node *link = head->next;
+
+        while (link && link != head) {
+            struct list_node *next = link->next;
+            int result = fn(impl_element(t, link), ctx);
+
+            if (result != 0) {
+                return result;
+            }
+            link = next;
+        }
+    }
+
+    return 0;
+}
+
+static int impl_destroy(void *element, void *ctx)
+{
+    ((void (*)(void *))ctx)(element);
+    return 0;
+}
+
+void htable_delete(struct htable *t, void (*destructor)(void *))
+{
+    if (!t) {
+        return;
+    }
+
+    if (destructor) {
+        impl_walk(t, &t->old, t->migrated, impl_destroy, (void *)destructor);
+        impl_walk(t, &t->cur, 0, impl_destroy, (void *)destructor);
+    }
+
+    free(t->old.heads);
+    free(t->cur.heads);
+    free(t);
+}
+
+size_t htable_size(const struct htable *t)
+{
+    if (!t) {
+        return 0;
+    }
+
+    return t->size;
+}
+
+/// @return The bucket that holds, or would hold, elements with @c hash.
+static struct list_node *impl_bucket(const struct htable *t, size_t hash)
+{
+    if (t->old.heads && (hash & t->old.mask) >= t->migrated) {
+        return &t->old.heads[hash & t->old.mask];
+    }
+
+    return &t->cur.heads[hash & t->cur.mask];
+}
+
+static void impl_link(struct list_node *head, struct list_node *link)
+{
+    if (!head->next) {
+        head->next = head;
+        head->prev = head;
+    }
+
+    link->next = head->next;
+    link->prev = head;
+    head->next->prev = link;
+    head->next = link;
+}
+
+static void impl_unlink(struct list_node *link)
+{
+    link->prev->next = link->next;
+    link->next->prev = link->prev;
+    link->next = NULL;
+    link->prev = NULL;
+}
+
+/// Rehash up to @c n old buckets into the current ones, and release the old ones once all are rehashed.
+static void impl_migrate(struct htable *t, size_t n)
+{
+    if (!t->old.heads) {
+        return;
+    }
+
+    for (; n > 0 && t->migrated <= t->old.mask; n--, t->migrated++) {
+        struct list_node *head = &t->old.heads[t->migrated];
+        struct list_node *link = head->next;
+
+        while (link && link != head) {
+            struct list_node *next = link->next;
+            impl_link(&t->cur.heads[((struct htable_node *)link)->hash & t->cur.mask], link);
+            link = next;
+        }
+    }
+
+    if (t->migrated > t->old.mask) {
+        free(t->old.heads);
+        t->old.heads = NULL;
+        t->migrated = 0;
+    }
+}
+
+/// Start doubling the buckets once there are more elements than buckets.
+/// If memory is short the buckets are left as is; chains just grow longer.
+static void impl_grow(struct htable *t)
+{
+    struct list_node *heads;
+    size_t mask = t->cur.mask * 2 + 1;
+
+    // Each operation migrates at least one old bucket, so the previous rehash always completes before the element
+    // count doubles again.
+    if (t->size <= t->cur.mask + 1 || mask >= SIZE_MAX / sizeof(struct list_node)) {
+        return;
+    }
+
+    heads = calloc(mask + 1, sizeof(struct list_node));
+    if (!heads) {
+        return;
+    }
+
+    t->old = t->cur;
+    t->cur.heads = heads;
+    t->cur.mask = mask;
+    t->migrated = 0;
+}
+
+/// @return The node of the element equal to @c key in @c head, or NULL.
+static struct list_node *impl_find(const struct htable *t, struct list_node *head, const void *key, size_t hash)
+{
+    struct list_node *link = head->next;
+
+    while (link && link != head) {
+        if (((struct htable_node *)link)->hash == hash && t->cmp(impl_key(t, link), key) == 0) {
+            return link;
+        }
+        link = link->next;
+    }
+
+    return NULL;
+}
+
+int htable_insert(struct htable *t, void *element)
+{
+    struct htable_node *node;
+    struct list_node *head;
+    size_t hash;
+
+    if (!t || !element) {
+        return -EFAULT;
+    }
+
+    if (t->size == SIZE_MAX) {
+        // Detect pathological overflow case.
+        return -EOVERFLOW;
+    }
+
+    impl_migrate(t, HTABLE_REHASH_STEP);
+
+    node = impl_node(t, element);
+    hash = t->hash((char *)element + t->key_offset);
+    head = impl_bucket(t, hash);
+    if (impl_find(t, head, (char *)element + t->key_offset, hash)) {
+        return -EEXIST;
+    }
+
+    node->hash = hash;
+    node->link.list = NULL;
+    impl_link(head, &node->link);
+    t->size++;
+
+    impl_grow(t);
+    return 0;
+}
+
+void *htable_find(struct htable *t, const void *key)
+{
+    struct list_node *link;
+    size_t hash;
+
+    if (!t || !key) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    impl_migrate(t, HTABLE_REHASH_STEP);
+
+    hash = t->hash(key);
+    link = impl_find(t, impl_bucket(t, hash), key, hash);
+    if (!link) {
+        errno = ENOENT;
+        return NULL;
+    }
+
+    return impl_element(t, link);
+}
+
+void *htable_remove(struct htable *t, const void *key)
+{
+    void *element = htable_find(t, key);
+
+    if (!element) {
+        return NULL;
+    }
+
+    impl_unlink(&impl_node(t, element)->link);
+    t->size--;
+    return element;
+}
+
+int htable_erase(struct htable *t, void *element)
+{
+    struct htable_node *node;
+
+    if (!t || !element) {
+        return -EFAULT;
+    }
+
+    node = impl_node(t, element);
+    if (!node->link.next) {
+        return -EINVAL;
+    }
+
+    // No rehash step here, so that elements can be erased during htable_for_each.
+    impl_unlink(&node->link);
+    t->size--;
+    return 0;
+}
+
+int htable_for_each(struct htable *t, int (*fn)(void *, void *), void *ctx)
+{
+    int result;
+
+    if (!t || !fn) {
+        return -EFAULT;
+    }
+
+    result = impl_walk(t, &t->old, t->migrated, fn, ctx);
+    if (result != 0) {
+        return result;
+    }
+
+    return impl_walk(t, &t->cur, 0, fn, ctx);
+}
@@ -0,0 +1,113 @@
+#ifndef LIBLIST_HTABLE_H_
+#define LIBLIST_HTABLE_H_
+
+/// Intrusive hash table.
+///
+/// Elements embed @c HTABLE_NODE, whose @c struct list_node links them into a bucket chain, so that the table never
+/// allocates per element and an element is unlinked in O(1) without a lookup. Keys are found at a configurable
+/// offset within elements, and hashed and compared by user functions.
+///
+/// Example:
+///
+///     struct my_item {
+///         int key;
+///         HTABLE_NODE(link);
+///     };
+///
+///     struct htable *t = htable_new(offsetof(struct my_item, link), offsetof(struct my_item, key), hash_int,
+///                                   cmp_int);
+///
+///     htable_insert(t, item);
+///     item = htable_find(t, &(int){ 42 });
+///
+/// The table doubles its bucket count once it holds more elements than buckets. Rather than rehashing every element
+/// at once, it moves @c HTABLE_REHASH_STEP buckets from the old bucket array to the new one on each insertion or lookup,
+/// bounding the cost of any single operation during growth.
+///
+/// Return conventions follow @c llist.h.
+
+#define HTABLE_NODE(name) struct htable_node name
+
+#include "llist.h"
+
+#include <stddef.h>
+
+/// Number of old buckets rehashed by each operation while the table grows.
+#define HTABLE_REHASH_STEP 4
+
+/// Hash table object.
+/// This library is **not** thread-safe.
+struct htable;
+
+struct htable_node {
+    /// Bucket chain link; @c link.next is NULL while the element is not in a table.
+    struct list_node link;
+    /// Cached hash of the element's key.
+    size_t hash;
+};
+
+/// Constructor.
+/// @param offset The offset to @c htable_node in elements.
+/// @param key_offset The offset to the key in elements.
+/// @param hash Hash function, called with a pointer to a key.
+/// @param cmp Comparison function, called with pointers to two keys; returns zero if they are equal.
+/// @return Pointer to table on success.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Offset invalid.
+///   - ENOMEM: Insufficient memory.
+/// @note Memory ownership: Caller must htable_delete() the returned pointer.
+struct htable *htable_new(size_t offset, size_t key_offset, size_t (*hash)(const void *key),
+                          int (*cmp)(const void *a, const void *b)) PUBLIC;
+
+/// Destructor.
+/// @see list_delete.
+void htable_delete(struct htable *, void (*destructor)(void *)) PUBLIC;
+
+/// Get number of elements in table.
+/// @return The number of elements, or zero if NULL.
+size_t htable_size(const struct htable *) PUBLIC;
+
+/// Insert @c element.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EEXIST: An element with an equal key is already present.
+///   - EOVERFLOW: Table cannot grow.
+/// @note If memory for more buckets is short, the table keeps its bucket count; chains grow longer.
+/// @note Memory ownership: On success the table takes ownership of the element.
+/// @note Complexity: O(1) expected.
+int htable_insert(struct htable *, void *element) PUBLIC;
+
+/// Find the element with a key equal to @c key.
+/// @param key Pointer to a key.
+/// @return Pointer to element on success.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+///   - ENOENT: No equal element.
+/// @note Complexity: O(1) expected.
+void *htable_find(struct htable *, const void *key) PUBLIC;
+
+/// Remove the element with a key equal to @c key.
+/// @return Pointer to the removed element on success.
+/// @return NULL on failure, and errno is set as for @c htable_find.
+/// @note Memory ownership: On success the caller regains ownership of the element.
+void *htable_remove(struct htable *, const void *key) PUBLIC;
+
+/// Remove @c element, without a lookup.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Element not in a table.
+/// @warning The element must be in this table.
+/// @note Memory ownership: On success the caller regains ownership of the element.
+/// @note Complexity: O(1).
+int htable_erase(struct htable *, void *element) PUBLIC;
+
+/// Call @c fn for each element, in no particular order.
+/// @param fn Function called with each element and @c ctx; a non-zero return value stops the traversal.
+/// @return Zero on success, or the first non-zero value returned by @c fn.
+/// @return Negative errno on failure:
+///   - EFAULT: NULL pointer argument.
+/// @note @c fn may erase the element it is given, but must not otherwise modify the table.
+int htable_for_each(struct htable *, int (*fn)(void *element, void *ctx), void *ctx) PUBLIC;
+
+#endif
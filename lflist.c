@@ -0,0 +1,306 @@
+#include "lflist.h"
+#include "llist_epoch.h"
+
+#include <errno.h>
+#include <stdlib.h>
+
+/// Mark bit in @c lflist_node.next.
+#define LFLIST_MARK ((uintptr_t)1)
+
+struct lflist {
+    /// Sentinels ordered before and after every element; never marked, never removed.
+    ///
+    ///     +----+    +------+         +------+    +----+
+    ///     |head|--->| node |-->...-->| node |--->|tail|
+    ///     +----+    +------+         +------+    +----+
+    ///
+    /// A node whose @c next is marked is logically deleted, but may remain linked until a later traversal unlinks it.
+    struct lflist_node head;
+    struct lflist_node tail;
+    atomic_size_t size;
+    size_t offset;
+    int (*cmp)(const void *, const void *);
+};
+
+struct lflist *lflist_new(size_t offset, int (*cmp)(const void *, const void *))
+{
+    struct lflist *l;
+
+    if (!cmp) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    if ((offset % sizeof(void *)) != 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    l = calloc(1, sizeof(struct lflist));
+    if (!l) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    atomic_init(&l->head.next, (uintptr_t)&l->tail);
+    atomic_init(&l->tail.next, 0);
+    atomic_init(&l->size, 0);
+    l->offset = offset;
+    l->cmp = cmp;
+    return l;
+}
+
+static struct lflist_node *impl_node(uintptr_t link)
+{
+    return (struct lflist_node *)(link & ~LFLIST_MARK);
+}
+
+static void *impl_element(const struct lflist *l, struct lflist_node *node)
+{
+    return (char *)node - l->offset;
+}
+
+void lflist_delete(struct lflist *l, void (*destructor)(void *))
+{
+    struct lflist_node *node;
+
+    if (!l) {
+        return;
+    }
+
+    node = impl_node(atomic_load_explicit(&l->head.next, memory_order_relaxed));
+    while (node != &l->tail) {
+        struct lflist_node *next = impl_node(atomic_load_explicit(&node->next, memory_order_relaxed));
+        if (destructor) {
+            destructor(impl_element(l, node));
+        }
+        node = next;
+    }
+
+    free(l);
+}
+
+size_t lflist_size(const struct lflist *l)
+{
+    if (!l) {
+        return 0;
+    }
+
+    return atomic_load_explicit(&l->size, memory_order_relaxed);
+}
+
+/// Compare the element of @c node to @c key.
+/// @return Less than, equal to, or greater than zero; the tail sentinel compares greater than any key.
+static int impl_cmp(const struct lflist *l, struct lflist_node *node, const void *key)
+{
+    if (node == &l->tail) {
+        return 1;
+    }
+
+    return l->cmp(impl_element(l, node), key);
+}
+
+/// Find the first unmarked node not less than @c key, and its predecessor, unlinking marked nodes on the way.
+/// @return True on success; false if another thread changed a link first, and the search must restart.
+/// @note Caller must be in an epoch section.
+static bool impl_find(struct lflist *l, const void *key, struct lflist_node **pred, struct lflist_node **curr)
+{
+    struct lflist_node *p = &l->head;
+    struct lflist_node *c = impl_node(atomic_load(&p->next));
+
+    for (;;) {
+        uintptr_t succ = atomic_load(&c->next);
+
+        if (succ & LFLIST_MARK) {
+            // Unlink the deleted node; fails if p has changed, or is itself being deleted.
+            uintptr_t expected = (uintptr_t)c;
+            if (!atomic_compare_exchange_strong(&p->next, &expected, succ & ~LFLIST_MARK)) {
+                return false;
+            }
+            c = impl_node(succ);
+            continue;
+        }
+
+        if (impl_cmp(l, c, key) >= 0) {
+            *pred = p;
+            *curr = c;
+            return true;
+        }
+
+        p = c;
+        c = impl_node(succ);
+    }
+}
+
+/// Unlink the marked node @c curr.
+/// If @c pred no longer links to it, search again: the search unlinks @c curr on its way past.
+static void impl_unlink(struct lflist *l, const void *key, struct lflist_node *pred, struct lflist_node *curr,
+                        uintptr_t succ)
+{
+    uintptr_t expected = (uintptr_t)curr;
+
+    if (atomic_compare_exchange_strong(&pred->next, &expected, succ)) {
+        return;
+    }
+
+    while (!impl_find(l, key, &pred, &curr)) {
+    }
+}
+
+int lflist_insert(struct lflist *l, void *element)
+{
+    struct lflist_node *node;
+    struct lflist_node *pred;
+    struct lflist_node *curr;
+    int r;
+
+    if (!l || !element) {
+        return -EFAULT;
+    }
+
+    r = list_epoch_enter();
+    if (r < 0) {
+        return r;
+    }
+
+    node = (struct lflist_node *)((char *)element + l->offset);
+
+    for (;;) {
+        uintptr_t expected;
+
+        while (!impl_find(l, element, &pred, &curr)) {
+        }
+
+        if (impl_cmp(l, curr, element) == 0) {
+            r = -EEXIST;
+            break;
+        }
+
+        atomic_store_explicit(&node->next, (uintptr_t)curr, memory_order_relaxed);
+        expected = (uintptr_t)curr;
+        // Release: readers that see the node also see its initialised fields.
+        if (atomic_compare_exchange_strong(&pred->next, &expected, (uintptr_t)node)) {
+            atomic_fetch_add_explicit(&l->size, 1, memory_order_relaxed);
+            break;
+        }
+    }
+
+    list_epoch_exit();
+    return r;
+}
+
+int lflist_remove(struct lflist *l, const void *key, void (*destructor)(void *))
+{
+    struct list_epoch_retired *record;
+    struct lflist_node *pred;
+    struct lflist_node *curr;
+    uintptr_t succ;
+    int r;
+
+    if (!l || !key) {
+        return -EFAULT;
+    }
+
+    // Allocate up front, so that nothing can fail once the element is marked.
+    record = malloc(sizeof(struct list_epoch_retired));
+    if (!record) {
+        return -ENOMEM;
+    }
+
+    r = list_epoch_enter();
+    if (r < 0) {
+        free(record);
+        return r;
+    }
+
+    // Logical removal: whoever sets the mark owns the removal. Marking fails if another thread marked curr first, or
+    // inserted behind it.
+    do {
+        while (!impl_find(l, key, &pred, &curr)) {
+        }
+
+        if (impl_cmp(l, curr, key) != 0) {
+            r = -ENOENT;
+            break;
+        }
+
+        succ = atomic_load(&curr->next) & ~LFLIST_MARK;
+    } while (!atomic_compare_exchange_strong(&curr->next, &succ, succ | LFLIST_MARK));
+
+    if (r == 0) {
+        impl_unlink(l, key, pred, curr, succ);
+        atomic_fetch_sub_explicit(&l->size, 1, memory_order_relaxed);
+    }
+
+    list_epoch_exit();
+
+    if (r < 0) {
+        free(record);
+        return r;
+    }
+
+    list_epoch_retire(record, impl_element(l, curr), destructor);
+    return 0;
+}
+
+bool lflist_contains(struct lflist *l, const void *key)
+{
+    struct lflist_node *node;
+    bool found;
+    int r;
+
+    if (!l || !key) {
+        errno = EFAULT;
+        return false;
+    }
+
+    r = list_epoch_enter();
+    if (r < 0) {
+        errno = -r;
+        return false;
+    }
+
+    node = impl_node(atomic_load(&l->head.next));
+    while (impl_cmp(l, node, key) < 0) {
+        node = impl_node(atomic_load(&node->next));
+    }
+
+    found = impl_cmp(l, node, key) == 0 && !(atomic_load(&node->next) & LFLIST_MARK);
+
+    list_epoch_exit();
+    return found;
+}
+
+int lflist_for_each(struct lflist *l, int (*fn)(void *element, void *ctx), void *ctx)
+{
+    struct lflist_node *node;
+    int r;
+
+    if (!l || !fn) {
+        return -EFAULT;
+    }
+
+    r = list_epoch_enter();
+    if (r < 0) {
+        return r;
+    }
+
+    for (node = impl_node(atomic_load(&l->head.next)); node != &l->tail; node = impl_node(atomic_load(&node->next))) {
+        if (atomic_load(&node->next) & LFLIST_MARK) {
+            continue;
+        }
+
+        r = fn(impl_element(l, node), ctx);
+        if (r) {
+            break;
+        }
+    }
+
+    list_epoch_exit();
+    return r;
+}
+
+void lflist_synchronize(void)
+{
+    list_epoch_synchronize();
+}
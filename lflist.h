@@ -0,0 +1,91 @@
+#ifndef LIBLIST_LFLIST_H_
+#define LIBLIST_LFLIST_H_
+
+/// Lock-free ordered list (Harris-Michael).
+///
+/// A sorted set of elements that many threads may search and update at once, without any locks: every update is
+/// a single compare-and-swap on a @c next pointer. Removal first sets a mark bit in the removed node's own @c next
+/// pointer, which both deletes it logically and stops concurrent inserts behind it; any thread that later passes
+/// the marked node unlinks it.
+///
+/// Unlike @c clist.h, a stalled thread never blocks others; in exchange, updates may retry under contention.
+///
+/// Elements embed @c LFLIST_NODE, and are ordered by a comparison function given to @c lflist_new.
+///
+/// Example:
+///
+///     struct my_item {
+///         int key;
+///         LFLIST_NODE(link);
+///     };
+///
+///     struct lflist *set = lflist_new(offsetof(my_item, link), cmp_key);
+///
+/// Return conventions follow @c llist.h.
+///
+/// Memory reclamation: removed elements may still be visible to concurrent readers, so their destructor is deferred
+/// until every operation in progress at removal time has finished (epoch-based reclamation, shared with @c clist.h).
+/// Each thread keeps its own removed elements and destroys them in batches, so reclamation takes no locks either.
+/// The exceptions are a thread's first operation, which registers it with the reclamation scheme, and the
+/// allocator: @c lflist_remove allocates a small record with malloc(), and may run deferred destructors.
+///
+/// @note Requires C11 atomics.
+/// @note @c lflist_new and @c lflist_delete must not run concurrently with other operations on the same list.
+
+#define LFLIST_NODE(name) struct lflist_node name
+
+#include "llist.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Lock-free list object.
+struct lflist;
+
+struct lflist_node {
+    /// Successor, with bit 0 set once this node is logically deleted.
+    _Atomic(uintptr_t) next;
+};
+
+/// Constructor.
+/// @see clist_new.
+struct lflist *lflist_new(size_t offset, int (*cmp)(const void *, const void *)) PUBLIC;
+
+/// Destructor.
+/// @see clist_delete.
+void lflist_delete(struct lflist *, void (*destructor)(void *)) PUBLIC;
+
+/// Get number of elements in list.
+/// @return The number of elements in the list, or zero if NULL.
+/// @note Under concurrent updates the value may be out of date as soon as it is returned.
+size_t lflist_size(const struct lflist *) PUBLIC;
+
+/// Insert @c element in order.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EEXIST: An equal element is already present.
+///   - ENOMEM: Insufficient memory to register the calling thread.
+/// @note Lock-free, after the calling thread's first operation.
+int lflist_insert(struct lflist *, void *element) PUBLIC;
+
+/// Remove the element equal to @c key.
+/// @see clist_remove.
+/// @note Lock-free apart from malloc() of the deferred destruction record, and any destructors it runs.
+int lflist_remove(struct lflist *, const void *key, void (*destructor)(void *)) PUBLIC;
+
+/// Test whether an element equal to @c key is present.
+/// @see clist_contains.
+/// @note Wait-free: never writes to the list, and never retries.
+bool lflist_contains(struct lflist *, const void *key) PUBLIC;
+
+/// Call @c fn for each element, in order.
+/// @see clist_for_each.
+int lflist_for_each(struct lflist *, int (*fn)(void *element, void *ctx), void *ctx) PUBLIC;
+
+/// Wait until all elements removed before the call have been destroyed.
+/// @warning Must not be called from within @c lflist_for_each.
+void lflist_synchronize(void) PUBLIC;
+
+#endif
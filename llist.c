@@ -1,4 +1,7 @@
 #include "llist.h"
+#include "llist_inline.h"
+#include "llist_index.h"
+#include "llist_order.h"
 
 #include <assert.h>
 #include <errno.h>
@@ -6,40 +9,6 @@
 #include <stdint.h>
 #include <stdlib.h>
 
-#ifndef SIZE_MAX
-// Support compilation on Atari Lattice C.
-#define SIZE_MAX ((size_t)-1)
-#endif
-
-struct list {
-    /// Uses a dummy 'sentinel' node, in order to simplify link management.
-    ///
-    /// Base case:
-    ///           +------+
-    ///           v      |
-    ///     +--------+   |
-    ///     |    next|---+
-    ///     |sentinel|
-    /// +---|prev    |
-    /// |   +--------+
-    /// |      ^
-    /// +------+
-    ///
-    /// General case:
-    ///           +--------------------+
-    ///           v                    |
-    ///     +--------+    +--------+   |
-    ///     |    next|--->|    next|---+
-    ///     |sentinel|    |  node  |
-    /// +---|prev    |<---|prev    |
-    /// |   +--------+    +--------+
-    /// |                    ^
-    /// +--------------------+
-    struct list_node sentinel;
-    size_t size;
-    size_t offset;
-};
-
 /// Sanity check LIST_NODE @c offset.
 /// @return True if offset is valid.
 static bool check_offset(size_t offset)
@@ -52,6 +21,42 @@ static bool check_offset(size_t offset)
     return true;
 }
 
+#ifdef LLIST_STATS
+/// Add @c n to counter @c field of @c l.
+# define LIST_STATS_ADD(l, field, n) ((l)->stats.field += (n))
+/// Update the high-water size of @c l after it grew.
+# define LIST_STATS_GREW(l) impl_stats_grew(l)
+/// Count an advance of @c l by @c n nodes, walked or jumped through the index.
+# define LIST_STATS_ADVANCE(l, n, walked) impl_stats_advance(l, n, walked)
+
+static void impl_stats_grew(struct list *l)
+{
+    if (l->stats.high_water < l->size) {
+        l->stats.high_water = l->size;
+    }
+}
+
+static void impl_stats_advance(struct list *l, ssize_t n, bool walked)
+{
+    size_t distance = n < 0 ? (size_t)-(n + 1) + 1 : (size_t)n;
+    size_t bucket = 0;
+
+    if (walked) {
+        l->stats.advance_steps += distance;
+    }
+
+    for (; distance; distance >>= 1) {
+        bucket++;
+    }
+    l->stats.advance_log2[bucket]++;
+}
+#else
+// Counters compile to nothing; the arguments are only referenced to keep locals used.
+# define LIST_STATS_ADD(l, field, n) ((void)(l))
+# define LIST_STATS_GREW(l) ((void)(l))
+# define LIST_STATS_ADVANCE(l, n, walked) ((void)(l), (void)(n))
+#endif
+
 struct list *list_new(size_t offset)
 {
     struct list *l;
@@ -81,6 +86,8 @@ void list_delete(struct list *l, void (*destructor)(void *))
     }
 
     list_clear(l, destructor);
+    list_index_free(l->index);
+    list_order_free(l->order);
     free(l);
 }
 
@@ -98,27 +105,76 @@ size_t list_size(const struct list *l)
     return l->size;
 }
 
-int list_clear(struct list *l, void (*destructor)(void *))
+/// Detach the @c n nodes in [@c first, @c last) from @c l, then destroy them in one pass.
+/// Exactly one of @c destructor or @c batch is used, if non-NULL.
+/// @pre The range is non-empty and @c last follows @c first.
+static void impl_erase_range(struct list *l, struct list_node *first, struct list_node *last, size_t n,
+                             void (*destructor)(void *), void (*batch)(void **, size_t))
+{
+    void *elements[LIST_ERASE_BATCH];
+    struct list_node *tail = last->prev;
+    struct list_node *node = first;
+    size_t count = 0;
+
+    // Detach the range and account for it, so that destructors never observe dangling links, a stale size, or a
+    // stale generation.
+    first->prev->next = last;
+    last->prev = first->prev;
+    tail->next = NULL;
+    l->size -= n;
+    l->generation++;
+    LIST_STATS_ADD(l, erases, n);
+
+    while (node) {
+        struct list_node *next = node->next;
+        void *element = (char *)node - l->offset;
+
+        // Fetch the next node while the current element is destroyed.
+        LLIST_PREFETCH(next);
+
+        // Mark node as unlinked.
+        node->list = NULL;
+
+        if (batch) {
+            elements[count++] = element;
+            if (count == LIST_ERASE_BATCH) {
+                batch(elements, count);
+                count = 0;
+            }
+        } else if (destructor) {
+            destructor(element);
+        }
+
+        node = next;
+    }
+
+    if (count) {
+        batch(elements, count);
+    }
+}
+
+static int impl_clear(struct list *l, void (*destructor)(void *), void (*batch)(void **, size_t))
 {
     if (!l) {
         return -EFAULT;
     }
 
-    while (!list_empty(l)) {
-        int r = list_erase(list_begin(l), destructor);
-        if (r < 0) {
-            return r; // UNREACHABLE
-        }
+    if (l->size) {
+        impl_erase_range(l, l->sentinel.next, &l->sentinel, l->size, destructor, batch);
     }
 
     return 0;
 }
 
-/// Iterator has the same layout as list_node.
-/// Clients only ever see a pointer-to-iterator, thus the implementation is opaque.
-struct list_iter {
-    struct list_node node;
-};
+int list_clear(struct list *l, void (*destructor)(void *))
+{
+    return impl_clear(l, destructor, NULL);
+}
+
+int list_clear_batch(struct list *l, void (*destructor)(void **, size_t))
+{
+    return impl_clear(l, NULL, destructor);
+}
 
 struct list_iter *list_begin(struct list *l)
 {
@@ -133,12 +189,7 @@ struct list_iter *list_begin(struct list *l)
 
 const struct list_iter *list_cbegin(const struct list *l)
 {
-    if (!l) {
-        errno = EFAULT;
-        return NULL;
-    }
-
-    return (const struct list_iter *)l->sentinel.next;
+    return list_inline_cbegin(l);
 }
 
 struct list_iter *list_end(struct list *l)
@@ -154,32 +205,27 @@ struct list_iter *list_end(struct list *l)
 
 const struct list_iter *list_cend(const struct list *l)
 {
-    if (!l) {
-        errno = EFAULT;
-        return NULL;
-    }
-
-    return (const struct list_iter *)&l->sentinel;
+    return list_inline_cend(l);
 }
 
 struct list_iter *list_next(struct list_iter *it)
 {
-    return list_advance(it, 1);
+    return list_inline_next(it);
 }
 
 const struct list_iter *list_cnext(const struct list_iter *it)
 {
-    return list_advance_const(it, 1);
+    return list_inline_cnext(it);
 }
 
 struct list_iter *list_prev(struct list_iter *it)
 {
-    return list_advance(it, -1);
+    return list_inline_prev(it);
 }
 
 const struct list_iter *list_cprev(const struct list_iter *it)
 {
-    return list_advance_const(it, -1);
+    return list_inline_cprev(it);
 }
 
 struct list_iter *list_advance(struct list_iter *it, ssize_t n)
@@ -197,19 +243,35 @@ const struct list_iter *list_advance_const(const struct list_iter *it, ssize_t n
 {
     const struct list_iter *current = it;
     struct list *l;
+    ssize_t distance = n;
 
     if (!it) {
         errno = EFAULT;
         return NULL;
     }
 
-    l = it->node.list;
+    l = list_inline_owner(&it->node);
     if (!l) {
         // Iterator not linked.
         errno = EINVAL;
         return NULL;
     }
 
+    if (l->index && list_index_current(l) && (n > LIST_INDEX_ADVANCE_MIN || n < -LIST_INDEX_ADVANCE_MIN)) {
+        // Jump by position rather than walking.
+        size_t pos = (size_t)list_index_of(it);
+        // Negate in size_t, since -n overflows for the most negative @c n.
+        size_t magnitude = n > 0 ? (size_t)n : (size_t)0 - (size_t)n;
+
+        if (n > 0 ? magnitude > l->size - pos : magnitude > pos) {
+            errno = ERANGE;
+            return NULL;
+        }
+
+        LIST_STATS_ADVANCE(l, n, false);
+        return list_nth(l, n > 0 ? pos + magnitude : pos - magnitude);
+    }
+
     while (n > 0) {
         if (current == list_cend(l)) {
             errno = ERANGE;
@@ -228,6 +290,7 @@ const struct list_iter *list_advance_const(const struct list_iter *it, ssize_t n
         n++;
     }
 
+    LIST_STATS_ADVANCE(l, distance, true);
     return current;
 }
 
@@ -268,117 +331,167 @@ const struct list_iter *list_element_const(const void *element, size_t offset)
     return (const struct list_iter *)node;
 }
 
+/// Variant of @c list_insert that does not count an insert.
+static struct list_iter *impl_insert(struct list_iter *it, void *element)
+{
+    struct list *l = it ? list_inline_owner(&it->node) : NULL;
+    bool indexed = l && l->index && list_index_prepare(l);
+    bool ordered = l && l->order && list_order_prepare(l);
+    struct list_iter *inserted;
+
+    inserted = list_inline_insert(it, element);
+    if (inserted && indexed) {
+        list_index_linked(l, &inserted->node);
+    }
+    if (inserted && ordered) {
+        list_order_linked(l, &inserted->node);
+    }
+    if (inserted) {
+        LIST_STATS_GREW(l);
+    }
+
+    return inserted;
+}
+
 struct list_iter *list_insert(struct list_iter *it, void *element)
 {
-    struct list *l;
-    struct list_node *link;
-    struct list_node *rhs;
-    struct list_node *lhs;
+    struct list_iter *inserted = impl_insert(it, element);
 
-    if (!it) {
-        errno = EFAULT;
-        return NULL;
+    if (inserted) {
+        LIST_STATS_ADD(it->node.list, inserts, 1);
     }
 
-    if (!element) {
+    return inserted;
+}
+
+struct list_iter *list_push_front(struct list *l, void *element)
+{
+    return list_insert(list_begin(l), element);
+}
+
+struct list_iter *list_push_back(struct list *l, void *element)
+{
+    return list_insert(list_end(l), element);
+}
+
+struct list_iter *list_insert_n(struct list_iter *it, void **elements, size_t n)
+{
+    struct list *l;
+    struct list_node *lhs;
+    struct list_node *rhs;
+    struct list_node *head = NULL;
+    struct list_node *tail = NULL;
+
+    if (!it || !elements) {
         errno = EFAULT;
         return NULL;
     }
 
-    l = it->node.list;
+    l = list_inline_owner(&it->node);
     if (!l) {
         // Iterator not linked.
         errno = EINVAL;
         return NULL;
     }
 
-    if (l->size == SIZE_MAX) {
+    if (n == 0) {
+        return it;
+    }
+
+    if (l->size > SIZE_MAX - n) {
         // Detect pathological overflow case.
         errno = EOVERFLOW;
         return NULL;
     }
 
-    ///     +-------+    +--------+    +-------+
-    /// --->|       |-4->|    next|-1->|       |--->
-    ///     |  lhs  |    |  link  |    |  rhs  |
-    /// <---|       |<-2-|prev    |<-3-|       |<---
-    ///     +-------+    +--------+    +-------+
-
-    link = (struct list_node *)list_element(element, l->offset);
-    if (!link) {
-        errno = EINVAL;
-        return NULL;
+    // Check every element before writing to any, so that failure leaves them all untouched.
+    for (size_t i = 0; i < n; i++) {
+        if (!elements[i]) {
+            errno = EFAULT;
+            return NULL;
+        }
     }
 
     rhs = &it->node;
     lhs = rhs->prev;
 
-    link->next = rhs;  // 1
-    link->prev = lhs;  // 2
-    link->list = l;
+    // Link the elements to each other; the list itself is not touched yet.
+    for (size_t i = 0; i < n; i++) {
+        struct list_node *link;
+
+        link = (struct list_node *)((char *)elements[i] + l->offset);
+        link->prev = tail ? tail : lhs;
+        link->list = l;
+        if (tail) {
+            tail->next = link;
+        } else {
+            head = link;
+        }
+        tail = link;
+    }
 
-    rhs->prev = link;  // 3
-    lhs->next = link;  // 4
+    ///     +-------+    +------+         +------+    +-------+
+    /// --->|       |-3->|  head|-->...-->|  tail|-1->|       |--->
+    ///     |  lhs  |    |      |         |      |    |  rhs  |
+    /// <---|       |<---|      |<--...<--|      |<-2-|       |<---
+    ///     +-------+    +------+         +------+    +-------+
 
-    l->size++;
+    tail->next = rhs; // 1
+    rhs->prev = tail; // 2
+    lhs->next = head; // 3
 
-    return (struct list_iter *)link;
-}
+    l->size += n;
+    l->generation++;
+    LIST_STATS_ADD(l, inserts, n);
+    LIST_STATS_GREW(l);
 
-struct list_iter *list_push_front(struct list *l, void *element)
-{
-    return list_insert(list_begin(l), element);
+    return (struct list_iter *)head;
 }
 
-struct list_iter *list_push_back(struct list *l, void *element)
+struct list_iter *list_push_back_n(struct list *l, void **elements, size_t n)
 {
-    return list_insert(list_end(l), element);
+    return list_insert_n(list_end(l), elements, n);
 }
 
 /// @return Unlinked element for given iterator.
 static void *impl_unlink(struct list_iter *it)
 {
+    struct list *l = it ? list_inline_owner(&it->node) : NULL;
+    bool indexed = l && l->index && list_index_prepare(l);
+    bool ordered = l && l->order && list_order_prepare(l);
     void *element;
-    struct list_node *source;
 
-    element = list_at(it);
-    if (!element) {
-        return NULL;
+    element = list_inline_unlink(it);
+    if (element && indexed) {
+        list_index_unlinked(l, &it->node);
+    }
+    if (element && ordered) {
+        list_order_unlinked(l, &it->node);
     }
 
-    ///     +-------+                    +-------+
-    ///     |       |-1----------------->|       |
-    ///     |       |     +--------+     |       |
-    /// --->|       |     |    next|-3-X |       |--->
-    ///     |  lhs  |     | source |     |  rhs  |
-    /// <---|       | X-4-|prev    |     |       |<---
-    ///     |       |     +--------+     |       |
-    ///     |       |<-----------------2-|       |
-    ///     +-------+                    +-------+
-
-    source = &it->node;
+    return element;
+}
 
-    // Unlink from current position.
-    source->prev->next = source->next; // 1
-    source->next->prev = source->prev; // 2
-    source->list->size--;
+/// @return Unlinked element for given iterator of @c l, counted as a pop.
+static void *impl_pop(struct list *l, struct list_iter *it)
+{
+    void *element = impl_unlink(it);
 
-    // Mark node as unlinked.
-    source->next = NULL; // 3
-    source->prev = NULL; // 4
-    source->list = NULL;
+    if (element) {
+        LIST_STATS_ADD(l, pops, 1);
+    }
 
     return element;
 }
 
 void *list_pop_front(struct list *l)
 {
-    return impl_unlink(list_begin(l));
+    return impl_pop(l, list_begin(l));
 }
 
 void *list_pop_back(struct list *l)
 {
-    return impl_unlink(list_prev(list_end(l)));
+    return impl_pop(l, list_prev(list_end(l)));
 }
 
 void *list_at(struct list_iter *it)
@@ -392,43 +505,21 @@ void *list_at(struct list_iter *it)
 #pragma GCC diagnostic pop
 }
 
-static const void *impl_element_of(const struct list *l, const struct list_iter *it)
-{
-    return (const void *)((const char *)it - l->offset);
-}
-
 const void *list_at_const(const struct list_iter *it)
 {
-    const struct list *l;
-
-    if (!it) {
-        errno = EFAULT;
-        return NULL;
-    }
-
-    l = it->node.list;
-    if (!l) {
-        // Iterator not linked.
-        errno = EINVAL;
-        return NULL;
-    }
-
-    if (it == list_cend(l)) {
-        errno = ENOENT;
-        return NULL;
-    }
-
-    return impl_element_of(l, it);
+    return list_inline_at_const(it);
 }
 
 int list_erase(struct list_iter *it, void (*destructor)(void *))
 {
+    struct list *l = it ? list_inline_owner(&it->node) : NULL;
     void *element;
 
     element = impl_unlink(it);
     if (!element) {
         return -errno;
     }
+    LIST_STATS_ADD(l, erases, 1);
 
     if (destructor) {
         destructor(element);
@@ -437,6 +528,54 @@ int list_erase(struct list_iter *it, void (*destructor)(void *))
     return 0;
 }
 
+static int impl_erase_range_checked(struct list_iter *first, struct list_iter *last,
+                                    void (*destructor)(void *), void (*batch)(void **, size_t))
+{
+    struct list *l;
+    size_t n = 0;
+
+    if (!first || !last) {
+        return -EFAULT;
+    }
+
+    l = list_inline_owner(&first->node);
+    if (!l || list_inline_owner(&last->node) != l) {
+        // Iterator not linked, or range not within one list.
+        return -EINVAL;
+    }
+
+    if (first == last) {
+        // Empty range.
+        return 0;
+    }
+
+    if (first == list_end(l)) {
+        // Erasing list_end() does not make sense.
+        return -ENOENT;
+    }
+
+    // Count the range, and verify that @c last follows @c first.
+    for (struct list_node *node = &first->node; node != &last->node; node = node->next) {
+        if (node == &l->sentinel) {
+            return -EINVAL;
+        }
+        n++;
+    }
+
+    impl_erase_range(l, &first->node, &last->node, n, destructor, batch);
+    return 0;
+}
+
+int list_erase_range(struct list_iter *first, struct list_iter *last, void (*destructor)(void *))
+{
+    return impl_erase_range_checked(first, last, destructor, NULL);
+}
+
+int list_erase_range_batch(struct list_iter *first, struct list_iter *last, void (*destructor)(void **, size_t))
+{
+    return impl_erase_range_checked(first, last, NULL, destructor);
+}
+
 int list_splice(struct list_iter *it, struct list_iter *source_iter)
 {
     struct list_node *target;
@@ -465,7 +604,7 @@ int list_splice(struct list_iter *it, struct list_iter *source_iter)
 
     target = &it->node;
 
-    if (!target->list || !source->list) {
+    if (!list_inline_owner(target) || !list_inline_owner(source)) {
         // Iterator not linked.
         return -EINVAL;
     }
@@ -479,7 +618,535 @@ int list_splice(struct list_iter *it, struct list_iter *source_iter)
     element = impl_unlink(source_iter);
 
     // Insert source before target.
-    list_insert(it, element);
+    impl_insert(it, element);
+    LIST_STATS_ADD(target->list, splices, 1);
+
+    return 0;
+}
+
+/// Set list ownership of the nodes in the range [@c first, @c last).
+static void impl_adopt(struct list_node *first, struct list_node *last, struct list *l)
+{
+    for (struct list_node *node = first; node != last; node = node->next) {
+        node->list = l;
+    }
+}
+
+int list_splice_range(struct list_iter *it, struct list_iter *first, struct list_iter *last)
+{
+    struct list *target;
+    struct list *source;
+    struct list_node *head;
+    struct list_node *tail;
+    bool indexed;
+    bool ordered;
+
+    if (!it || !first || !last) {
+        return -EFAULT;
+    }
+
+    target = list_inline_owner(&it->node);
+    source = list_inline_owner(&first->node);
+
+    if (!target || !source) {
+        // Iterator not linked.
+        return -EINVAL;
+    }
+
+    if (list_inline_owner(&last->node) != source) {
+        // Range must be within one list.
+        return -EINVAL;
+    }
+
+    if (target->offset != source->offset) {
+        // Elements must embed LIST_NODE at the same offset.
+        return -EINVAL;
+    }
+
+    if (first == last) {
+        // Empty range.
+        return 0;
+    }
+
+    if (first == list_end(source)) {
+        // Disallow list_end() as source.
+        return -ENOENT;
+    }
+
+    if (it == first) {
+        // Disallow inserting before itself.
+        return -EINVAL;
+    }
+
+    if (it == last) {
+        // Range is already positioned before @c it.
+        return 0;
+    }
+
+    head = &first->node;
+
+    if (target != source) {
+        struct list_node *node;
+        size_t n = 0;
+
+        // Transfer ownership, and verify that @c last follows @c first.
+        for (node = head; node != &last->node; node = node->next) {
+            if (node == &source->sentinel) {
+                impl_adopt(head, node, source);
+                return -EINVAL;
+            }
+
+            node->list = target;
+            n++;
+        }
+
+        if (target->size > SIZE_MAX - n) {
+            // Detect pathological overflow case.
+            impl_adopt(head, node, source);
+            return -EOVERFLOW;
+        }
+
+        source->size -= n;
+        target->size += n;
+        source->generation++;
+    }
+
+    indexed = target == source && target->index && list_index_prepare(target);
+    ordered = target == source && target->order && list_order_prepare(target);
+    tail = last->node.prev;
+
+    // Unlink [head, tail] by joining its neighbours.
+    head->prev->next = &last->node;
+    last->node.prev = head->prev;
+
+    // Link [head, tail] before @c it.
+    head->prev = it->node.prev;
+    tail->next = &it->node;
+    it->node.prev->next = head;
+    it->node.prev = tail;
+
+    target->generation++;
+    LIST_STATS_ADD(target, splices, 1);
+    LIST_STATS_GREW(target);
+    if (indexed) {
+        list_index_moved(target, head, tail);
+    }
+    if (ordered) {
+        list_order_moved(target, head, tail);
+    }
+
+    return 0;
+}
+
+int list_concat(struct list *l, struct list *source)
+{
+    if (!l || !source) {
+        return -EFAULT;
+    }
+
+    if (l == source) {
+        return -EINVAL;
+    }
+
+    return list_splice_range(list_end(l), list_begin(source), list_end(source));
+}
+
+struct list *list_split(struct list *l, struct list_iter *it)
+{
+    struct list *split;
+    int r;
+
+    if (!l || !it) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    if (list_inline_owner(&it->node) != l) {
+        // Iterator not linked to @c l.
+        errno = EINVAL;
+        return NULL;
+    }
+
+    split = list_new(l->offset);
+    if (!split) {
+        return NULL;
+    }
+
+    r = list_splice_range(list_end(split), it, list_end(l));
+    if (r < 0) {
+        list_delete(split, NULL); // UNREACHABLE
+        errno = -r;               // UNREACHABLE
+        return NULL;              // UNREACHABLE
+    }
+
+    return split;
+}
+
+/// @return Element containing @c node.
+static void *impl_element(const struct list *l, struct list_node *node)
+{
+    return (char *)node - l->offset;
+}
+
+/// Merge two sorted NULL-terminated chains linked via @c next.
+/// On equality nodes of @c a precede nodes of @c b.
+/// @return Head of merged chain.
+static struct list_node *impl_merge_chains(const struct list *l, struct list_node *a, struct list_node *b,
+                                           int (*cmp)(const void *, const void *))
+{
+    struct list_node head;
+    struct list_node *tail = &head;
+
+    while (a && b) {
+        if (cmp(impl_element(l, b), impl_element(l, a)) < 0) {
+            tail->next = b;
+            b = b->next;
+        } else {
+            tail->next = a;
+            a = a->next;
+        }
+        tail = tail->next;
+    }
+
+    tail->next = a ? a : b;
+    return head.next;
+}
+
+int list_sort(struct list *l, int (*cmp)(const void *, const void *))
+{
+    /// Pending sorted runs; bins[i] is empty or holds 2^i nodes.
+    /// Nodes in higher bins precede nodes in lower bins.
+    struct list_node *bins[sizeof(size_t) * 8];
+    struct list_node *node;
+    struct list_node *prev;
+    size_t top = 0;
+
+    if (!l || !cmp) {
+        return -EFAULT;
+    }
+
+    if (l->size < 2) {
+        return 0;
+    }
+
+    // Break the circle, and use @c next as a NULL-terminated chain.
+    l->sentinel.prev->next = NULL;
+    node = l->sentinel.next;
+
+    while (node) {
+        struct list_node *carry = node;
+        size_t i;
+
+        node = node->next;
+        carry->next = NULL;
+
+        for (i = 0; i < top && bins[i]; i++) {
+            carry = impl_merge_chains(l, bins[i], carry, cmp);
+            bins[i] = NULL;
+        }
+
+        if (i == top) {
+            top++;
+        }
+        bins[i] = carry;
+    }
+
+    node = NULL;
+    for (size_t i = 0; i < top; i++) {
+        if (bins[i]) {
+            node = impl_merge_chains(l, bins[i], node, cmp);
+        }
+    }
+
+    // Restore @c prev links and the circle.
+    prev = &l->sentinel;
+    prev->next = node;
+    for (; node; prev = node, node = node->next) {
+        node->prev = prev;
+    }
+    prev->next = &l->sentinel;
+    l->sentinel.prev = prev;
+    l->generation++;
 
     return 0;
 }
+
+int list_merge(struct list *l, struct list *source, int (*cmp)(const void *, const void *))
+{
+    struct list_node *pos;
+    struct list_node *node;
+
+    if (!l || !source || !cmp) {
+        return -EFAULT;
+    }
+
+    if (l == source || l->offset != source->offset) {
+        return -EINVAL;
+    }
+
+    if (l->size > SIZE_MAX - source->size) {
+        // Detect pathological overflow case.
+        return -EOVERFLOW;
+    }
+
+    pos = l->sentinel.next;
+    node = source->sentinel.next;
+
+    while (node != &source->sentinel) {
+        struct list_node *next = node->next;
+
+        // Skip elements that do not exceed @c node, to keep the merge stable.
+        while (pos != &l->sentinel && cmp(impl_element(l, node), impl_element(l, pos)) >= 0) {
+            pos = pos->next;
+        }
+
+        // Link before @c pos.
+        node->list = l;
+        node->prev = pos->prev;
+        node->next = pos;
+        pos->prev->next = node;
+        pos->prev = node;
+
+        node = next;
+    }
+
+    l->size += source->size;
+
+    source->sentinel.next = &source->sentinel;
+    source->sentinel.prev = &source->sentinel;
+    source->size = 0;
+    source->generation++;
+    l->generation++;
+    LIST_STATS_ADD(l, splices, 1);
+    LIST_STATS_GREW(l);
+
+    return 0;
+}
+
+/// @return The node before which @c element belongs, searching outward from @c start.
+static struct list_node *impl_sorted_position(const struct list *l, struct list_node *start, const void *element,
+                                              int (*cmp)(const void *, const void *))
+{
+    struct list_node *node = start;
+
+    if (node != &l->sentinel && cmp(impl_element(l, node), element) <= 0) {
+        // Forward past elements that do not exceed @c element, to keep the insertion stable.
+        do {
+            node = node->next;
+        } while (node != &l->sentinel && cmp(impl_element(l, node), element) <= 0);
+
+        return node;
+    }
+
+    // Backward past elements that exceed @c element.
+    while (node->prev != &l->sentinel && cmp(impl_element(l, node->prev), element) > 0) {
+        node = node->prev;
+    }
+
+    return node;
+}
+
+/// @return The cached finger if the list has not changed since it was set, otherwise @c list_end.
+static struct list_node *impl_finger(struct list *l)
+{
+    if (l->finger && l->finger_generation == l->generation) {
+        return l->finger;
+    }
+
+    return &l->sentinel;
+}
+
+struct list_iter *list_insert_sorted(struct list *l, void *element, int (*cmp)(const void *, const void *),
+                                     struct list_iter *hint)
+{
+    struct list_node *pos;
+    struct list_iter *inserted;
+
+    if (!l || !element || !cmp) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    if (hint && list_inline_owner(&hint->node) != l) {
+        // Hint not linked, or in another list.
+        errno = EINVAL;
+        return NULL;
+    }
+
+    pos = impl_sorted_position(l, hint ? &hint->node : impl_finger(l), element, cmp);
+
+    inserted = list_insert((struct list_iter *)pos, element);
+    if (inserted) {
+        l->finger = &inserted->node;
+        l->finger_generation = l->generation;
+    }
+
+    return inserted;
+}
+
+struct list_iter *list_insert_sorted_n(struct list *l, void **elements, size_t n,
+                                       int (*cmp)(const void *, const void *))
+{
+    struct list_node *pos;
+    struct list_node *link = NULL;
+
+    if (!l || !elements || !cmp) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    if (n == 0) {
+        return list_end(l);
+    }
+
+    if (l->size > SIZE_MAX - n) {
+        // Detect pathological overflow case.
+        errno = EOVERFLOW;
+        return NULL;
+    }
+
+    // Validate the whole batch first, so that failure leaves the list unchanged.
+    for (size_t i = 0; i < n; i++) {
+        if (!elements[i]) {
+            errno = EFAULT;
+            return NULL;
+        }
+
+        if (i > 0 && cmp(elements[i - 1], elements[i]) > 0) {
+            errno = EINVAL;
+            return NULL;
+        }
+    }
+
+    pos = impl_sorted_position(l, impl_finger(l), elements[0], cmp);
+
+    for (size_t i = 0; i < n; i++) {
+        // Skip elements that do not exceed this one, to keep the merge stable.
+        while (pos != &l->sentinel && cmp(impl_element(l, pos), elements[i]) <= 0) {
+            pos = pos->next;
+        }
+
+        // Link before @c pos.
+        link = (struct list_node *)((char *)elements[i] + l->offset);
+        link->list = l;
+        link->prev = pos->prev;
+        link->next = pos;
+        pos->prev->next = link;
+        pos->prev = link;
+    }
+
+    l->size += n;
+    l->generation++;
+    LIST_STATS_ADD(l, inserts, n);
+    LIST_STATS_GREW(l);
+    l->finger = link;
+    l->finger_generation = l->generation;
+
+    return (struct list_iter *)((char *)elements[0] + l->offset);
+}
+
+/// Prefetch @c node, and optionally the element payload at @c payload.
+static void impl_prefetch(const struct list *l, struct list_node *node, size_t payload)
+{
+    LLIST_PREFETCH(node);
+    // The sentinel has no element around it, so there is no payload to compute an address for.
+    if (payload != LIST_PREFETCH_NO_PAYLOAD && node != &l->sentinel) {
+        LLIST_PREFETCH((char *)impl_element(l, node) + payload);
+    }
+}
+
+/// Visit elements with a lead cursor running @c distance nodes ahead of the visited node.
+/// The lead cursor issues the prefetches; the trailing cursor then finds its nodes in cache.
+static int impl_for_each(struct list *l, int (*fn)(void *, void *), void *ctx, size_t distance, size_t payload,
+                         bool reverse)
+{
+    struct list_node *sentinel;
+    struct list_node *lead;
+    struct list_node *node;
+
+    if (!l || !fn) {
+        return -EFAULT;
+    }
+
+    sentinel = &l->sentinel;
+    node = reverse ? sentinel->prev : sentinel->next;
+    lead = node;
+
+    for (size_t i = 0; i < distance && lead != sentinel; i++) {
+        lead = reverse ? lead->prev : lead->next;
+        impl_prefetch(l, lead, payload);
+    }
+
+    while (node != sentinel) {
+        struct list_node *next = reverse ? node->prev : node->next;
+        int r;
+
+        if (distance && lead != sentinel) {
+            lead = reverse ? lead->prev : lead->next;
+            impl_prefetch(l, lead, payload);
+        }
+
+        r = fn(impl_element(l, node), ctx);
+        if (r != 0) {
+            return r;
+        }
+
+        node = next;
+    }
+
+    return 0;
+}
+
+int list_for_each(struct list *l, int (*fn)(void *, void *), void *ctx)
+{
+    return impl_for_each(l, fn, ctx, LIST_PREFETCH_DISTANCE, LIST_PREFETCH_NO_PAYLOAD, false);
+}
+
+int list_for_each_reverse(struct list *l, int (*fn)(void *, void *), void *ctx)
+{
+    return impl_for_each(l, fn, ctx, LIST_PREFETCH_DISTANCE, LIST_PREFETCH_NO_PAYLOAD, true);
+}
+
+int list_for_each_prefetch(struct list *l, int (*fn)(void *, void *), void *ctx, size_t distance, size_t payload)
+{
+    return impl_for_each(l, fn, ctx, distance, payload, false);
+}
+
+int list_for_each_reverse_prefetch(struct list *l, int (*fn)(void *, void *), void *ctx, size_t distance,
+                                   size_t payload)
+{
+    return impl_for_each(l, fn, ctx, distance, payload, true);
+}
+
+int list_stats_get(const struct list *l, struct list_stats *out)
+{
+    if (!l || !out) {
+        return -EFAULT;
+    }
+
+#ifdef LLIST_STATS
+    *out = l->stats;
+    return 0;
+#else
+    return -ENOTSUP;
+#endif
+}
+
+int list_stats_reset(struct list *l)
+{
+    if (!l) {
+        return -EFAULT;
+    }
+
+#ifdef LLIST_STATS
+    {
+        const struct list_stats zero = { 0 };
+
+        l->stats = zero;
+        l->stats.high_water = l->size;
+    }
+    return 0;
+#else
+    return -ENOTSUP;
+#endif
+}
@@ -86,8 +86,17 @@ size_t list_size(const struct list *) PUBLIC;
 /// @return Zero on success, negative errno otherwise.
 ///   - EFAULT: NULL pointer argument.
 /// @note Invalidates all iterators.
+/// @note Complexity: O(n), in a single pass over the elements.
 int list_clear(struct list *, void (*destructor)(void *)) PUBLIC;
 
+/// Maximum number of elements passed to a batch destructor per call.
+#define LIST_ERASE_BATCH 64
+
+/// Erases all elements from the container, passing them to @c destructor in batches.
+/// @param destructor Function called with successive arrays of up to @c LIST_ERASE_BATCH elements, or NULL.
+/// @see list_clear.
+int list_clear_batch(struct list *, void (*destructor)(void **elements, size_t n)) PUBLIC;
+
 /// Iterator object.
 /// @note Memory ownership: Owned by the object; valid until list_clear(), list_erase() (of that specific iterator),
 ///       or list_delete(). NOT invalidated by insertions, splice, or erasure of other elements.
@@ -146,7 +155,8 @@ const struct list_iter *list_cprev(const struct list_iter *) PUBLIC;
 ///   - EFAULT: NULL pointer argument.
 ///   - EINVAL: Iterator invalid.
 ///   - ERANGE: Offset out of range.
-/// @note Complexity: O(n).
+/// @note Complexity: O(n), or O(log n) with a positional index.
+/// @see list_index_enable.
 struct list_iter *list_advance(struct list_iter *, ssize_t n) PUBLIC;
 
 /// Constant variant of @c list_advance.
@@ -187,6 +197,58 @@ struct list_iter *list_push_front(struct list *, void *element) PUBLIC;
 /// @see list_insert.
 struct list_iter *list_push_back(struct list *, void *element) PUBLIC;
 
+/// Insert @c n elements before iterator, in array order.
+/// The elements are linked to each other first, then attached to the list with one update of each neighbour and of
+/// the list size.
+/// @return Pointer to iterator of the first inserted element on success; @c iter itself if @c n is zero.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument, or NULL element; checked before any element is linked, so the list and all
+///     elements are unchanged.
+///   - EINVAL: Iterator invalid.
+///   - EOVERFLOW: List cannot grow by @c n.
+/// @warning The elements must be distinct, and not already inserted to a list.
+/// @note Does not invalidate existing iterators.
+/// @note Memory ownership: On success the object takes ownership of the elements.
+/// @note Complexity: O(n).
+/// @see list_insert.
+struct list_iter *list_insert_n(struct list_iter *iter, void **elements, size_t n) PUBLIC;
+
+/// Insert @c n elements at end of list, in array order.
+/// @see list_insert_n.
+struct list_iter *list_push_back_n(struct list *, void **elements, size_t n) PUBLIC;
+
+/// Insert @c element into sorted list, after any equal elements.
+/// The position is searched for outward from @c hint, in whichever direction @c cmp indicates. Without a hint, the
+/// search starts from the element most recently inserted by @c list_insert_sorted or @c list_insert_sorted_n, if the
+/// list has not changed otherwise since; or else from the end of the list.
+/// @param cmp Comparison function, as for @c list_sort.
+/// @param hint Iterator near the expected position, or NULL.
+/// @return Pointer to iterator of the inserted element on success.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Hint not in this list.
+///   - EOVERFLOW: List cannot grow.
+/// @warning The list must be sorted by @c cmp, and the element must not be already inserted to a list.
+/// @note Does not invalidate existing iterators.
+/// @note Complexity: O(d) for d elements between the starting point and the position; O(1) for near-sequential
+///       insertion.
+struct list_iter *list_insert_sorted(struct list *, void *element, int (*cmp)(const void *, const void *),
+                                     struct list_iter *hint) PUBLIC;
+
+/// Insert @c n elements, sorted by @c cmp, into sorted list.
+/// The position of the first element is searched for as by @c list_insert_sorted without a hint; the others are merged
+/// in during one forward pass from there. Equal elements keep their relative order, after those already in the list.
+/// @return Pointer to iterator of the first inserted element on success; @c list_end if @c n is zero.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument, or NULL element; the list is unchanged.
+///   - EINVAL: Elements not sorted; the list is unchanged.
+///   - EOVERFLOW: List cannot grow by @c n.
+/// @warning The list must be sorted by @c cmp, and the elements must be distinct and not already inserted to a list.
+/// @note Does not invalidate existing iterators.
+/// @note Complexity: O(n + d) for d elements between the starting point and the last inserted position.
+struct list_iter *list_insert_sorted_n(struct list *, void **elements, size_t n,
+                                       int (*cmp)(const void *, const void *)) PUBLIC;
+
 /// Unlink and return the first element of the list.
 /// @return Pointer to element on success.
 /// @return NULL on failure, and errno is set to:
@@ -222,6 +284,21 @@ const void *list_at_const(const struct list_iter *) PUBLIC;
 /// @note Memory ownership: On success if @c destructor is NULL then the caller regains ownership.
 int list_erase(struct list_iter *, void (*destructor)(void *)) PUBLIC;
 
+/// Remove elements in the range [@c first, @c last) from the list, calling @c destructor for each.
+/// The range is counted and detached, then destroyed in a single pass; destructors already see the list without it.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Iterator invalid, iterators belong to different list instances, or @c last does not follow @c first.
+///   - ENOENT: Iterator @c list_end cannot be erased.
+/// @note Invalidates iterators pointing to removed nodes.
+/// @note Complexity: O(k) for k erased elements, in two passes: one to count and validate the range, one to destroy it.
+/// @note Memory ownership: On success if @c destructor is NULL then the caller regains ownership.
+int list_erase_range(struct list_iter *first, struct list_iter *last, void (*destructor)(void *)) PUBLIC;
+
+/// Batch variant of @c list_erase_range.
+/// @see list_clear_batch.
+int list_erase_range_batch(struct list_iter *first, struct list_iter *last, void (*destructor)(void **elements, size_t n)) PUBLIC;
+
 /// Move single element @c source_iter to before @c iter.
 /// The splice operation moves elements without changing size.
 /// @return Zero on success, negative errno otherwise.
@@ -233,4 +310,212 @@ int list_erase(struct list_iter *, void (*destructor)(void *)) PUBLIC;
 /// @note If @c source_iter is already positioned immediately before @c iter, then no change is made and function returns successfully.
 int list_splice(struct list_iter *iter, struct list_iter *source_iter) PUBLIC;
 
+/// Move elements in the range [@c first, @c last) to before @c iter.
+/// The range may belong to a different list instance than @c iter.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Iterator invalid, @c first and @c last belong to different list instances, @c last does not follow
+///             @c first, @c iter equals @c first, or the lists use different offsets.
+///   - ENOENT: Iterator @c list_end cannot be moved.
+///   - EOVERFLOW: Destination list cannot grow.
+/// @warning Within a single list, @c iter must not lie inside [@c first, @c last) and @c last must follow @c first;
+///          these preconditions are not checked.
+/// @note Does not invalidate existing iterators.
+/// @note Complexity: O(1) within a single list.
+///       Between lists the links are still updated in O(1), but the moved nodes are visited once in order to update
+///       their list ownership and the sizes of both lists: O(k) for k moved elements.
+int list_splice_range(struct list_iter *iter, struct list_iter *first, struct list_iter *last) PUBLIC;
+
+/// Move all elements of @c source to the end of @c list.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Lists are the same instance, or use different offsets.
+///   - EOVERFLOW: Destination list cannot grow.
+/// @note Does not invalidate existing iterators.
+/// @note Complexity: O(k) for k moved elements.
+/// @see list_splice_range.
+int list_concat(struct list *list, struct list *source) PUBLIC;
+
+/// Split list before @c iter.
+/// Elements in the range [@c iter, list_end) are moved to a new list.
+/// @return Pointer to new list on success.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Iterator invalid or does not belong to @c list.
+///   - ENOMEM: Insufficient memory.
+/// @note Does not invalidate existing iterators.
+/// @note Complexity: O(k) for k moved elements.
+/// @note Memory ownership: Caller must list_delete() the returned pointer.
+struct list *list_split(struct list *list, struct list_iter *iter) PUBLIC;
+
+/// Sort elements.
+/// Stable bottom-up merge sort that relinks the embedded nodes in place.
+/// @param cmp Comparison function returning less than, equal to, or greater than zero if the first element is
+///            respectively less than, equal to, or greater than the second.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+/// @note Does not allocate memory.
+/// @note Does not invalidate existing iterators; they continue to reference the same elements.
+/// @note Complexity: O(n log n).
+int list_sort(struct list *, int (*cmp)(const void *, const void *)) PUBLIC;
+
+/// Merge sorted @c source into sorted @c list.
+/// The merge is stable: on equality, elements of @c list precede elements of @c source.
+/// @c source is left empty.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Lists are the same instance, or use different offsets.
+///   - EOVERFLOW: Destination list cannot grow.
+/// @note Does not allocate memory.
+/// @note Does not invalidate existing iterators; they continue to reference the same elements.
+/// @note Complexity: O(n + m).
+int list_merge(struct list *list, struct list *source, int (*cmp)(const void *, const void *)) PUBLIC;
+
+/// Attach a positional index to the list.
+/// The index makes @c list_nth, @c list_index_of and long @c list_advance jumps O(log n).
+/// It is kept up to date in O(log n) by @c list_insert, @c list_push_front, @c list_push_back, @c list_pop_front,
+/// @c list_pop_back, @c list_erase, @c list_splice, and @c list_splice_range within one list.
+/// Other changes (batch insert, sorted batch insert, range erase, clear, cross-list splice, sort, merge, and the inline
+/// fast paths) leave it out of date. Positional queries then walk the list, and never modify it; the index is rebuilt
+/// in O(n) by the next change listed above, or by @c list_index_refresh.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - ENOMEM: Insufficient memory.
+/// @note The index costs about 80 bytes per element, and is released by @c list_index_disable or @c list_delete.
+/// @note Enabling an already indexed list does nothing.
+int list_index_enable(struct list *) PUBLIC;
+
+/// Rebuild the positional index in O(n) if it is out of date.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: List has no positional index.
+///   - ENOMEM: Insufficient memory; the index stays out of date.
+int list_index_refresh(struct list *) PUBLIC;
+
+/// Detach and release the positional index.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+int list_index_disable(struct list *) PUBLIC;
+
+/// Get iterator to the element at position @c n.
+/// @return Pointer to iterator on success; @c list_end if @c n equals the list size.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+///   - ERANGE: @c n exceeds the list size.
+/// @note Complexity: O(log n) with a positional index, O(n) otherwise.
+struct list_iter *list_nth(struct list *, size_t n) PUBLIC;
+
+/// Get the position of an iterator.
+/// @return Position on success; the list size for @c list_end.
+/// @return Negative errno on failure:
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Iterator not linked.
+/// @note Complexity: O(log n) with a positional index, O(n) otherwise.
+ssize_t list_index_of(const struct list_iter *) PUBLIC;
+
+/// Attach order-maintenance labels to the list.
+/// Each node is given an integer label that increases along the list, so that @c list_precedes is O(1).
+/// Labels are kept up to date by @c list_insert, @c list_push_front, @c list_push_back, @c list_pop_front,
+/// @c list_pop_back, @c list_erase, @c list_splice, and @c list_splice_range within one list, relabelling a
+/// neighbourhood of the change when labels run out (amortised O(log n)).
+/// Other changes leave the labels out of date. @c list_precedes then walks the list, and never modifies it; the labels
+/// are rebuilt in O(n) by the next change listed above, or by @c list_order_refresh.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - ENOMEM: Insufficient memory.
+/// @note Labels are stored beside the list, 32 to 64 bytes per element; @c LIST_NODE is unchanged.
+/// @note Enabling an already labelled list does nothing.
+int list_order_enable(struct list *) PUBLIC;
+
+/// Detach and release the order-maintenance labels.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+int list_order_disable(struct list *) PUBLIC;
+
+/// Relabel the list in O(n) if its labels are out of date.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: List has no order-maintenance labels.
+///   - ENOMEM: Insufficient memory; the labels stay out of date.
+int list_order_refresh(struct list *) PUBLIC;
+
+/// Test whether @c a comes before @c b.
+/// @return True if both iterators belong to the same list and @c a precedes @c b; @c list_end follows all elements.
+/// @return False otherwise, including for invalid arguments.
+/// @note Complexity: O(1) with order-maintenance labels, O(n) otherwise.
+bool list_precedes(const struct list_iter *a, const struct list_iter *b) PUBLIC;
+
+/// Default number of nodes that @c list_for_each prefetches ahead of the visited node.
+#define LIST_PREFETCH_DISTANCE 8
+
+/// Payload offset that disables payload prefetch in @c list_for_each_prefetch.
+#define LIST_PREFETCH_NO_PAYLOAD ((size_t)-1)
+
+/// Call @c fn for each element, from first to last.
+/// Prefetches @c LIST_PREFETCH_DISTANCE nodes ahead, so that node cache misses overlap with the work done by @c fn.
+/// @param fn Function called with each element and @c ctx; a non-zero return value stops the traversal.
+/// @return Zero on success, or the first non-zero value returned by @c fn.
+/// @return Negative errno on failure:
+///   - EFAULT: NULL pointer argument.
+/// @note @c fn may erase the element it is given, but must not otherwise modify the list.
+/// @note Complexity: O(n).
+int list_for_each(struct list *, int (*fn)(void *element, void *ctx), void *ctx) PUBLIC;
+
+/// Variant of @c list_for_each that visits elements from last to first.
+int list_for_each_reverse(struct list *, int (*fn)(void *element, void *ctx), void *ctx) PUBLIC;
+
+/// Variant of @c list_for_each with explicit prefetch control.
+/// @param distance Number of nodes to prefetch ahead, or zero to disable prefetch.
+/// @param payload Offset within each element to prefetch along with the node, or @c LIST_PREFETCH_NO_PAYLOAD.
+int list_for_each_prefetch(struct list *, int (*fn)(void *element, void *ctx), void *ctx,
+                           size_t distance, size_t payload) PUBLIC;
+
+/// Variant of @c list_for_each_prefetch that visits elements from last to first.
+int list_for_each_reverse_prefetch(struct list *, int (*fn)(void *element, void *ctx), void *ctx,
+                                   size_t distance, size_t payload) PUBLIC;
+
+/// Number of buckets in @c list_stats.advance_log2: one per bit length of a @c size_t.
+#define LIST_STATS_BUCKETS (sizeof(size_t) * 8 + 1)
+
+/// Per-list operation counters, kept only when the library is built with @c LLIST_STATS defined.
+/// Operations that fail, and the inline fast paths of @c llist_inline.h, are not counted.
+struct list_stats {
+    /// Elements inserted by @c list_insert, @c list_insert_n, @c list_insert_sorted and their variants.
+    size_t inserts;
+    /// Elements erased by @c list_erase, @c list_erase_range, @c list_clear and their variants.
+    size_t erases;
+    /// Calls to @c list_splice, @c list_splice_range, @c list_concat, @c list_split and @c list_merge, on the target
+    /// list.
+    size_t splices;
+    /// Elements removed by @c list_pop_front and @c list_pop_back.
+    size_t pops;
+    /// Nodes walked by @c list_advance and @c list_advance_const; jumps through a positional index walk none.
+    size_t advance_steps;
+    /// Largest @c list_size seen.
+    size_t high_water;
+    /// Advance distances by bit length: bucket 0 counts distance 0, bucket k counts |n| in [2^(k-1), 2^k).
+    size_t advance_log2[LIST_STATS_BUCKETS];
+};
+
+/// Copy the operation counters of a list.
+/// @return Zero on success.
+/// @return Negative errno on failure:
+///   - EFAULT: NULL pointer argument.
+///   - ENOTSUP: Library built without @c LLIST_STATS.
+/// @warning In this mode @c list_advance_const writes the counters, so concurrent readers of one list race.
+int list_stats_get(const struct list *, struct list_stats *out) PUBLIC;
+
+/// Zero the operation counters of a list, and restart @c high_water from the current size.
+/// @return Zero on success.
+/// @return Negative errno on failure:
+///   - EFAULT: NULL pointer argument.
+///   - ENOTSUP: Library built without @c LLIST_STATS.
+int list_stats_reset(struct list *) PUBLIC;
+
+/// Opt-in inline fast paths.
+/// @see llist_inline.h.
+#ifdef LLIST_INLINE
+# include "llist_inline.h"
+#endif
+
 #endif
@@ -0,0 +1,371 @@
+#include "llist_compact.h"
+#include "llist_inline.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+struct list_compact {
+    /// Uses a dummy 'sentinel' node, as @c struct @c list does.
+    struct list_compact_node sentinel;
+    size_t size;
+    size_t offset;
+};
+
+/// Iterator has the same layout as list_compact_node.
+struct list_compact_iter {
+    struct list_compact_node node;
+};
+
+struct list_compact *list_compact_new(size_t offset)
+{
+    struct list_compact *l;
+
+    if ((offset % sizeof(void *)) != 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    l = calloc(1, sizeof(struct list_compact));
+    if (!l) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    l->sentinel.prev = &l->sentinel;
+    l->sentinel.next = &l->sentinel;
+    l->offset = offset;
+    return l;
+}
+
+void list_compact_delete(struct list_compact *l, void (*destructor)(void *))
+{
+    if (!l) {
+        return;
+    }
+
+    list_compact_clear(l, destructor);
+    free(l);
+}
+
+bool list_compact_empty(const struct list_compact *l)
+{
+    return list_compact_size(l) == 0;
+}
+
+size_t list_compact_size(const struct list_compact *l)
+{
+    if (!l) {
+        return 0;
+    }
+
+    return l->size;
+}
+
+int list_compact_clear(struct list_compact *l, void (*destructor)(void *))
+{
+    struct list_compact_node *node;
+
+    if (!l) {
+        return -EFAULT;
+    }
+
+    node = l->sentinel.next;
+
+    // Detach all nodes, so that destructors never observe dangling links.
+    l->sentinel.next = &l->sentinel;
+    l->sentinel.prev = &l->sentinel;
+    l->size = 0;
+
+    while (node != &l->sentinel) {
+        struct list_compact_node *next = node->next;
+
+        LLIST_PREFETCH(next);
+
+        // Mark node as unlinked.
+        node->next = NULL;
+        node->prev = NULL;
+
+        if (destructor) {
+            destructor((char *)node - l->offset);
+        }
+
+        node = next;
+    }
+
+    return 0;
+}
+
+struct list_compact_iter *list_compact_begin(struct list_compact *l)
+{
+    if (!l) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    return (struct list_compact_iter *)l->sentinel.next;
+}
+
+struct list_compact_iter *list_compact_end(struct list_compact *l)
+{
+    if (!l) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    return (struct list_compact_iter *)&l->sentinel;
+}
+
+/// Sanity check list and iterator arguments.
+/// @return Zero if valid, negative errno otherwise.
+static int check_iter(const struct list_compact *l, const struct list_compact_iter *it)
+{
+    if (!l || !it) {
+        return -EFAULT;
+    }
+
+    if (!it->node.next) {
+        // Iterator not linked.
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
+struct list_compact_iter *list_compact_next(struct list_compact *l, struct list_compact_iter *it)
+{
+    int r = check_iter(l, it);
+    if (r < 0) {
+        errno = -r;
+        return NULL;
+    }
+
+    if (&it->node == &l->sentinel) {
+        errno = ERANGE;
+        return NULL;
+    }
+
+    return (struct list_compact_iter *)it->node.next;
+}
+
+struct list_compact_iter *list_compact_prev(struct list_compact *l, struct list_compact_iter *it)
+{
+    int r = check_iter(l, it);
+    if (r < 0) {
+        errno = -r;
+        return NULL;
+    }
+
+    if (&it->node == l->sentinel.next) {
+        errno = ERANGE;
+        return NULL;
+    }
+
+    return (struct list_compact_iter *)it->node.prev;
+}
+
+struct list_compact_iter *list_compact_element(struct list_compact *l, void *element)
+{
+    if (!l || !element) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    return (struct list_compact_iter *)((char *)element + l->offset);
+}
+
+void *list_compact_at(struct list_compact *l, struct list_compact_iter *it)
+{
+    int r = check_iter(l, it);
+    if (r < 0) {
+        errno = -r;
+        return NULL;
+    }
+
+    if (&it->node == &l->sentinel) {
+        errno = ENOENT;
+        return NULL;
+    }
+
+    return (char *)it - l->offset;
+}
+
+/// Link unlinked @c node before @c rhs.
+static void impl_link(struct list_compact_node *rhs, struct list_compact_node *node)
+{
+    struct list_compact_node *lhs = rhs->prev;
+
+    node->next = rhs;
+    node->prev = lhs;
+    rhs->prev = node;
+    lhs->next = node;
+}
+
+/// Unlink @c node, and mark it unlinked.
+static void impl_unlink(struct list_compact_node *node)
+{
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    node->next = NULL;
+    node->prev = NULL;
+}
+
+struct list_compact_iter *list_compact_insert(struct list_compact *l, struct list_compact_iter *it, void *element)
+{
+    struct list_compact_node *node;
+    int r;
+
+    r = check_iter(l, it);
+    if (r < 0) {
+        errno = -r;
+        return NULL;
+    }
+
+    if (!element) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    if (l->size == SIZE_MAX) {
+        // Detect pathological overflow case.
+        errno = EOVERFLOW;
+        return NULL;
+    }
+
+    node = &list_compact_element(l, element)->node;
+    impl_link(&it->node, node);
+    l->size++;
+
+    return (struct list_compact_iter *)node;
+}
+
+struct list_compact_iter *list_compact_push_front(struct list_compact *l, void *element)
+{
+    return list_compact_insert(l, list_compact_begin(l), element);
+}
+
+struct list_compact_iter *list_compact_push_back(struct list_compact *l, void *element)
+{
+    return list_compact_insert(l, list_compact_end(l), element);
+}
+
+/// @return Unlinked element for given iterator.
+static void *impl_remove(struct list_compact *l, struct list_compact_iter *it)
+{
+    void *element;
+
+    element = list_compact_at(l, it);
+    if (!element) {
+        return NULL;
+    }
+
+    impl_unlink(&it->node);
+    l->size--;
+
+    return element;
+}
+
+void *list_compact_pop_front(struct list_compact *l)
+{
+    return impl_remove(l, list_compact_begin(l));
+}
+
+void *list_compact_pop_back(struct list_compact *l)
+{
+    return impl_remove(l, list_compact_prev(l, list_compact_end(l)));
+}
+
+int list_compact_erase(struct list_compact *l, struct list_compact_iter *it, void (*destructor)(void *))
+{
+    void *element;
+
+    element = impl_remove(l, it);
+    if (!element) {
+        return -errno;
+    }
+
+    if (destructor) {
+        destructor(element);
+    }
+
+    return 0;
+}
+
+int list_compact_splice(struct list_compact *l, struct list_compact_iter *it,
+                        struct list_compact *source, struct list_compact_iter *source_it)
+{
+    int r;
+
+    r = check_iter(l, it);
+    if (r < 0) {
+        return r;
+    }
+
+    r = check_iter(source, source_it);
+    if (r < 0) {
+        return r;
+    }
+
+    if (it == source_it || l->offset != source->offset) {
+        return -EINVAL;
+    }
+
+    if (&source_it->node == &source->sentinel) {
+        // Disallow list_compact_end() as source.
+        return -ENOENT;
+    }
+
+    if (l != source) {
+        if (l->size == SIZE_MAX) {
+            // Detect pathological overflow case.
+            return -EOVERFLOW;
+        }
+
+        source->size--;
+        l->size++;
+    }
+
+    impl_unlink(&source_it->node);
+    impl_link(&it->node, &source_it->node);
+
+    return 0;
+}
+
+int list_compact_concat(struct list_compact *l, struct list_compact *source)
+{
+    struct list_compact_node *head;
+    struct list_compact_node *tail;
+
+    if (!l || !source) {
+        return -EFAULT;
+    }
+
+    if (l == source || l->offset != source->offset) {
+        return -EINVAL;
+    }
+
+    if (l->size > SIZE_MAX - source->size) {
+        // Detect pathological overflow case.
+        return -EOVERFLOW;
+    }
+
+    if (!source->size) {
+        return 0;
+    }
+
+    head = source->sentinel.next;
+    tail = source->sentinel.prev;
+
+    head->prev = l->sentinel.prev;
+    tail->next = &l->sentinel;
+    l->sentinel.prev->next = head;
+    l->sentinel.prev = tail;
+    l->size += source->size;
+
+    source->sentinel.next = &source->sentinel;
+    source->sentinel.prev = &source->sentinel;
+    source->size = 0;
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+#ifndef LIBLIST_LLIST_COMPACT_H_
+#define LIBLIST_LLIST_COMPACT_H_
+
+/// Compact doubly-linked list.
+///
+/// Elements embed @c LIST_NODE_COMPACT, which holds only the @c next and @c prev links (two pointers instead of
+/// three for @c LIST_NODE).
+/// Nodes do not record the list they belong to, so every operation takes the list as its first argument,
+/// and end-of-list detection compares against the sentinel held by that list.
+///
+/// Example:
+///
+///     struct my_item {
+///         int value;
+///         LIST_NODE_COMPACT(link);
+///     };
+///
+///     struct list_compact *l = list_compact_new(offsetof(my_item, link));
+///
+/// Return conventions follow @c llist.h.
+///
+/// @warning Iterators and elements passed to an operation must belong to the list passed with them;
+///          unlike @c llist.h this cannot be verified.
+/// @note Because there is no per-node back-pointer, list_compact_concat() is O(1).
+
+#define LIST_NODE_COMPACT(name) struct list_compact_node name
+
+#include "llist.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/// Compact list object.
+/// This library is **not** thread-safe.
+struct list_compact;
+
+struct list_compact_node {
+    struct list_compact_node *next;
+    struct list_compact_node *prev;
+};
+
+/// Iterator object.
+/// @note Memory ownership: Owned by the object; valid until the element is removed, or the list is cleared or deleted.
+struct list_compact_iter;
+
+/// Constructor.
+/// @see list_new.
+struct list_compact *list_compact_new(size_t offset) PUBLIC;
+
+/// Destructor.
+/// @see list_delete.
+void list_compact_delete(struct list_compact *, void (*destructor)(void *)) PUBLIC;
+
+/// Test if list is empty.
+/// @return True if list is empty or NULL, false otherwise.
+bool list_compact_empty(const struct list_compact *) PUBLIC;
+
+/// Get number of elements in list.
+/// @return The number of elements in the list, or zero if empty or NULL.
+/// @note Complexity: O(1).
+size_t list_compact_size(const struct list_compact *) PUBLIC;
+
+/// Erases all elements from the container.
+/// @see list_clear.
+int list_compact_clear(struct list_compact *, void (*destructor)(void *)) PUBLIC;
+
+/// Get iterator to first element of list.
+/// @see list_begin.
+struct list_compact_iter *list_compact_begin(struct list_compact *) PUBLIC;
+
+/// Get an iterator past the last element of list.
+/// @see list_end.
+struct list_compact_iter *list_compact_end(struct list_compact *) PUBLIC;
+
+/// Forward move iterator.
+/// @return Pointer to iterator on success.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Iterator invalid.
+///   - ERANGE: Iterator is @c list_compact_end.
+struct list_compact_iter *list_compact_next(struct list_compact *, struct list_compact_iter *) PUBLIC;
+
+/// Reverse move iterator.
+/// @return Pointer to iterator on success.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Iterator invalid.
+///   - ERANGE: Iterator is @c list_compact_begin.
+struct list_compact_iter *list_compact_prev(struct list_compact *, struct list_compact_iter *) PUBLIC;
+
+/// Get an iterator from an element in the list.
+/// @return Pointer to iterator on success.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+struct list_compact_iter *list_compact_element(struct list_compact *, void *element) PUBLIC;
+
+/// Dereference iterator.
+/// @return Pointer to element on success.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Iterator invalid.
+///   - ENOENT: Iterator @c list_compact_end cannot be dereferenced.
+void *list_compact_at(struct list_compact *, struct list_compact_iter *) PUBLIC;
+
+/// Insert element before iterator.
+/// @see list_insert.
+struct list_compact_iter *list_compact_insert(struct list_compact *, struct list_compact_iter *, void *element) PUBLIC;
+
+/// Insert element at front of list.
+/// @see list_insert.
+struct list_compact_iter *list_compact_push_front(struct list_compact *, void *element) PUBLIC;
+
+/// Insert element at end of list.
+/// @see list_insert.
+struct list_compact_iter *list_compact_push_back(struct list_compact *, void *element) PUBLIC;
+
+/// Unlink and return the first element of the list.
+/// @see list_pop_front.
+void *list_compact_pop_front(struct list_compact *) PUBLIC;
+
+/// Unlink and return the last element of the list.
+/// @see list_pop_front.
+void *list_compact_pop_back(struct list_compact *) PUBLIC;
+
+/// Remove element from the list, calling @c destructor.
+/// @see list_erase.
+int list_compact_erase(struct list_compact *, struct list_compact_iter *, void (*destructor)(void *)) PUBLIC;
+
+/// Move single element @c source_iter of list @c source to before @c iter of list @c list.
+/// The lists may be the same instance.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Iterator invalid, @c iter equals @c source_iter, or the lists use different offsets.
+///   - ENOENT: Iterator @c list_compact_end cannot be moved.
+///   - EOVERFLOW: Destination list cannot grow.
+/// @note Does not invalidate existing iterators.
+/// @note Complexity: O(1).
+int list_compact_splice(struct list_compact *list, struct list_compact_iter *iter,
+                        struct list_compact *source, struct list_compact_iter *source_iter) PUBLIC;
+
+/// Move all elements of @c source to the end of @c list.
+/// @see list_concat.
+/// @note Complexity: O(1).
+int list_compact_concat(struct list_compact *list, struct list_compact *source) PUBLIC;
+
+#endif
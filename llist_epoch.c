@@ -0,0 +1,231 @@
+#include "llist_epoch.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+/// Retirements on one thread between collections.
+#define LIST_EPOCH_BATCH 64
+
+/// Per-thread record.
+/// Records are never freed; a record released by an exiting thread is reused by the next thread to register.
+struct epoch_thread {
+    /// Announced epoch shifted left by one, with bit 0 set while inside a critical section.
+    atomic_ulong state;
+    atomic_bool in_use;
+    /// Nesting depth; only accessed by the owning thread.
+    unsigned depth;
+    /// Retirements since the last collection; only accessed by the owning thread.
+    unsigned pending;
+    /// Elements retired by this thread. Pushed by the owner; taken whole by any collector.
+    _Atomic(struct list_epoch_retired *) limbo;
+    struct epoch_thread *next;
+};
+
+static atomic_ulong g_epoch = 1;
+static _Atomic(struct epoch_thread *) g_threads;
+
+/// Elements left by exiting threads, or not yet expired when a collector took them from another thread.
+static _Atomic(struct list_epoch_retired *) g_orphans;
+
+static pthread_once_t g_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_key;
+static _Thread_local struct epoch_thread *t_self;
+
+/// Push the chain from @c first to @c last onto @c stack.
+static void impl_push(_Atomic(struct list_epoch_retired *) *stack, struct list_epoch_retired *first,
+                      struct list_epoch_retired *last)
+{
+    last->next = atomic_load(stack);
+    while (!atomic_compare_exchange_weak(stack, &last->next, first)) {
+    }
+}
+
+/// Destroy the elements of @c chain whose grace period has elapsed by @c epoch, and push the rest onto @c stack.
+static void impl_reclaim(struct list_epoch_retired *chain, unsigned long epoch,
+                         _Atomic(struct list_epoch_retired *) *stack)
+{
+    struct list_epoch_retired *kept = NULL;
+    struct list_epoch_retired *kept_last = NULL;
+    struct list_epoch_retired *expired = NULL;
+
+    while (chain) {
+        struct list_epoch_retired *next = chain->next;
+        if (chain->epoch + 2 <= epoch) {
+            chain->next = expired;
+            expired = chain;
+        } else {
+            if (!kept) {
+                kept_last = chain;
+            }
+            chain->next = kept;
+            kept = chain;
+        }
+        chain = next;
+    }
+
+    if (kept) {
+        impl_push(stack, kept, kept_last);
+    }
+
+    // Destructors run once the chain is settled, so they may use the concurrent containers.
+    while (expired) {
+        struct list_epoch_retired *next = expired->next;
+        if (expired->destructor) {
+            expired->destructor(expired->element);
+        }
+        free(expired);
+        expired = next;
+    }
+}
+
+/// Release the record of an exiting thread, handing its pending elements to the next collector.
+static void impl_release(void *record)
+{
+    struct epoch_thread *self = record;
+    struct list_epoch_retired *chain = atomic_exchange(&self->limbo, NULL);
+
+    if (chain) {
+        struct list_epoch_retired *last = chain;
+        while (last->next) {
+            last = last->next;
+        }
+        impl_push(&g_orphans, chain, last);
+    }
+
+    self->pending = 0;
+    atomic_store(&self->state, 0);
+    atomic_store(&self->in_use, false);
+    t_self = NULL;
+}
+
+static void impl_key_create(void)
+{
+    pthread_key_create(&g_key, impl_release);
+}
+
+/// Claim a free record, or add a new one.
+/// @return Record on success, NULL otherwise.
+static struct epoch_thread *impl_register(void)
+{
+    struct epoch_thread *self;
+
+    pthread_once(&g_key_once, impl_key_create);
+
+    for (self = atomic_load(&g_threads); self; self = self->next) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&self->in_use, &expected, true)) {
+            break;
+        }
+    }
+
+    if (!self) {
+        self = calloc(1, sizeof(struct epoch_thread));
+        if (!self) {
+            return NULL;
+        }
+
+        atomic_init(&self->in_use, true);
+        self->next = atomic_load(&g_threads);
+        while (!atomic_compare_exchange_weak(&g_threads, &self->next, self)) {
+        }
+    }
+
+    pthread_setspecific(g_key, self);
+    t_self = self;
+    return self;
+}
+
+int list_epoch_enter(void)
+{
+    struct epoch_thread *self = t_self;
+
+    if (!self) {
+        self = impl_register();
+        if (!self) {
+            return -ENOMEM;
+        }
+    }
+
+    if (self->depth++ == 0) {
+        // Announce, then fence, so that writers scanning records see it before this thread reads any node.
+        atomic_store(&self->state, (atomic_load(&g_epoch) << 1) | 1);
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+
+    return 0;
+}
+
+void list_epoch_exit(void)
+{
+    struct epoch_thread *self = t_self;
+
+    if (--self->depth == 0) {
+        atomic_store_explicit(&self->state, 0, memory_order_release);
+    }
+}
+
+/// Advance the global epoch if every active reader has observed it.
+/// @return The global epoch.
+static unsigned long impl_advance(void)
+{
+    unsigned long epoch = atomic_load(&g_epoch);
+
+    for (struct epoch_thread *t = atomic_load(&g_threads); t; t = t->next) {
+        unsigned long state = atomic_load(&t->state);
+        if ((state & 1) && (state >> 1) != epoch) {
+            return epoch;
+        }
+    }
+
+    atomic_compare_exchange_strong(&g_epoch, &epoch, epoch + 1);
+    return atomic_load(&g_epoch);
+}
+
+/// Destroy the expired elements retired by the calling thread, and any left by exited threads.
+static void impl_collect(struct epoch_thread *self)
+{
+    unsigned long epoch = impl_advance();
+
+    self->pending = 0;
+    impl_reclaim(atomic_exchange(&self->limbo, NULL), epoch, &self->limbo);
+    impl_reclaim(atomic_exchange(&g_orphans, NULL), epoch, &g_orphans);
+}
+
+void list_epoch_retire(struct list_epoch_retired *record, void *element, void (*destructor)(void *))
+{
+    struct epoch_thread *self = t_self;
+
+    record->element = element;
+    record->destructor = destructor;
+    record->epoch = atomic_load(&g_epoch);
+
+    // Only a thread that never entered a critical section has no record; let the next collector have it.
+    if (!self) {
+        impl_push(&g_orphans, record, record);
+        return;
+    }
+
+    impl_push(&self->limbo, record, record);
+    if (++self->pending >= LIST_EPOCH_BATCH) {
+        impl_collect(self);
+    }
+}
+
+void list_epoch_synchronize(void)
+{
+    unsigned long target = atomic_load(&g_epoch) + 2;
+    unsigned long epoch;
+
+    while ((epoch = impl_advance()) < target) {
+        sched_yield();
+    }
+
+    // Elements retired before the call now have epoch + 2 <= target.
+    for (struct epoch_thread *t = atomic_load(&g_threads); t; t = t->next) {
+        impl_reclaim(atomic_exchange(&t->limbo, NULL), epoch, &g_orphans);
+    }
+    impl_reclaim(atomic_exchange(&g_orphans, NULL), epoch, &g_orphans);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+// Private API.
+// Epoch-based memory reclamation for the concurrent containers.
+//
+// Readers bracket every traversal with list_epoch_enter() and list_epoch_exit().
+// Writers unlink an element, then list_epoch_retire() it; its destructor runs once every reader that might still
+// hold a reference has left its critical section.
+//
+// A global epoch advances when every active reader has observed it. An element retired in epoch e is destroyed
+// once the global epoch reaches e + 2: by then every reader active at retirement has exited.
+//
+// Each thread keeps its own limbo list and collects it every LIST_EPOCH_BATCH retirements, so retirement takes no
+// lock. Lists left by exiting threads, and elements a collector took but could not yet destroy, wait on a shared
+// stack for the next collector.
+
+#include <stdbool.h>
+
+/// Deferred destruction record.
+/// Allocated by the caller before unlinking, so that retirement itself cannot fail.
+struct list_epoch_retired {
+    struct list_epoch_retired *next;
+    void *element;
+    void (*destructor)(void *);
+    unsigned long epoch;
+};
+
+/// Enter a read-side critical section. Sections nest.
+/// @return Zero on success, negative errno otherwise.
+///   - ENOMEM: Insufficient memory to register the calling thread.
+int list_epoch_enter(void);
+
+/// Leave a read-side critical section.
+void list_epoch_exit(void);
+
+/// Destroy @c element with @c destructor after a grace period. Lock-free.
+/// @param record Record from malloc(); ownership passes to the epoch module.
+void list_epoch_retire(struct list_epoch_retired *record, void *element, void (*destructor)(void *));
+
+/// Wait for a grace period, then destroy everything retired before the call, on any thread.
+/// @note Elements that another thread is collecting at the same time may outlive the call; a later collection
+///   destroys them.
+/// @warning Must not be called from within a read-side critical section.
+void list_epoch_synchronize(void);
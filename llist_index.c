@@ -0,0 +1,516 @@
+#include "llist_index.h"
+#include "llist_inline.h"
+#include "llist_map.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// Null node index.
+#define NIL SIZE_MAX
+
+/// Treap node, ordered by list position.
+/// Nodes are addressed by array index so that the array can grow with realloc.
+struct index_node {
+    size_t left;
+    size_t right;
+    size_t parent;
+    /// Number of nodes in this subtree.
+    size_t count;
+    struct list_node *node;
+    uint32_t priority;
+};
+
+/// Positional index: a treap with implicit keys (subtree counts), plus a hash map to find the treap node of a list
+/// node. The position of a node is its rank in the treap.
+///
+///     count:       c(5)
+///                 /    |
+///             b(2)     e(2)
+///            /        /
+///        a(1)     d(1)
+///
+///     list:  a  b  c  d  e
+struct list_index {
+    struct index_node *nodes;
+    size_t capacity;
+    size_t used;
+    /// Free list of recycled nodes, linked through @c left.
+    size_t free;
+    size_t root;
+
+    /// Treap node of each list node.
+    struct list_map map;
+
+    /// Value of @c list->generation when the index last matched the list.
+    size_t generation;
+    uint32_t seed;
+};
+
+static size_t impl_count(const struct list_index *ix, size_t i)
+{
+    return i == NIL ? 0 : ix->nodes[i].count;
+}
+
+/// Recompute the count of @c i, and adopt its children.
+static void impl_update(struct list_index *ix, size_t i)
+{
+    struct index_node *n = &ix->nodes[i];
+
+    n->count = 1 + impl_count(ix, n->left) + impl_count(ix, n->right);
+    if (n->left != NIL) {
+        ix->nodes[n->left].parent = i;
+    }
+    if (n->right != NIL) {
+        ix->nodes[n->right].parent = i;
+    }
+}
+
+static void impl_set_root(struct list_index *ix, size_t root)
+{
+    ix->root = root;
+    if (root != NIL) {
+        ix->nodes[root].parent = NIL;
+    }
+}
+
+/// Split tree @c t into its first @c k nodes @c a, and the remainder @c b.
+static void impl_split(struct list_index *ix, size_t t, size_t k, size_t *a, size_t *b)
+{
+    struct index_node *n;
+
+    if (t == NIL) {
+        *a = NIL;
+        *b = NIL;
+        return;
+    }
+
+    n = &ix->nodes[t];
+    if (impl_count(ix, n->left) < k) {
+        impl_split(ix, n->right, k - impl_count(ix, n->left) - 1, &n->right, b);
+        impl_update(ix, t);
+        *a = t;
+    } else {
+        impl_split(ix, n->left, k, a, &n->left);
+        impl_update(ix, t);
+        *b = t;
+    }
+}
+
+/// Concatenate trees @c a and @c b.
+/// @return Root of the joined tree.
+static size_t impl_join(struct list_index *ix, size_t a, size_t b)
+{
+    if (a == NIL) {
+        return b;
+    }
+
+    if (b == NIL) {
+        return a;
+    }
+
+    if (ix->nodes[a].priority > ix->nodes[b].priority) {
+        ix->nodes[a].right = impl_join(ix, ix->nodes[a].right, b);
+        impl_update(ix, a);
+        return a;
+    }
+
+    ix->nodes[b].left = impl_join(ix, a, ix->nodes[b].left);
+    impl_update(ix, b);
+    return b;
+}
+
+/// @return Position of treap node @c i.
+static size_t impl_rank(const struct list_index *ix, size_t i)
+{
+    size_t rank = impl_count(ix, ix->nodes[i].left);
+
+    for (size_t p = ix->nodes[i].parent; p != NIL; i = p, p = ix->nodes[p].parent) {
+        if (ix->nodes[p].right == i) {
+            rank += impl_count(ix, ix->nodes[p].left) + 1;
+        }
+    }
+
+    return rank;
+}
+
+/// @return Treap node at position @c k.
+/// @pre @c k is less than the number of nodes.
+static size_t impl_select(const struct list_index *ix, size_t k)
+{
+    size_t i = ix->root;
+
+    for (;;) {
+        size_t left = impl_count(ix, ix->nodes[i].left);
+
+        if (k < left) {
+            i = ix->nodes[i].left;
+        } else if (k == left) {
+            return i;
+        } else {
+            k -= left + 1;
+            i = ix->nodes[i].right;
+        }
+    }
+}
+
+static uint32_t impl_random(struct list_index *ix)
+{
+    // xorshift32.
+    ix->seed ^= ix->seed << 13;
+    ix->seed ^= ix->seed >> 17;
+    ix->seed ^= ix->seed << 5;
+    return ix->seed;
+}
+
+/// Ensure room for @c n treap nodes.
+/// @return Zero on success, negative errno otherwise.
+static int impl_reserve(struct list_index *ix, size_t n)
+{
+    struct index_node *nodes;
+    size_t capacity = ix->capacity ? ix->capacity : 16;
+
+    if (n <= ix->capacity) {
+        return 0;
+    }
+
+    while (capacity < n) {
+        capacity *= 2;
+    }
+
+    nodes = realloc(ix->nodes, capacity * sizeof(struct index_node));
+    if (!nodes) {
+        return -ENOMEM;
+    }
+
+    ix->nodes = nodes;
+    ix->capacity = capacity;
+    return 0;
+}
+
+/// Allocate a detached treap node for @c node.
+/// @return Treap node on success, NIL otherwise.
+static size_t impl_node_new(struct list_index *ix, struct list_node *node)
+{
+    size_t i;
+
+    if (ix->free != NIL) {
+        i = ix->free;
+        ix->free = ix->nodes[i].left;
+    } else {
+        if (impl_reserve(ix, ix->used + 1) < 0) {
+            return NIL;
+        }
+        i = ix->used++;
+    }
+
+    ix->nodes[i].left = NIL;
+    ix->nodes[i].right = NIL;
+    ix->nodes[i].parent = NIL;
+    ix->nodes[i].count = 1;
+    ix->nodes[i].node = node;
+    ix->nodes[i].priority = impl_random(ix);
+    return i;
+}
+
+static void impl_node_delete(struct list_index *ix, size_t i)
+{
+    ix->nodes[i].left = ix->free;
+    ix->free = i;
+}
+
+/// Recompute counts below @c i.
+static size_t impl_recount(struct list_index *ix, size_t i)
+{
+    if (i == NIL) {
+        return 0;
+    }
+
+    ix->nodes[i].count = 1 + impl_recount(ix, ix->nodes[i].left) + impl_recount(ix, ix->nodes[i].right);
+    return ix->nodes[i].count;
+}
+
+/// Rebuild the index of @c l from the list in O(n).
+/// Nodes are appended along the right spine, which builds the treap without any rotations.
+/// @return Zero on success, negative errno otherwise.
+static int impl_rebuild(struct list *l)
+{
+    struct list_index *ix = l->index;
+    size_t last = NIL;
+    size_t i = 0;
+    int r;
+
+    r = impl_reserve(ix, l->size);
+    if (r == 0) {
+        r = list_map_reset(&ix->map, l->size);
+    }
+    if (r < 0) {
+        return r;
+    }
+
+    ix->used = l->size;
+    ix->free = NIL;
+    ix->root = NIL;
+
+    for (struct list_node *node = l->sentinel.next; node != &l->sentinel; node = node->next, i++) {
+        struct index_node *n = &ix->nodes[i];
+        size_t child = NIL;
+        size_t p = last;
+
+        n->node = node;
+        n->priority = impl_random(ix);
+
+        // Climb the right spine to the first ancestor of higher priority; the climbed path becomes our left child.
+        while (p != NIL && ix->nodes[p].priority < n->priority) {
+            child = p;
+            p = ix->nodes[p].parent;
+        }
+
+        n->left = child;
+        n->right = NIL;
+        n->parent = p;
+        if (child != NIL) {
+            ix->nodes[child].parent = i;
+        }
+        if (p != NIL) {
+            ix->nodes[p].right = i;
+        } else {
+            ix->root = i;
+        }
+        last = i;
+
+        // Cannot fail; the table was sized above.
+        list_map_insert(&ix->map, node, i);
+    }
+
+    impl_recount(ix, ix->root);
+    ix->generation = l->generation;
+    return 0;
+}
+
+/// @return Treap node of @c node.
+static size_t impl_find(const struct list_index *ix, const struct list_node *node)
+{
+    return (size_t)*list_map_find(&ix->map, node);
+}
+
+bool list_index_current(const struct list *l)
+{
+    return l->index->generation == l->generation;
+}
+
+bool list_index_prepare(struct list *l)
+{
+    return list_index_current(l) || impl_rebuild(l) == 0;
+}
+
+void list_index_linked(struct list *l, struct list_node *node)
+{
+    struct list_index *ix = l->index;
+    size_t i;
+    size_t rank;
+    size_t a;
+    size_t b;
+
+    rank = node->next == &l->sentinel ? impl_count(ix, ix->root) : impl_rank(ix, impl_find(ix, node->next));
+
+    i = impl_node_new(ix, node);
+    if (i == NIL) {
+        // Index is left out of date, and rebuilt on demand.
+        return;
+    }
+
+    if (list_map_insert(&ix->map, node, i) < 0) {
+        impl_node_delete(ix, i);
+        return;
+    }
+
+    impl_split(ix, ix->root, rank, &a, &b);
+    impl_set_root(ix, impl_join(ix, impl_join(ix, a, i), b));
+    ix->generation = l->generation;
+}
+
+void list_index_unlinked(struct list *l, struct list_node *node)
+{
+    struct list_index *ix = l->index;
+    size_t i = impl_find(ix, node);
+    size_t a;
+    size_t b;
+    size_t c;
+
+    impl_split(ix, ix->root, impl_rank(ix, i), &a, &b);
+    impl_split(ix, b, 1, &b, &c);
+    impl_set_root(ix, impl_join(ix, a, c));
+
+    list_map_remove(&ix->map, node);
+    impl_node_delete(ix, i);
+    ix->generation = l->generation;
+}
+
+void list_index_moved(struct list *l, struct list_node *first, struct list_node *tail)
+{
+    struct list_index *ix = l->index;
+    size_t begin = impl_rank(ix, impl_find(ix, first));
+    size_t end = impl_rank(ix, impl_find(ix, tail)) + 1;
+    size_t pos = tail->next == &l->sentinel ? impl_count(ix, ix->root) : impl_rank(ix, impl_find(ix, tail->next));
+    size_t a;
+    size_t b;
+    size_t range;
+    size_t c;
+
+    // The treap still has the old order. Cut it into pieces around the moved range, and reassemble.
+    if (pos < begin) {
+        // [0, pos) [pos, begin) [begin, end) [end, n) => a range b c.
+        impl_split(ix, ix->root, end, &b, &c);
+        impl_split(ix, b, begin, &b, &range);
+        impl_split(ix, b, pos, &a, &b);
+        impl_set_root(ix, impl_join(ix, impl_join(ix, a, range), impl_join(ix, b, c)));
+    } else {
+        // [0, begin) [begin, end) [end, pos) [pos, n) => a b range c.
+        impl_split(ix, ix->root, pos, &b, &c);
+        impl_split(ix, b, end, &range, &b);
+        impl_split(ix, range, begin, &a, &range);
+        impl_set_root(ix, impl_join(ix, impl_join(ix, a, b), impl_join(ix, range, c)));
+    }
+
+    ix->generation = l->generation;
+}
+
+void list_index_free(struct list_index *ix)
+{
+    if (!ix) {
+        return;
+    }
+
+    free(ix->nodes);
+    list_map_free(&ix->map);
+    free(ix);
+}
+
+int list_index_enable(struct list *l)
+{
+    struct list_index *ix;
+    int r;
+
+    if (!l) {
+        return -EFAULT;
+    }
+
+    if (l->index) {
+        return 0;
+    }
+
+    ix = calloc(1, sizeof(struct list_index));
+    if (!ix) {
+        return -ENOMEM;
+    }
+
+    ix->free = NIL;
+    ix->root = NIL;
+    ix->seed = 2463534242u;
+    l->index = ix;
+
+    r = impl_rebuild(l);
+    if (r < 0) {
+        list_index_disable(l);
+        return r;
+    }
+
+    return 0;
+}
+
+int list_index_refresh(struct list *l)
+{
+    if (!l) {
+        return -EFAULT;
+    }
+
+    if (!l->index) {
+        return -EINVAL;
+    }
+
+    if (list_index_current(l)) {
+        return 0;
+    }
+
+    return impl_rebuild(l);
+}
+
+int list_index_disable(struct list *l)
+{
+    if (!l) {
+        return -EFAULT;
+    }
+
+    list_index_free(l->index);
+    l->index = NULL;
+    return 0;
+}
+
+struct list_iter *list_nth(struct list *l, size_t n)
+{
+    struct list_node *node;
+
+    if (!l) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    if (n > l->size) {
+        errno = ERANGE;
+        return NULL;
+    }
+
+    if (n == l->size) {
+        return (struct list_iter *)&l->sentinel;
+    }
+
+    // An out of date index is not rebuilt here, so that concurrent readers never write to the list.
+    if (l->index && list_index_current(l)) {
+        return (struct list_iter *)l->index->nodes[impl_select(l->index, n)].node;
+    }
+
+    // Walk from the nearer end.
+    if (n < l->size / 2) {
+        for (node = l->sentinel.next; n > 0; n--) {
+            node = node->next;
+        }
+    } else {
+        for (node = &l->sentinel, n = l->size - n; n > 0; n--) {
+            node = node->prev;
+        }
+    }
+
+    return (struct list_iter *)node;
+}
+
+ssize_t list_index_of(const struct list_iter *it)
+{
+    struct list *l;
+    const struct list_node *node;
+    size_t n = 0;
+
+    if (!it) {
+        return -EFAULT;
+    }
+
+    l = list_inline_owner(&it->node);
+    if (!l) {
+        // Iterator not linked.
+        return -EINVAL;
+    }
+
+    if (&it->node == &l->sentinel) {
+        return (ssize_t)l->size;
+    }
+
+    if (l->index && list_index_current(l)) {
+        return (ssize_t)impl_rank(l->index, impl_find(l->index, &it->node));
+    }
+
+    for (node = it->node.prev; node != &l->sentinel; node = node->prev) {
+        n++;
+    }
+
+    return (ssize_t)n;
+}
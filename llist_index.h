@@ -0,0 +1,34 @@
+#pragma once
+
+// Private API.
+// Positional index hooks used by llist.c.
+// @see list_index_enable.
+
+#include "llist.h"
+
+#include <stdbool.h>
+
+struct list_index;
+
+/// Advance distance above which @c list_advance jumps through the index instead of walking.
+#define LIST_INDEX_ADVANCE_MIN 16
+
+/// @return True if the index of @c l matches the list.
+/// Check before a change, then report the change with one of the hooks below to keep the index current.
+bool list_index_current(const struct list *l);
+
+/// Rebuild the index of @c l if it is out of date; for use by writers only.
+/// @return True if the index is current.
+bool list_index_prepare(struct list *l);
+
+/// Record that @c node was linked into @c l.
+void list_index_linked(struct list *l, struct list_node *node);
+
+/// Record that @c node was unlinked from @c l.
+void list_index_unlinked(struct list *l, struct list_node *node);
+
+/// Record that the nodes [@c first, @c tail] were moved, within @c l, to before @c tail->next.
+void list_index_moved(struct list *l, struct list_node *first, struct list_node *tail);
+
+/// Release @c index.
+void list_index_free(struct list_index *index);
@@ -0,0 +1,543 @@
+#ifndef LIBLIST_LLIST_INLINE_H_
+#define LIBLIST_LLIST_INLINE_H_
+
+/// Inline fast paths.
+///
+/// Exposes the list layout so that single-step traversal, dereference, insertion and unlinking can be inlined into
+/// the caller and folded into tight pointer-chasing loops.
+///
+/// The @c list_inline_* functions have exactly the same semantics (return values and errno) as their out-of-line
+/// counterparts in @c llist.h.
+///
+/// Define @c LLIST_INLINE before including @c llist.h to transparently route the hot functions through the inline
+/// variants:
+///
+///     #define LLIST_INLINE
+///     #include <liblist/llist.h>
+///
+/// @note Taking the address of a function, or calling it as @c (list_next)(it), still uses the library symbol.
+/// @warning The list layout is not a stable ABI; code using this header must be rebuilt along with the library.
+///
+/// The @c list_*_unchecked functions skip argument validation and never write errno.
+/// Misuse is undefined behaviour; builds without @c NDEBUG verify preconditions and link invariants with assert().
+/// Define @c LLIST_CHECKED to 0 along with @c LLIST_INLINE to route the hot functions through the unchecked variants.
+
+#include "llist.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+
+#ifndef SIZE_MAX
+// Support compilation on Atari Lattice C.
+#define SIZE_MAX ((size_t)-1)
+#endif
+
+/// Hint that @c addr will soon be read.
+#if defined(__GNUC__)
+# define LLIST_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+# define LLIST_PREFETCH(addr) ((void)(addr))
+#endif
+
+struct list {
+    /// Uses a dummy 'sentinel' node, in order to simplify link management.
+    ///
+    /// Base case:
+    ///           +------+
+    ///           v      |
+    ///     +--------+   |
+    ///     |    next|---+
+    ///     |sentinel|
+    /// +---|prev    |
+    /// |   +--------+
+    /// |      ^
+    /// +------+
+    ///
+    /// General case:
+    ///           +--------------------+
+    ///           v                    |
+    ///     +--------+    +--------+   |
+    ///     |    next|--->|    next|---+
+    ///     |sentinel|    |  node  |
+    /// +---|prev    |<---|prev    |
+    /// |   +--------+    +--------+
+    /// |                    ^
+    /// +--------------------+
+    struct list_node sentinel;
+    size_t size;
+    size_t offset;
+    /// Incremented by every change to the node order, so that @c index and @c order can detect that they are out of
+    /// date.
+    size_t generation;
+    /// Optional positional index, or NULL.
+    /// @see list_index_enable.
+    struct list_index *index;
+    /// Optional order-maintenance labels, or NULL.
+    /// @see list_order_enable.
+    struct list_order *order;
+    /// Node most recently inserted by @c list_insert_sorted; valid only while @c generation equals
+    /// @c finger_generation.
+    struct list_node *finger;
+    size_t finger_generation;
+#ifdef LLIST_STATS
+    /// Operation counters; last, so that the fields above keep their offsets.
+    /// @see list_stats_get.
+    struct list_stats stats;
+#endif
+};
+
+/// Iterator has the same layout as list_node.
+/// Clients only ever see a pointer-to-iterator, thus the implementation is opaque.
+struct list_iter {
+    struct list_node node;
+};
+
+/// @return The list that @c node is linked into, or NULL if it is not linked.
+/// @note A node erased by @c list_rcu_erase keeps @c list and @c next until its grace period ends, for readers still
+///       on it, but loses @c prev; it is no longer linked.
+static inline struct list *list_inline_owner(const struct list_node *node)
+{
+    return node->prev ? node->list : NULL;
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-qual"
+#pragma GCC diagnostic ignored "-Wcast-align"
+
+/// Inline variant of @c list_cbegin.
+static inline const struct list_iter *list_inline_cbegin(const struct list *l)
+{
+    if (!l) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    return (const struct list_iter *)l->sentinel.next;
+}
+
+/// Inline variant of @c list_begin.
+static inline struct list_iter *list_inline_begin(struct list *l)
+{
+    // Const cast away is safe because @c l is non-const.
+    return (struct list_iter *)list_inline_cbegin(l);
+}
+
+/// Inline variant of @c list_cend.
+static inline const struct list_iter *list_inline_cend(const struct list *l)
+{
+    if (!l) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    return (const struct list_iter *)&l->sentinel;
+}
+
+/// Inline variant of @c list_end.
+static inline struct list_iter *list_inline_end(struct list *l)
+{
+    // Const cast away is safe because @c l is non-const.
+    return (struct list_iter *)list_inline_cend(l);
+}
+
+/// Inline variant of @c list_cnext.
+/// Equivalent to @c list_advance_const(it, 1) without the general loop.
+static inline const struct list_iter *list_inline_cnext(const struct list_iter *it)
+{
+    const struct list *l;
+
+    if (!it) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    l = list_inline_owner(&it->node);
+    if (!l) {
+        // Iterator not linked.
+        errno = EINVAL;
+        return NULL;
+    }
+
+    if (&it->node == &l->sentinel) {
+        errno = ERANGE;
+        return NULL;
+    }
+
+    return (const struct list_iter *)it->node.next;
+}
+
+/// Inline variant of @c list_next.
+static inline struct list_iter *list_inline_next(struct list_iter *it)
+{
+    // Const cast away is safe because @c it is non-const.
+    return (struct list_iter *)list_inline_cnext(it);
+}
+
+/// Inline variant of @c list_cprev.
+/// Equivalent to @c list_advance_const(it, -1) without the general loop.
+static inline const struct list_iter *list_inline_cprev(const struct list_iter *it)
+{
+    const struct list *l;
+
+    if (!it) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    l = list_inline_owner(&it->node);
+    if (!l) {
+        // Iterator not linked.
+        errno = EINVAL;
+        return NULL;
+    }
+
+    if (&it->node == l->sentinel.next) {
+        errno = ERANGE;
+        return NULL;
+    }
+
+    return (const struct list_iter *)it->node.prev;
+}
+
+/// Inline variant of @c list_prev.
+static inline struct list_iter *list_inline_prev(struct list_iter *it)
+{
+    // Const cast away is safe because @c it is non-const.
+    return (struct list_iter *)list_inline_cprev(it);
+}
+
+/// Inline variant of @c list_at_const.
+/// @note Unlike the other functions, accepts a node erased by @c list_rcu_erase, for readers still on it.
+static inline const void *list_inline_at_const(const struct list_iter *it)
+{
+    const struct list *l;
+
+    if (!it) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    l = it->node.list;
+    if (!l) {
+        // Iterator not linked.
+        errno = EINVAL;
+        return NULL;
+    }
+
+    if (&it->node == &l->sentinel) {
+        errno = ENOENT;
+        return NULL;
+    }
+
+    return (const void *)((const char *)it - l->offset);
+}
+
+/// Inline variant of @c list_at.
+static inline void *list_inline_at(struct list_iter *it)
+{
+    // Const cast away is safe because @c it is non-const.
+    return (void *)list_inline_at_const(it);
+}
+
+/// Inline variant of @c list_insert.
+static inline struct list_iter *list_inline_insert(struct list_iter *it, void *element)
+{
+    struct list *l;
+    struct list_node *link;
+    struct list_node *rhs;
+    struct list_node *lhs;
+
+    if (!it) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    if (!element) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    l = list_inline_owner(&it->node);
+    if (!l) {
+        // Iterator not linked.
+        errno = EINVAL;
+        return NULL;
+    }
+
+    if (l->size == SIZE_MAX) {
+        // Detect pathological overflow case.
+        errno = EOVERFLOW;
+        return NULL;
+    }
+
+    if ((l->offset % sizeof(void *)) != 0) {
+        // Embedded list_node would be misaligned.
+        errno = EINVAL;
+        return NULL;
+    }
+
+    ///     +-------+    +--------+    +-------+
+    /// --->|       |-4->|    next|-1->|       |--->
+    ///     |  lhs  |    |  link  |    |  rhs  |
+    /// <---|       |<-2-|prev    |<-3-|       |<---
+    ///     +-------+    +--------+    +-------+
+
+    link = (struct list_node *)((char *)element + l->offset);
+    rhs = &it->node;
+    lhs = rhs->prev;
+
+    link->next = rhs;  // 1
+    link->prev = lhs;  // 2
+    link->list = l;
+
+    rhs->prev = link;  // 3
+    lhs->next = link;  // 4
+
+    l->size++;
+    l->generation++;
+
+    return (struct list_iter *)link;
+}
+
+/// Inline variant of @c list_push_front.
+static inline struct list_iter *list_inline_push_front(struct list *l, void *element)
+{
+    return list_inline_insert(list_inline_begin(l), element);
+}
+
+/// Inline variant of @c list_push_back.
+static inline struct list_iter *list_inline_push_back(struct list *l, void *element)
+{
+    return list_inline_insert(list_inline_end(l), element);
+}
+
+/// Unlink iterator from its list.
+/// @return Unlinked element on success.
+/// @return NULL on failure, and errno is set as for @c list_at.
+static inline void *list_inline_unlink(struct list_iter *it)
+{
+    void *element;
+    struct list_node *source;
+
+    element = list_inline_at(it);
+    if (!element) {
+        return NULL;
+    }
+
+    if (!list_inline_owner(&it->node)) {
+        // Erased by list_rcu_erase, and awaiting its grace period.
+        errno = EINVAL;
+        return NULL;
+    }
+
+    ///     +-------+                    +-------+
+    ///     |       |-1----------------->|       |
+    ///     |       |     +--------+     |       |
+    /// --->|       |     |    next|-3-X |       |--->
+    ///     |  lhs  |     | source |     |  rhs  |
+    /// <---|       | X-4-|prev    |     |       |<---
+    ///     |       |     +--------+     |       |
+    ///     |       |<-----------------2-|       |
+    ///     +-------+                    +-------+
+
+    source = &it->node;
+
+    // Unlink from current position.
+    source->prev->next = source->next; // 1
+    source->next->prev = source->prev; // 2
+    source->list->size--;
+    source->list->generation++;
+
+    // Mark node as unlinked.
+    source->next = NULL; // 3
+    source->prev = NULL; // 4
+    source->list = NULL;
+
+    return element;
+}
+
+/// Inline variant of @c list_pop_front.
+static inline void *list_inline_pop_front(struct list *l)
+{
+    return list_inline_unlink(list_inline_begin(l));
+}
+
+/// Inline variant of @c list_pop_back.
+static inline void *list_inline_pop_back(struct list *l)
+{
+    return list_inline_unlink(list_inline_prev(list_inline_end(l)));
+}
+
+/// Verify that @c node is correctly linked into a list.
+/// @note Compiles to nothing when @c NDEBUG is defined.
+static inline void list_inline_assert_linked(const struct list_node *node)
+{
+    assert(node);
+    assert(node->list);
+    assert(node->next && node->next->prev == node);
+    assert(node->prev && node->prev->next == node);
+    (void)node;
+}
+
+/// Unchecked variant of @c list_next.
+/// @warning @c it must be a valid iterator other than @c list_end.
+static inline struct list_iter *list_next_unchecked(struct list_iter *it)
+{
+    list_inline_assert_linked(&it->node);
+    assert(&it->node != &it->node.list->sentinel);
+    return (struct list_iter *)it->node.next;
+}
+
+/// Unchecked variant of @c list_prev.
+/// @warning @c it must be a valid iterator other than @c list_begin.
+static inline struct list_iter *list_prev_unchecked(struct list_iter *it)
+{
+    list_inline_assert_linked(&it->node);
+    assert(&it->node != it->node.list->sentinel.next);
+    return (struct list_iter *)it->node.prev;
+}
+
+/// Unchecked variant of @c list_at.
+/// @warning @c it must be a valid iterator other than @c list_end.
+static inline void *list_at_unchecked(struct list_iter *it)
+{
+    list_inline_assert_linked(&it->node);
+    assert(&it->node != &it->node.list->sentinel);
+    return (char *)it - it->node.list->offset;
+}
+
+/// Unchecked variant of @c list_insert.
+/// @warning @c it must be a valid iterator, and @c element must not be in a list.
+static inline struct list_iter *list_insert_unchecked(struct list_iter *it, void *element)
+{
+    struct list *l;
+    struct list_node *link;
+    struct list_node *rhs;
+    struct list_node *lhs;
+
+    list_inline_assert_linked(&it->node);
+    assert(element);
+
+    l = it->node.list;
+    assert(l->size != SIZE_MAX);
+
+    link = (struct list_node *)((char *)element + l->offset);
+    rhs = &it->node;
+    lhs = rhs->prev;
+
+    link->next = rhs;
+    link->prev = lhs;
+    link->list = l;
+
+    rhs->prev = link;
+    lhs->next = link;
+
+    l->size++;
+    l->generation++;
+
+    return (struct list_iter *)link;
+}
+
+/// Unchecked variant of @c list_push_front.
+/// @warning @c l must be a valid list.
+static inline struct list_iter *list_push_front_unchecked(struct list *l, void *element)
+{
+    return list_insert_unchecked((struct list_iter *)l->sentinel.next, element);
+}
+
+/// Unchecked variant of @c list_push_back.
+/// @warning @c l must be a valid list.
+static inline struct list_iter *list_push_back_unchecked(struct list *l, void *element)
+{
+    return list_insert_unchecked((struct list_iter *)&l->sentinel, element);
+}
+
+/// Unlink iterator from its list without validation.
+/// @return Unlinked element.
+/// @warning @c it must be a valid iterator other than @c list_end.
+static inline void *list_unlink_unchecked(struct list_iter *it)
+{
+    void *element;
+    struct list_node *source;
+
+    element = list_at_unchecked(it);
+
+    source = &it->node;
+    source->prev->next = source->next;
+    source->next->prev = source->prev;
+    source->list->size--;
+    source->list->generation++;
+
+    source->next = NULL;
+    source->prev = NULL;
+    source->list = NULL;
+
+    return element;
+}
+
+/// Unchecked variant of @c list_erase.
+/// @warning @c it must be a valid iterator other than @c list_end.
+static inline void list_erase_unchecked(struct list_iter *it, void (*destructor)(void *))
+{
+    void *element = list_unlink_unchecked(it);
+
+    if (destructor) {
+        destructor(element);
+    }
+}
+
+/// Unchecked variant of @c list_pop_front.
+/// @warning @c l must be a valid, non-empty list.
+static inline void *list_pop_front_unchecked(struct list *l)
+{
+    assert(l->size > 0);
+    return list_unlink_unchecked((struct list_iter *)l->sentinel.next);
+}
+
+/// Unchecked variant of @c list_pop_back.
+/// @warning @c l must be a valid, non-empty list.
+static inline void *list_pop_back_unchecked(struct list *l)
+{
+    assert(l->size > 0);
+    return list_unlink_unchecked((struct list_iter *)l->sentinel.prev);
+}
+
+#pragma GCC diagnostic pop
+
+#ifndef LLIST_CHECKED
+# define LLIST_CHECKED 1
+#endif
+
+#if defined(LLIST_INLINE) && !LLIST_CHECKED
+# define list_begin(l)               ((struct list_iter *)(l)->sentinel.next)
+# define list_cbegin(l)              ((const struct list_iter *)(l)->sentinel.next)
+# define list_end(l)                 ((struct list_iter *)&(l)->sentinel)
+# define list_cend(l)                ((const struct list_iter *)&(l)->sentinel)
+# define list_next(it)               list_next_unchecked(it)
+# define list_prev(it)               list_prev_unchecked(it)
+# define list_at(it)                 list_at_unchecked(it)
+# define list_insert(it, element)    list_insert_unchecked(it, element)
+# define list_push_front(l, element) list_push_front_unchecked(l, element)
+# define list_push_back(l, element)  list_push_back_unchecked(l, element)
+# define list_pop_front(l)           list_pop_front_unchecked(l)
+# define list_pop_back(l)            list_pop_back_unchecked(l)
+#elif defined(LLIST_INLINE)
+# define list_begin(l)               list_inline_begin(l)
+# define list_cbegin(l)              list_inline_cbegin(l)
+# define list_end(l)                 list_inline_end(l)
+# define list_cend(l)                list_inline_cend(l)
+# define list_next(it)               list_inline_next(it)
+# define list_cnext(it)              list_inline_cnext(it)
+# define list_prev(it)               list_inline_prev(it)
+# define list_cprev(it)              list_inline_cprev(it)
+# define list_at(it)                 list_inline_at(it)
+# define list_at_const(it)           list_inline_at_const(it)
+# define list_insert(it, element)    list_inline_insert(it, element)
+# define list_push_front(l, element) list_inline_push_front(l, element)
+# define list_push_back(l, element)  list_inline_push_back(l, element)
+# define list_pop_front(l)           list_inline_pop_front(l)
+# define list_pop_back(l)            list_inline_pop_back(l)
+#endif
+
+#endif
@@ -0,0 +1,147 @@
+#pragma once
+
+// Private API.
+// Hash map from list nodes to values, for side structures attached to a list.
+// @see llist_index.c, llist_order.c.
+
+#include "llist.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// Open-addressing slot; a NULL @c key marks an empty slot.
+struct list_map_slot {
+    const struct list_node *key;
+    uint64_t value;
+};
+
+/// Linear-probing hash map, kept at most half full.
+struct list_map {
+    struct list_map_slot *slots;
+    size_t mask;
+    size_t count;
+};
+
+static inline size_t list_map_hash(const struct list_map *map, const struct list_node *key)
+{
+    uint64_t h = (uint64_t)(uintptr_t)key * UINT64_C(0x9E3779B97F4A7C15);
+    return (size_t)(h ^ (h >> 32)) & map->mask;
+}
+
+/// @return Slot holding @c key, or the empty slot where it belongs.
+static inline size_t list_map_probe(const struct list_map *map, const struct list_node *key)
+{
+    size_t i = list_map_hash(map, key);
+
+    while (map->slots[i].key && map->slots[i].key != key) {
+        i = (i + 1) & map->mask;
+    }
+
+    return i;
+}
+
+/// Empty the map, and make room for @c n keys.
+/// @return Zero on success, negative errno otherwise.
+static inline int list_map_reset(struct list_map *map, size_t n)
+{
+    size_t capacity = 16;
+
+    while (capacity / 2 < n) {
+        capacity *= 2;
+    }
+
+    if (capacity > map->mask + 1 || !map->slots) {
+        struct list_map_slot *slots = calloc(capacity, sizeof(struct list_map_slot));
+        if (!slots) {
+            return -ENOMEM;
+        }
+
+        free(map->slots);
+        map->slots = slots;
+        map->mask = capacity - 1;
+    } else {
+        memset(map->slots, 0, (map->mask + 1) * sizeof(struct list_map_slot));
+    }
+
+    map->count = 0;
+    return 0;
+}
+
+/// Map @c key to @c value, growing the table if necessary.
+/// @pre @c key is absent.
+/// @return Zero on success, negative errno otherwise.
+static inline int list_map_insert(struct list_map *map, const struct list_node *key, uint64_t value)
+{
+    size_t i;
+
+    if ((map->count + 1) * 2 > map->mask + 1) {
+        struct list_map_slot *old = map->slots;
+        size_t capacity = map->mask + 1;
+
+        map->slots = calloc(capacity * 2, sizeof(struct list_map_slot));
+        if (!map->slots) {
+            map->slots = old;
+            return -ENOMEM;
+        }
+
+        map->mask = capacity * 2 - 1;
+        for (size_t j = 0; j < capacity; j++) {
+            if (old[j].key) {
+                map->slots[list_map_probe(map, old[j].key)] = old[j];
+            }
+        }
+        free(old);
+    }
+
+    i = list_map_probe(map, key);
+    map->slots[i].key = key;
+    map->slots[i].value = value;
+    map->count++;
+    return 0;
+}
+
+/// @return Pointer to the value of @c key, or NULL if absent.
+static inline uint64_t *list_map_find(const struct list_map *map, const struct list_node *key)
+{
+    size_t i = list_map_probe(map, key);
+    return map->slots[i].key ? &map->slots[i].value : NULL;
+}
+
+/// Remove @c key, shifting back later entries of its probe sequence.
+/// @pre @c key is present.
+static inline void list_map_remove(struct list_map *map, const struct list_node *key)
+{
+    size_t i = list_map_probe(map, key);
+    size_t j = i;
+
+    for (;;) {
+        size_t home;
+
+        j = (j + 1) & map->mask;
+        if (!map->slots[j].key) {
+            break;
+        }
+
+        // Entry @c j stays if its home lies cyclically in (i, j].
+        home = list_map_hash(map, map->slots[j].key);
+        if (i <= j ? (i < home && home <= j) : (i < home || home <= j)) {
+            continue;
+        }
+
+        map->slots[i] = map->slots[j];
+        i = j;
+    }
+
+    map->slots[i].key = NULL;
+    map->count--;
+}
+
+static inline void list_map_free(struct list_map *map)
+{
+    free(map->slots);
+    map->slots = NULL;
+    map->mask = 0;
+    map->count = 0;
+}
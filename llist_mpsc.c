@@ -0,0 +1,200 @@
+#include "llist_mpsc.h"
+#include "llist_inline.h"
+
+#include <errno.h>
+#include <stdlib.h>
+
+// The embedded list_node fields are plain pointers, so they are accessed with the GCC atomic builtins rather than
+// C11 _Atomic types. Only @c next is used while an element is queued.
+
+struct list_mpsc {
+    /// Producers append at @c head; the consumer removes at @c tail.
+    ///
+    ///     +----+    +------+         +------+
+    ///     |tail|--->| node |-->...-->| head |---> NULL
+    ///     +----+    +------+         +------+
+    ///
+    /// The @c stub node keeps the chain non-empty: when the consumer would otherwise remove the last node, it pushes
+    /// @c stub behind it first, so that producers always have a predecessor to link to.
+    struct list_node *head;
+    /// Keeps @c tail, which only the consumer uses, off the cache line that producers contend for.
+    char pad[64 - sizeof(struct list_node *)];
+    struct list_node *tail;
+    struct list_node stub;
+    size_t offset;
+};
+
+struct list_mpsc *list_mpsc_new(size_t offset)
+{
+    struct list_mpsc *q;
+
+    if ((offset % sizeof(void *)) != 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    q = calloc(1, sizeof(struct list_mpsc));
+    if (!q) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    q->head = &q->stub;
+    q->tail = &q->stub;
+    q->offset = offset;
+    return q;
+}
+
+static void *impl_element(const struct list_mpsc *q, struct list_node *node)
+{
+    return (char *)node - q->offset;
+}
+
+/// Link @c node at the head: one exchange, then one store.
+/// Between the two, the chain is broken at the previous head; the consumer treats that as a push in progress.
+static void impl_push(struct list_mpsc *q, struct list_node *node)
+{
+    struct list_node *prev;
+
+    __atomic_store_n(&node->next, NULL, __ATOMIC_RELAXED);
+    prev = __atomic_exchange_n(&q->head, node, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+}
+
+/// Unlink the oldest node.
+/// @return Node on success, NULL with errno set to ENOENT or EAGAIN otherwise.
+static struct list_node *impl_pop(struct list_mpsc *q)
+{
+    struct list_node *tail = q->tail;
+    struct list_node *next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+
+    if (tail == &q->stub) {
+        if (!next) {
+            errno = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE) == &q->stub ? ENOENT : EAGAIN;
+            return NULL;
+        }
+
+        // Skip the stub.
+        q->tail = next;
+        tail = next;
+        next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+    }
+
+    if (!next && tail == __atomic_load_n(&q->head, __ATOMIC_ACQUIRE)) {
+        // tail is the last node: queue the stub behind it, so that tail can be removed.
+        impl_push(q, &q->stub);
+        next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+    }
+
+    if (next) {
+        q->tail = next;
+        return tail;
+    }
+
+    // A producer has exchanged the head, but not yet linked its node behind tail.
+    errno = EAGAIN;
+    return NULL;
+}
+
+void list_mpsc_delete(struct list_mpsc *q, void (*destructor)(void *))
+{
+    struct list_node *node;
+
+    if (!q) {
+        return;
+    }
+
+    while ((node = impl_pop(q))) {
+        if (destructor) {
+            destructor(impl_element(q, node));
+        }
+    }
+
+    free(q);
+}
+
+bool list_mpsc_empty(const struct list_mpsc *q)
+{
+    const struct list_node *tail;
+
+    if (!q) {
+        return true;
+    }
+
+    tail = q->tail;
+    return tail == &q->stub && !__atomic_load_n(&tail->next, __ATOMIC_ACQUIRE) &&
+           __atomic_load_n(&q->head, __ATOMIC_ACQUIRE) == &q->stub;
+}
+
+int list_mpsc_push(struct list_mpsc *q, void *element)
+{
+    struct list_node *node;
+
+    if (!q || !element) {
+        return -EFAULT;
+    }
+
+    node = (struct list_node *)((char *)element + q->offset);
+    // Mark node as unlinked, for the list API.
+    node->list = NULL;
+    impl_push(q, node);
+    return 0;
+}
+
+void *list_mpsc_pop(struct list_mpsc *q)
+{
+    struct list_node *node;
+
+    if (!q) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    node = impl_pop(q);
+    if (!node) {
+        return NULL;
+    }
+
+    return impl_element(q, node);
+}
+
+ssize_t list_mpsc_drain(struct list_mpsc *q, struct list *l)
+{
+    struct list_node *first = NULL;
+    struct list_node *last = NULL;
+    struct list_node *node;
+    size_t count = 0;
+
+    if (!q || !l) {
+        return -EFAULT;
+    }
+
+    if (l->offset != q->offset) {
+        return -EINVAL;
+    }
+
+    // Build the chain locally, then attach it to l with one update.
+    while (count < SIZE_MAX - l->size && (node = impl_pop(q))) {
+        node->prev = last;
+        node->list = l;
+        if (last) {
+            last->next = node;
+        } else {
+            first = node;
+        }
+        last = node;
+        count++;
+    }
+
+    if (count == 0) {
+        return 0;
+    }
+
+    first->prev = l->sentinel.prev;
+    l->sentinel.prev->next = first;
+    last->next = &l->sentinel;
+    l->sentinel.prev = last;
+    l->size += count;
+    l->generation++;
+    return (ssize_t)count;
+}
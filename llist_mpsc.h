@@ -0,0 +1,75 @@
+#ifndef LIBLIST_LLIST_MPSC_H_
+#define LIBLIST_LLIST_MPSC_H_
+
+/// Multi-producer, single-consumer queue.
+///
+/// Hands elements from any number of producer threads to one consumer thread without locks, reusing the
+/// @c LIST_NODE that elements already embed (after Dmitry Vyukov's intrusive MPSC queue).
+/// Neither push nor pop allocates, and the consumer can move everything queued into a @c struct list in one call.
+///
+/// Example:
+///
+///     struct list_mpsc *q = list_mpsc_new(offsetof(struct my_item, link));
+///     struct list *batch = list_new(offsetof(struct my_item, link));
+///
+///     // Any thread:
+///     list_mpsc_push(q, item);
+///
+///     // Consumer thread:
+///     list_mpsc_drain(q, batch);
+///
+/// Return conventions follow @c llist.h.
+///
+/// @note @c list_mpsc_push is thread-safe and wait-free. All other functions must only be called by a single
+///       consumer thread at a time.
+/// @note Requires the GCC atomic builtins.
+
+#include "llist.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+/// Queue object.
+struct list_mpsc;
+
+/// Constructor.
+/// @see list_new.
+struct list_mpsc *list_mpsc_new(size_t offset) PUBLIC;
+
+/// Destructor.
+/// Calls @c destructor for each queued element, oldest first.
+/// @warning Must not run concurrently with @c list_mpsc_push.
+void list_mpsc_delete(struct list_mpsc *, void (*destructor)(void *)) PUBLIC;
+
+/// Test if the queue is empty.
+/// @return True if the queue is empty or NULL, false otherwise.
+/// @note A push that is still in progress counts as queued.
+bool list_mpsc_empty(const struct list_mpsc *) PUBLIC;
+
+/// Append @c element to the queue.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+/// @note Wait-free: a fixed number of steps, whatever other threads do.
+/// @warning The @c element must not be in a list or queue.
+int list_mpsc_push(struct list_mpsc *, void *element) PUBLIC;
+
+/// Unlink and return the oldest element.
+/// @return Pointer to element on success.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+///   - ENOENT: Queue is empty.
+///   - EAGAIN: The oldest element is still being pushed; retry later.
+/// @note Memory ownership: Caller regains ownership of the element.
+void *list_mpsc_pop(struct list_mpsc *) PUBLIC;
+
+/// Move all queued elements, oldest first, to the end of @c l.
+/// Stops early at an element that is still being pushed, or when @c l cannot grow.
+/// @param l List created with the same offset as the queue.
+/// @return The number of elements moved on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: @c l uses a different offset.
+/// @note Updates @c l once, however many elements move; its positional index and order labels become out of date.
+ssize_t list_mpsc_drain(struct list_mpsc *, struct list *l) PUBLIC;
+
+#endif
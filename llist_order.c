@@ -0,0 +1,256 @@
+#include "llist_order.h"
+#include "llist_inline.h"
+#include "llist_map.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// Labels are in [0, ORDER_MAX).
+#define ORDER_BITS 62
+#define ORDER_MAX ((uint64_t)1 << ORDER_BITS)
+
+/// A label range of 2^i may hold at most ORDER_DENSITY^i nodes before a wider range must be relabelled.
+/// Must lie in (1, 2); lower values relabel wider ranges less often.
+#define ORDER_DENSITY 1.6
+
+/// Order-maintenance labels (Bender et al., "Two simplified algorithms for maintaining order in a list").
+///
+/// Labels increase along the list, so comparing labels compares positions. A new node takes the midpoint of its
+/// neighbours' labels. When they are adjacent, the smallest aligned label range around the insertion point that is
+/// sparse enough is relabelled evenly:
+///
+///     range 2^i:   [ base                          base + 2^i )
+///     labels:        3   4   5   6            ->     0   5   10  15
+///     nodes:         a   b   x   c                   a   b   x   c
+struct list_order {
+    /// Label of each list node.
+    struct list_map labels;
+    /// Value of @c list->generation when the labels last matched the list.
+    size_t generation;
+};
+
+static uint64_t impl_label(const struct list_order *order, const struct list_node *node)
+{
+    return *list_map_find(&order->labels, node);
+}
+
+/// Label @c x, which is followed by unlabelled nodes up to @c after, the next labelled node or the sentinel.
+/// @pre The node preceding @c x is labelled, or the sentinel.
+/// @return Zero on success, negative errno otherwise.
+static int impl_place(struct list *l, struct list_node *x, struct list_node *after)
+{
+    struct list_order *order = l->order;
+    const struct list_node *sentinel = &l->sentinel;
+    struct list_node *left = x;
+    struct list_node *next = after;
+    uint64_t lo = x->prev == sentinel ? 0 : impl_label(order, x->prev) + 1;
+    uint64_t hi = after == sentinel ? ORDER_MAX : impl_label(order, after);
+    uint64_t anchor;
+    double capacity = 1;
+    size_t count = 1;
+    int r;
+
+    r = list_map_insert(&order->labels, x, lo + (hi - lo) / 2);
+    if (r < 0) {
+        return r;
+    }
+
+    if (lo < hi) {
+        // Free label between the neighbours.
+        return 0;
+    }
+
+    anchor = x->prev == sentinel ? hi : lo - 1;
+
+    for (unsigned i = 1; i <= ORDER_BITS; i++) {
+        uint64_t size = (uint64_t)1 << i;
+        uint64_t base = anchor & ~(size - 1);
+
+        // Widen the window to all nodes labelled within [base, base + size).
+        while (left->prev != sentinel && impl_label(order, left->prev) >= base) {
+            left = left->prev;
+            count++;
+        }
+        while (next != sentinel && impl_label(order, next) - base < size) {
+            next = next->next;
+            count++;
+        }
+
+        capacity *= ORDER_DENSITY;
+        if (count <= capacity || i == ORDER_BITS) {
+            uint64_t gap = size / count;
+            uint64_t label = base;
+
+            for (struct list_node *node = left; node != next; node = node == x ? after : node->next) {
+                *list_map_find(&order->labels, node) = label;
+                label += gap;
+            }
+            break;
+        }
+    }
+
+    return 0;
+}
+
+/// Relabel all nodes of @c l evenly.
+/// @return Zero on success, negative errno otherwise.
+static int impl_rebuild(struct list *l)
+{
+    struct list_order *order = l->order;
+    uint64_t gap;
+    uint64_t label;
+    int r;
+
+    r = list_map_reset(&order->labels, l->size);
+    if (r < 0) {
+        return r;
+    }
+
+    gap = ORDER_MAX / ((uint64_t)l->size + 1);
+    label = gap;
+    for (struct list_node *node = l->sentinel.next; node != &l->sentinel; node = node->next) {
+        // Cannot fail; the map was sized above.
+        list_map_insert(&order->labels, node, label);
+        label += gap;
+    }
+
+    order->generation = l->generation;
+    return 0;
+}
+
+bool list_order_current(const struct list *l)
+{
+    return l->order->generation == l->generation;
+}
+
+bool list_order_prepare(struct list *l)
+{
+    return list_order_current(l) || impl_rebuild(l) == 0;
+}
+
+void list_order_linked(struct list *l, struct list_node *node)
+{
+    if (impl_place(l, node, node->next) == 0) {
+        l->order->generation = l->generation;
+    }
+}
+
+void list_order_unlinked(struct list *l, struct list_node *node)
+{
+    list_map_remove(&l->order->labels, node);
+    l->order->generation = l->generation;
+}
+
+void list_order_moved(struct list *l, struct list_node *first, struct list_node *tail)
+{
+    struct list_node *after = tail->next;
+
+    for (struct list_node *node = first; node != after; node = node->next) {
+        list_map_remove(&l->order->labels, node);
+    }
+
+    // Label in order, so that each node is placed after a labelled predecessor.
+    // Cannot fail; as many labels were just removed, so the map does not grow.
+    for (struct list_node *node = first; node != after; node = node->next) {
+        impl_place(l, node, after);
+    }
+
+    l->order->generation = l->generation;
+}
+
+void list_order_free(struct list_order *order)
+{
+    if (!order) {
+        return;
+    }
+
+    list_map_free(&order->labels);
+    free(order);
+}
+
+int list_order_enable(struct list *l)
+{
+    int r;
+
+    if (!l) {
+        return -EFAULT;
+    }
+
+    if (l->order) {
+        return 0;
+    }
+
+    l->order = calloc(1, sizeof(struct list_order));
+    if (!l->order) {
+        return -ENOMEM;
+    }
+
+    r = impl_rebuild(l);
+    if (r < 0) {
+        list_order_disable(l);
+        return r;
+    }
+
+    return 0;
+}
+
+int list_order_refresh(struct list *l)
+{
+    if (!l) {
+        return -EFAULT;
+    }
+
+    if (!l->order) {
+        return -EINVAL;
+    }
+
+    if (list_order_current(l)) {
+        return 0;
+    }
+
+    return impl_rebuild(l);
+}
+
+int list_order_disable(struct list *l)
+{
+    if (!l) {
+        return -EFAULT;
+    }
+
+    list_order_free(l->order);
+    l->order = NULL;
+    return 0;
+}
+
+bool list_precedes(const struct list_iter *a, const struct list_iter *b)
+{
+    struct list *l;
+
+    if (!a || !b) {
+        return false;
+    }
+
+    l = list_inline_owner(&a->node);
+    if (!l || list_inline_owner(&b->node) != l || a == b || &a->node == &l->sentinel) {
+        return false;
+    }
+
+    if (&b->node == &l->sentinel) {
+        return true;
+    }
+
+    // Out of date labels are not rebuilt here, so that concurrent readers never write to the list.
+    if (l->order && list_order_current(l)) {
+        return impl_label(l->order, &a->node) < impl_label(l->order, &b->node);
+    }
+
+    // Walk forward from @c a.
+    for (const struct list_node *node = a->node.next; node != &l->sentinel; node = node->next) {
+        if (node == &b->node) {
+            return true;
+        }
+    }
+
+    return false;
+}
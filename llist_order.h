@@ -0,0 +1,31 @@
+#pragma once
+
+// Private API.
+// Order-maintenance label hooks used by llist.c.
+// @see list_order_enable.
+
+#include "llist.h"
+
+#include <stdbool.h>
+
+struct list_order;
+
+/// @return True if the labels of @c l match the list.
+/// Check before a change, then report the change with one of the hooks below to keep the labels current.
+bool list_order_current(const struct list *l);
+
+/// Relabel @c l if its labels are out of date; for use by writers only.
+/// @return True if the labels are current.
+bool list_order_prepare(struct list *l);
+
+/// Record that @c node was linked into @c l.
+void list_order_linked(struct list *l, struct list_node *node);
+
+/// Record that @c node was unlinked from @c l.
+void list_order_unlinked(struct list *l, struct list_node *node);
+
+/// Record that the nodes [@c first, @c tail] were moved, within @c l, to before @c tail->next.
+void list_order_moved(struct list *l, struct list_node *first, struct list_node *tail);
+
+/// Release @c order.
+void list_order_free(struct list_order *order);
@@ -0,0 +1,408 @@
+#include "llist_parallel.h"
+#include "llist_index.h"
+#include "llist_inline.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// Lists shorter than this are sorted by the calling thread alone.
+#define PARALLEL_SORT_MIN_PER_THREAD 1024
+
+/// Lists shorter than this are traversed by the calling thread alone.
+#define PARALLEL_MIN_PER_THREAD 1024
+
+/// Unit of work for one thread.
+struct task {
+    pthread_t thread;
+    bool started;
+    void (*fn)(struct task *);
+    struct list *list;
+    struct list *source;
+    int (*cmp)(const void *, const void *);
+
+    /// Range of @c length nodes starting at @c first, for traversals.
+    struct list_node *first;
+    size_t length;
+    void *ctx;
+    int (*visit)(void *element, void *ctx);
+    bool (*pred)(const void *element, void *ctx);
+    void (*fold)(void *acc, const void *element, void *ctx);
+    void *acc;
+    /// Set when any range stops early.
+    atomic_bool *stop;
+    int result;
+    size_t count;
+};
+
+static void *impl_task_main(void *arg)
+{
+    struct task *task = arg;
+    task->fn(task);
+    return NULL;
+}
+
+/// Run @c n tasks concurrently and wait for completion.
+/// The calling thread runs the first task, and any task that could not be given its own thread.
+static void impl_run(struct task *tasks, size_t n)
+{
+    for (size_t i = 1; i < n; i++) {
+        tasks[i].started = 0 == pthread_create(&tasks[i].thread, NULL, impl_task_main, &tasks[i]);
+    }
+
+    tasks[0].fn(&tasks[0]);
+
+    for (size_t i = 1; i < n; i++) {
+        if (tasks[i].started) {
+            pthread_join(tasks[i].thread, NULL);
+        } else {
+            tasks[i].fn(&tasks[i]);
+        }
+    }
+}
+
+static void impl_sort(struct task *task)
+{
+    list_sort(task->list, task->cmp);
+}
+
+static void impl_merge(struct task *task)
+{
+    list_merge(task->list, task->source, task->cmp);
+}
+
+/// Move @c count nodes starting at @c first to the empty list @c part.
+/// @return Node following the moved nodes.
+static struct list_node *impl_cut(struct list_node *first, size_t count, struct list *part)
+{
+    struct list_node *node = first;
+    struct list_node *last = first;
+
+    for (size_t i = 0; i < count; i++) {
+        node->list = part;
+        last = node;
+        node = node->next;
+    }
+
+    part->sentinel.next = first;
+    part->sentinel.prev = last;
+    first->prev = &part->sentinel;
+    last->next = &part->sentinel;
+    part->size = count;
+
+    return node;
+}
+
+int list_sort_parallel(struct list *l, int (*cmp)(const void *, const void *), size_t nthreads)
+{
+    struct list **parts;
+    struct task *tasks;
+    struct list_node *node;
+    struct list_node *last;
+    size_t n;
+    size_t chunk;
+    size_t remain;
+    int r = 0;
+
+    if (!l || !cmp) {
+        return -EFAULT;
+    }
+
+    if (nthreads == 0) {
+        return -EINVAL;
+    }
+
+    n = l->size / PARALLEL_SORT_MIN_PER_THREAD;
+    if (n > nthreads) {
+        n = nthreads;
+    }
+
+    if (n < 2) {
+        return list_sort(l, cmp);
+    }
+
+    tasks = calloc(n, sizeof(*tasks));
+    parts = calloc(n, sizeof(*parts));
+    if (!tasks || !parts) {
+        r = -ENOMEM;
+        goto out;
+    }
+
+    // The first part is @c l itself.
+    parts[0] = l;
+    for (size_t i = 1; i < n; i++) {
+        parts[i] = list_new(l->offset);
+        if (!parts[i]) {
+            r = -ENOMEM;
+            goto out;
+        }
+    }
+
+    // Cut the list in one pass: the first chunk stays in @c l, the remaining chunks move to their own lists.
+    chunk = l->size / n;
+    node = l->sentinel.next;
+    for (size_t i = 0; i < chunk; i++) {
+        node = node->next;
+    }
+
+    last = node->prev;
+    remain = l->size - chunk;
+    for (size_t i = 1; i < n; i++) {
+        size_t count = (i == n - 1) ? remain : chunk;
+        node = impl_cut(node, count, parts[i]);
+        remain -= count;
+    }
+
+    last->next = &l->sentinel;
+    l->sentinel.prev = last;
+    l->size = chunk;
+    l->generation++;
+
+    for (size_t i = 0; i < n; i++) {
+        tasks[i].fn = impl_sort;
+        tasks[i].list = parts[i];
+        tasks[i].cmp = cmp;
+    }
+    impl_run(tasks, n);
+
+    // Merge neighbouring parts pairwise; lower parts precede higher parts, which keeps the merge stable.
+    for (size_t step = 1; step < n; step *= 2) {
+        size_t m = 0;
+
+        for (size_t i = 0; i + step < n; i += 2 * step) {
+            tasks[m].fn = impl_merge;
+            tasks[m].list = parts[i];
+            tasks[m].source = parts[i + step];
+            tasks[m].cmp = cmp;
+            m++;
+        }
+        impl_run(tasks, m);
+    }
+
+out:
+    if (parts) {
+        for (size_t i = 1; i < n; i++) {
+            list_delete(parts[i], NULL);
+        }
+    }
+    free(parts);
+    free(tasks);
+    return r;
+}
+
+/// Allocate tasks for traversing @c l with up to @c nthreads threads, and give each a contiguous range.
+/// Ranges are found with the positional index if it is current, otherwise with one pass over the list.
+/// @return Array of @c *n tasks, or NULL if out of memory.
+static struct task *impl_partition(struct list *l, size_t nthreads, size_t *n)
+{
+    struct task *tasks;
+    struct list_node *node;
+    bool indexed;
+    size_t chunk;
+    size_t extra;
+    size_t pos = 0;
+
+    *n = l->size / PARALLEL_MIN_PER_THREAD;
+    if (*n > nthreads) {
+        *n = nthreads;
+    }
+    if (*n == 0) {
+        *n = 1;
+    }
+
+    tasks = calloc(*n, sizeof(*tasks));
+    if (!tasks) {
+        return NULL;
+    }
+
+    indexed = l->index && list_index_current(l);
+    chunk = l->size / *n;
+    extra = l->size % *n;
+    node = l->sentinel.next;
+
+    for (size_t i = 0; i < *n; i++) {
+        tasks[i].list = l;
+        tasks[i].first = node;
+        tasks[i].length = chunk + (i < extra);
+        pos += tasks[i].length;
+
+        if (indexed) {
+            node = &list_nth(l, pos)->node;
+        } else {
+            for (size_t k = 0; k < tasks[i].length; k++) {
+                node = node->next;
+            }
+        }
+    }
+
+    return tasks;
+}
+
+static void *impl_element(const struct task *task, struct list_node *node)
+{
+    return (char *)node - task->list->offset;
+}
+
+static void impl_for_each(struct task *task)
+{
+    struct list_node *node = task->first;
+
+    for (size_t i = 0; i < task->length; i++) {
+        if (atomic_load_explicit(task->stop, memory_order_relaxed)) {
+            break;
+        }
+
+        task->result = task->visit(impl_element(task, node), task->ctx);
+        if (task->result) {
+            atomic_store_explicit(task->stop, true, memory_order_relaxed);
+            break;
+        }
+
+        node = node->next;
+    }
+}
+
+static void impl_count_if(struct task *task)
+{
+    struct list_node *node = task->first;
+
+    for (size_t i = 0; i < task->length; i++) {
+        task->count += task->pred(impl_element(task, node), task->ctx);
+        node = node->next;
+    }
+}
+
+static void impl_reduce(struct task *task)
+{
+    struct list_node *node = task->first;
+
+    for (size_t i = 0; i < task->length; i++) {
+        task->fold(task->acc, impl_element(task, node), task->ctx);
+        node = node->next;
+    }
+}
+
+int list_parallel_for_each(struct list *l, int (*fn)(void *element, void *ctx), void *ctx, size_t nthreads)
+{
+    struct task *tasks;
+    atomic_bool stop = false;
+    size_t n;
+    int r = 0;
+
+    if (!l || !fn) {
+        return -EFAULT;
+    }
+
+    if (nthreads == 0) {
+        return -EINVAL;
+    }
+
+    tasks = impl_partition(l, nthreads, &n);
+    if (!tasks) {
+        return -ENOMEM;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        tasks[i].fn = impl_for_each;
+        tasks[i].visit = fn;
+        tasks[i].ctx = ctx;
+        tasks[i].stop = &stop;
+    }
+    impl_run(tasks, n);
+
+    for (size_t i = 0; i < n && !r; i++) {
+        r = tasks[i].result;
+    }
+
+    free(tasks);
+    return r;
+}
+
+int list_parallel_reduce(struct list *l, void *acc, size_t size,
+                         void (*fold)(void *acc, const void *element, void *ctx),
+                         void (*combine)(void *acc, const void *other, void *ctx),
+                         void *ctx, size_t nthreads)
+{
+    struct task *tasks;
+    char *partial = NULL;
+    size_t n;
+
+    if (!l || !acc || !fold || !combine) {
+        return -EFAULT;
+    }
+
+    if (size == 0 || nthreads == 0) {
+        return -EINVAL;
+    }
+
+    tasks = impl_partition(l, nthreads, &n);
+    if (!tasks) {
+        return -ENOMEM;
+    }
+
+    // The first range folds into @c acc itself; the others into copies of its initial value.
+    if (n > 1) {
+        partial = malloc((n - 1) * size);
+        if (!partial) {
+            free(tasks);
+            return -ENOMEM;
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        tasks[i].fn = impl_reduce;
+        tasks[i].fold = fold;
+        tasks[i].ctx = ctx;
+        tasks[i].acc = i == 0 ? acc : partial + (i - 1) * size;
+        if (i > 0) {
+            memcpy(tasks[i].acc, acc, size);
+        }
+    }
+    impl_run(tasks, n);
+
+    for (size_t i = 1; i < n; i++) {
+        combine(acc, tasks[i].acc, ctx);
+    }
+
+    free(partial);
+    free(tasks);
+    return 0;
+}
+
+ssize_t list_parallel_count_if(struct list *l, bool (*pred)(const void *element, void *ctx), void *ctx,
+                               size_t nthreads)
+{
+    struct task *tasks;
+    size_t count = 0;
+    size_t n;
+
+    if (!l || !pred) {
+        return -EFAULT;
+    }
+
+    if (nthreads == 0) {
+        return -EINVAL;
+    }
+
+    tasks = impl_partition(l, nthreads, &n);
+    if (!tasks) {
+        return -ENOMEM;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        tasks[i].fn = impl_count_if;
+        tasks[i].pred = pred;
+        tasks[i].ctx = ctx;
+    }
+    impl_run(tasks, n);
+
+    for (size_t i = 0; i < n; i++) {
+        count += tasks[i].count;
+    }
+
+    free(tasks);
+    return (ssize_t)count;
+}
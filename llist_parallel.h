@@ -0,0 +1,77 @@
+#ifndef LIBLIST_LLIST_PARALLEL_H_
+#define LIBLIST_LLIST_PARALLEL_H_
+
+/// Multi-threaded list algorithms.
+///
+/// Functions in this module partition a list into contiguous sublists and process them concurrently on POSIX
+/// threads created for the duration of the call.
+///
+/// @note Link with @c -pthread.
+/// @note The list must not be accessed by other threads during the call.
+
+#include "llist.h"
+
+/// Sort elements using up to @c nthreads threads.
+/// The list is cut into per-thread sublists in one pass, each sublist is sorted concurrently with @c list_sort,
+/// and the sorted sublists are merged pairwise in parallel with @c list_merge.
+/// The result is identical to @c list_sort: the sort is stable.
+/// @param cmp Comparison function, as for @c list_sort; it is called concurrently from multiple threads.
+/// @param nthreads Maximum number of threads, including the calling thread.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: @c nthreads is zero.
+///   - ENOMEM: Insufficient memory; the list is unchanged.
+/// @note If a thread cannot be created its work is done by the calling thread.
+/// @note Does not invalidate existing iterators; they continue to reference the same elements.
+/// @note Complexity: O(n log n) work, O((n / nthreads) log n + n) span.
+int list_sort_parallel(struct list *, int (*cmp)(const void *, const void *), size_t nthreads) PUBLIC;
+
+/// Call @c fn for each element, using up to @c nthreads threads.
+/// The list is partitioned into contiguous ranges of nearly equal size, one per thread; each range is visited from
+/// first to last. Partitioning costs one pass over the list, or O(nthreads log n) with a current positional index.
+/// @param fn Function called with each element and @c ctx; it is called concurrently from multiple threads. A
+///           non-zero return value stops the traversal of every range.
+/// @param nthreads Maximum number of threads, including the calling thread.
+/// @return Zero on success, or a non-zero value returned by @c fn; if several ranges stop, the value from the range
+///         nearest the front of the list.
+/// @return Negative errno on failure:
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: @c nthreads is zero.
+///   - ENOMEM: Insufficient memory; no element was visited.
+/// @note @c fn must not modify the list.
+/// @note If a thread cannot be created its range is visited by the calling thread.
+/// @note Complexity: O(n) work, O(n / nthreads) span plus partitioning.
+int list_parallel_for_each(struct list *, int (*fn)(void *element, void *ctx), void *ctx, size_t nthreads) PUBLIC;
+
+/// Fold all elements into @c acc, using up to @c nthreads threads.
+/// Each range is folded into its own copy of the initial value of @c acc, and the partial results are then
+/// combined into @c acc in list order. The result equals a sequential fold if @c combine is associative and the
+/// initial value of @c acc is its identity.
+/// @param acc Accumulator of @c size bytes, holding the identity value on entry and the result on return.
+/// @param fold Function that adds @c element to @c acc; it is called concurrently, on distinct accumulators.
+/// @param combine Function that adds the partial result @c other to @c acc; called by the calling thread only.
+/// @param nthreads Maximum number of threads, including the calling thread.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: @c size or @c nthreads is zero.
+///   - ENOMEM: Insufficient memory; @c acc is unchanged.
+/// @note If a thread cannot be created its range is folded by the calling thread.
+/// @note Complexity: O(n) work, O(n / nthreads + nthreads) span plus partitioning.
+/// @see list_parallel_for_each.
+int list_parallel_reduce(struct list *, void *acc, size_t size,
+                         void (*fold)(void *acc, const void *element, void *ctx),
+                         void (*combine)(void *acc, const void *other, void *ctx),
+                         void *ctx, size_t nthreads) PUBLIC;
+
+/// Count the elements for which @c pred returns true, using up to @c nthreads threads.
+/// @param pred Predicate called with each element and @c ctx; it is called concurrently from multiple threads.
+/// @param nthreads Maximum number of threads, including the calling thread.
+/// @return Number of matching elements on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: @c nthreads is zero.
+///   - ENOMEM: Insufficient memory.
+/// @see list_parallel_for_each.
+ssize_t list_parallel_count_if(struct list *, bool (*pred)(const void *element, void *ctx), void *ctx,
+                               size_t nthreads) PUBLIC;
+
+#endif
@@ -0,0 +1,152 @@
+#include "llist_pool.h"
+#include "llist_inline.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// Each slab starts with a header, and is aligned to its size so that the header can be found from any element.
+///
+///     +------+---------+---------+-----+---------+
+///     | slab | element | element | ... | element |
+///     +------+---------+---------+-----+---------+
+///     ^
+///     element & ~(LIST_POOL_SLAB_SIZE - 1)
+struct slab {
+    struct list_pool *pool;
+    struct slab *next;
+};
+
+/// Header size, rounded so that elements are pointer aligned.
+#define SLAB_HEADER ((sizeof(struct slab) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+
+/// Free elements hold a link to the next free element.
+struct free_element {
+    struct free_element *next;
+};
+
+struct list_pool {
+    struct slab *slabs;
+    struct free_element *free;
+    /// Unused space in the newest slab.
+    char *cursor;
+    char *limit;
+    size_t element_size;
+};
+
+struct list_pool *list_pool_new(size_t element_size)
+{
+    struct list_pool *pool;
+
+    if (element_size == 0 || element_size > LIST_POOL_SLAB_SIZE - SLAB_HEADER) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    pool = calloc(1, sizeof(struct list_pool));
+    if (!pool) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    pool->element_size = (element_size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+    return pool;
+}
+
+void list_pool_delete(struct list_pool *pool)
+{
+    if (!pool) {
+        return;
+    }
+
+    while (pool->slabs) {
+        struct slab *next = pool->slabs->next;
+        free(pool->slabs);
+        pool->slabs = next;
+    }
+
+    free(pool);
+}
+
+/// Add a slab to the pool.
+/// @return Zero on success, negative errno otherwise.
+static int impl_grow(struct list_pool *pool)
+{
+    void *memory;
+    struct slab *slab;
+
+    if (posix_memalign(&memory, LIST_POOL_SLAB_SIZE, LIST_POOL_SLAB_SIZE) != 0) {
+        return -ENOMEM;
+    }
+
+    slab = memory;
+    slab->pool = pool;
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+
+    pool->cursor = (char *)slab + SLAB_HEADER;
+    pool->limit = (char *)slab + LIST_POOL_SLAB_SIZE;
+    return 0;
+}
+
+void *list_pool_alloc(struct list_pool *pool)
+{
+    void *element;
+
+    if (!pool) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    if (pool->free) {
+        element = pool->free;
+        pool->free = pool->free->next;
+    } else {
+        if ((size_t)(pool->limit - pool->cursor) < pool->element_size) {
+            int r = impl_grow(pool);
+            if (r < 0) {
+                errno = -r;
+                return NULL;
+            }
+        }
+
+        element = pool->cursor;
+        pool->cursor += pool->element_size;
+    }
+
+    memset(element, 0, pool->element_size);
+    return element;
+}
+
+void list_pool_free(void *element)
+{
+    const struct slab *slab;
+    struct free_element *e;
+
+    if (!element) {
+        return;
+    }
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-align"
+    slab = (const struct slab *)((uintptr_t)element & ~(uintptr_t)(LIST_POOL_SLAB_SIZE - 1));
+    e = (struct free_element *)element;
+#pragma GCC diagnostic pop
+
+    e->next = slab->pool->free;
+    slab->pool->free = e;
+}
+
+void list_pool_release(struct list_pool *pool, struct list *l)
+{
+    if (l) {
+        // Forget the elements; their memory is released with the slabs.
+        l->sentinel.next = &l->sentinel;
+        l->sentinel.prev = &l->sentinel;
+        l->size = 0;
+        list_delete(l, NULL);
+    }
+
+    list_pool_delete(pool);
+}
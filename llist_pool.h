@@ -0,0 +1,68 @@
+#ifndef LIBLIST_LLIST_POOL_H_
+#define LIBLIST_LLIST_POOL_H_
+
+/// Fixed-size element pool.
+///
+/// Carves elements of one size out of large slabs, and recycles freed elements through an intrusive free list.
+/// Elements of one list are thereby packed densely in memory, and allocation and release are O(1) without
+/// calling malloc.
+///
+/// Example:
+///
+///     struct list_pool *pool = list_pool_new(sizeof(struct my_item));
+///     struct list *l = list_new(offsetof(struct my_item, link));
+///
+///     list_push_back(l, list_pool_alloc(pool));
+///     list_erase(list_begin(l), list_pool_free);
+///
+///     list_pool_release(pool, l);
+///
+/// Return conventions follow @c llist.h.
+/// This library is **not** thread-safe.
+
+#include "llist.h"
+
+#include <stddef.h>
+
+/// Pool object.
+struct list_pool;
+
+/// Slab size in bytes.
+/// Slabs are aligned to their size, so that @c list_pool_free can find the owning pool from the element address.
+#define LIST_POOL_SLAB_SIZE ((size_t)64 * 1024)
+
+/// Constructor.
+/// @param element_size Size of each element; rounded up to a multiple of sizeof(void*).
+/// @return Pointer to pool on success.
+/// @return NULL on failure, and errno is set to:
+///   - EINVAL: @c element_size is zero, or too large to fit in a slab.
+///   - ENOMEM: Insufficient memory.
+/// @note Elements are aligned to sizeof(void*).
+/// @note Memory ownership: Caller must list_pool_delete() or list_pool_release() the returned pointer.
+struct list_pool *list_pool_new(size_t element_size) PUBLIC;
+
+/// Destructor.
+/// Releases all slabs, and therefore all elements, whether or not they were freed.
+void list_pool_delete(struct list_pool *) PUBLIC;
+
+/// Allocate a zero-filled element.
+/// @return Pointer to element on success.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+///   - ENOMEM: Insufficient memory.
+/// @note Complexity: O(1).
+void *list_pool_alloc(struct list_pool *) PUBLIC;
+
+/// Return an element to the pool it was allocated from.
+/// The signature matches the @c destructor argument of @c list_erase, @c list_clear and @c list_delete.
+/// @param element Element from @c list_pool_alloc, or NULL.
+/// @note Complexity: O(1).
+void list_pool_free(void *element) PUBLIC;
+
+/// Delete @c list and the pool without visiting the elements.
+/// All slabs are released at once instead of freeing each element.
+/// @warning Every element in @c list must have been allocated from @c pool.
+/// @note Invalidates all iterators of @c list, and all elements of @c pool.
+void list_pool_release(struct list_pool *, struct list *) PUBLIC;
+
+#endif
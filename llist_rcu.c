@@ -0,0 +1,482 @@
+#include "llist_rcu.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#if defined(__linux__)
+# include <linux/membarrier.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+// Grace periods.
+//
+// A global counter @c g_gp only grows. A reader entering its outermost critical section copies the counter into its
+// record; leaving, it stores zero. To retire a node, the writer unlinks it, then increments the counter to G: any
+// reader whose record is zero or at least G entered after the unlink and cannot reach the node. The node is freed
+// once every record qualifies.
+//
+// The reader loads the counter with acquire, pairing with the release of the writer's increment: a reader that sees G
+// also sees the unlink before it. The reader's store must in turn be ordered before its subsequent loads of list
+// links. Rather than a fence on every read lock, the writer issues membarrier(), which runs a full barrier on every
+// thread of the process; readers then only need a compiler barrier. Without membarrier both sides fall back to fences.
+// ThreadSanitizer does not support standalone fences, so under it both sides use seq_cst read-modify-writes instead.
+
+#if defined(__SANITIZE_THREAD__)
+# define LLIST_RCU_TSAN
+#elif defined(__has_feature)
+# if __has_feature(thread_sanitizer)
+#  define LLIST_RCU_TSAN
+# endif
+#endif
+
+/// Per-thread reader record.
+/// Records are never freed; a record released by a thread is reused by the next thread to register.
+struct rcu_reader {
+    /// Counter snapshot while inside a critical section, zero otherwise.
+    atomic_ulong ctr;
+    atomic_bool in_use;
+    /// Nesting depth; only accessed by the owning thread.
+    unsigned nest;
+    struct rcu_reader *next;
+};
+
+/// Deferred destruction record.
+struct rcu_retired {
+    struct rcu_retired *next;
+    struct list_node *node;
+    void *element;
+    void (*destructor)(void *);
+    unsigned long gp;
+};
+
+static atomic_ulong g_gp = 1;
+static _Atomic(struct rcu_reader *) g_readers;
+
+/// Retired nodes, newest first.
+static pthread_mutex_t g_retired_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct rcu_retired *g_retired;
+
+static pthread_once_t g_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_key;
+static bool g_membarrier;
+static _Thread_local struct rcu_reader *t_reader;
+
+/// Release the record of an exiting thread.
+static void impl_release(void *record)
+{
+    struct rcu_reader *self = record;
+
+    atomic_store_explicit(&self->ctr, 0, memory_order_release);
+    atomic_store(&self->in_use, false);
+}
+
+static void impl_init(void)
+{
+    pthread_key_create(&g_key, impl_release);
+
+#if defined(__linux__) && defined(MEMBARRIER_CMD_PRIVATE_EXPEDITED)
+    {
+        long cmds = syscall(__NR_membarrier, MEMBARRIER_CMD_QUERY, 0, 0);
+        g_membarrier = cmds >= 0 && (cmds & MEMBARRIER_CMD_PRIVATE_EXPEDITED) &&
+                       syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+    }
+#endif
+}
+
+/// Store @c gp in this reader's record, ordered before its following loads; the cheap side of the pairing.
+static void impl_reader_announce(struct rcu_reader *self, unsigned long gp)
+{
+#if defined(LLIST_RCU_TSAN)
+    atomic_exchange_explicit(&self->ctr, gp, memory_order_seq_cst);
+#else
+    atomic_store_explicit(&self->ctr, gp, memory_order_relaxed);
+    if (g_membarrier) {
+        atomic_signal_fence(memory_order_seq_cst);
+    } else {
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+#endif
+}
+
+/// Run a full barrier on every thread; the expensive side of the pairing.
+static void impl_writer_fence(void)
+{
+#if defined(LLIST_RCU_TSAN)
+    atomic_fetch_add_explicit(&g_gp, 0, memory_order_seq_cst);
+#else
+# if defined(__linux__) && defined(MEMBARRIER_CMD_PRIVATE_EXPEDITED)
+    if (g_membarrier) {
+        syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+        return;
+    }
+# endif
+    atomic_thread_fence(memory_order_seq_cst);
+#endif
+}
+
+int list_rcu_register(void)
+{
+    struct rcu_reader *self;
+
+    if (t_reader) {
+        return 0;
+    }
+
+    pthread_once(&g_once, impl_init);
+
+    for (self = atomic_load(&g_readers); self; self = self->next) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&self->in_use, &expected, true)) {
+            break;
+        }
+    }
+
+    if (!self) {
+        self = calloc(1, sizeof(struct rcu_reader));
+        if (!self) {
+            return -ENOMEM;
+        }
+
+        atomic_init(&self->in_use, true);
+        self->next = atomic_load(&g_readers);
+        while (!atomic_compare_exchange_weak(&g_readers, &self->next, self)) {
+        }
+    }
+
+    pthread_setspecific(g_key, self);
+    t_reader = self;
+    return 0;
+}
+
+void list_rcu_unregister(void)
+{
+    if (!t_reader) {
+        return;
+    }
+
+    pthread_setspecific(g_key, NULL);
+    impl_release(t_reader);
+    t_reader = NULL;
+}
+
+void list_rcu_read_lock(void)
+{
+    struct rcu_reader *self = t_reader;
+
+    if (self->nest++ == 0) {
+        // Acquire pairs with the release in impl_gp_start, so a reader that sees the new counter sees the unlink too.
+        impl_reader_announce(self, atomic_load_explicit(&g_gp, memory_order_acquire));
+    }
+}
+
+void list_rcu_read_unlock(void)
+{
+    struct rcu_reader *self = t_reader;
+
+    if (--self->nest == 0) {
+        // Release: the section's loads complete before the writer can see it has ended.
+        atomic_store_explicit(&self->ctr, 0, memory_order_release);
+    }
+}
+
+/// Start a grace period.
+/// @return Counter value that readers must reach, or leave their sections, for the grace period to end.
+/// @pre The nodes to retire are unlinked; the increment releases the unlink to readers that acquire the new value.
+static unsigned long impl_gp_start(void)
+{
+    return atomic_fetch_add(&g_gp, 1) + 1;
+}
+
+/// @return The oldest counter snapshot among readers inside a critical section, or ULONG_MAX if there are none.
+static unsigned long impl_oldest_reader(void)
+{
+    unsigned long oldest = (unsigned long)-1;
+
+    impl_writer_fence();
+
+    for (struct rcu_reader *r = atomic_load(&g_readers); r; r = r->next) {
+        unsigned long ctr = atomic_load_explicit(&r->ctr, memory_order_acquire);
+        if (ctr != 0 && ctr < oldest) {
+            oldest = ctr;
+        }
+    }
+
+    return oldest;
+}
+
+/// Wait until the grace period @c gp has ended.
+static void impl_gp_wait(unsigned long gp)
+{
+    while (impl_oldest_reader() < gp) {
+        sched_yield();
+    }
+}
+
+/// Destroy retired nodes whose grace period has ended.
+/// @return True if nodes remain to be destroyed.
+static bool impl_reclaim(void)
+{
+    struct rcu_retired *expired = NULL;
+    struct rcu_retired **link;
+    unsigned long oldest = impl_oldest_reader();
+    bool pending;
+
+    pthread_mutex_lock(&g_retired_lock);
+    for (link = &g_retired; *link; link = &(*link)->next) {
+        if ((*link)->gp <= oldest) {
+            // The list is ordered newest first, so the rest of it has expired too.
+            expired = *link;
+            *link = NULL;
+            break;
+        }
+    }
+    pending = g_retired != NULL;
+    pthread_mutex_unlock(&g_retired_lock);
+
+    while (expired) {
+        struct rcu_retired *next = expired->next;
+        struct list_node *node = expired->node;
+
+        // Mark node as unlinked.
+        node->next = NULL;
+        node->prev = NULL;
+        node->list = NULL;
+
+        if (expired->destructor) {
+            expired->destructor(expired->element);
+        }
+        free(expired);
+        expired = next;
+    }
+
+    return pending;
+}
+
+void list_rcu_synchronize(void)
+{
+    while (impl_reclaim()) {
+        sched_yield();
+    }
+}
+
+struct list_iter *list_rcu_insert(struct list_iter *it, void *element)
+{
+    struct list *l;
+    struct list_node *link;
+    struct list_node *rhs;
+    struct list_node *lhs;
+
+    if (!it || !element) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    l = list_inline_owner(&it->node);
+    if (!l) {
+        // Iterator not linked.
+        errno = EINVAL;
+        return NULL;
+    }
+
+    if (l->size == SIZE_MAX) {
+        // Detect pathological overflow case.
+        errno = EOVERFLOW;
+        return NULL;
+    }
+
+    link = (struct list_node *)((char *)element + l->offset);
+    rhs = &it->node;
+    lhs = rhs->prev;
+
+    link->next = rhs;
+    link->prev = lhs;
+    link->list = l;
+
+    rhs->prev = link;
+    // Publish last: readers that reach the node see it fully initialised.
+    __atomic_store_n(&lhs->next, link, __ATOMIC_RELEASE);
+
+    l->size++;
+    l->generation++;
+
+    return (struct list_iter *)link;
+}
+
+struct list_iter *list_rcu_push_front(struct list *l, void *element)
+{
+    return list_rcu_insert(list_begin(l), element);
+}
+
+struct list_iter *list_rcu_push_back(struct list *l, void *element)
+{
+    return list_rcu_insert(list_end(l), element);
+}
+
+int list_rcu_erase(struct list_iter *it, void (*destructor)(void *))
+{
+    struct rcu_retired *record;
+    struct list_node *node;
+    struct list *l;
+
+    if (!it) {
+        return -EFAULT;
+    }
+
+    node = &it->node;
+    l = list_inline_owner(node);
+    if (!l) {
+        // Iterator not linked, or already erased.
+        return -EINVAL;
+    }
+
+    if (node == &l->sentinel) {
+        // Erasing list_end() does not make sense.
+        return -ENOENT;
+    }
+
+    // Allocate up front, so that nothing can fail once the node is unlinked.
+    record = malloc(sizeof(struct rcu_retired));
+    if (!record) {
+        return -ENOMEM;
+    }
+
+    // Readers on the node keep its list and next link, and move on from it as before. Readers never follow prev,
+    // so clearing it marks the node as erased for every other function.
+    __atomic_store_n(&node->prev->next, node->next, __ATOMIC_RELEASE);
+    node->next->prev = node->prev;
+    node->prev = NULL;
+    l->size--;
+    l->generation++;
+
+    record->node = node;
+    record->element = (char *)node - l->offset;
+    record->destructor = destructor;
+
+    pthread_mutex_lock(&g_retired_lock);
+    record->gp = impl_gp_start();
+    record->next = g_retired;
+    g_retired = record;
+    pthread_mutex_unlock(&g_retired_lock);
+
+    impl_reclaim();
+    return 0;
+}
+
+int list_rcu_splice_range(struct list_iter *it, struct list_iter *first, struct list_iter *last)
+{
+    struct list *target;
+    struct list *source;
+    struct list_node *node;
+    struct list_node *head;
+    struct list_node *tail;
+    size_t n = 0;
+
+    if (!it || !first || !last) {
+        return -EFAULT;
+    }
+
+    target = list_inline_owner(&it->node);
+    source = list_inline_owner(&first->node);
+
+    if (!target || !source) {
+        // Iterator not linked.
+        return -EINVAL;
+    }
+
+    if (list_inline_owner(&last->node) != source) {
+        // Range must be within one list.
+        return -EINVAL;
+    }
+
+    if (target->offset != source->offset) {
+        // Elements must embed LIST_NODE at the same offset.
+        return -EINVAL;
+    }
+
+    if (first == last) {
+        // Empty range.
+        return 0;
+    }
+
+    if (first == list_end(source)) {
+        // Disallow list_end() as source.
+        return -ENOENT;
+    }
+
+    if (it == first) {
+        // Disallow inserting before itself.
+        return -EINVAL;
+    }
+
+    if (it == last) {
+        // Range is already positioned before @c it.
+        return 0;
+    }
+
+    head = &first->node;
+
+    if (target != source) {
+        // Verify that @c last follows @c first; ownership is transferred once no reader can observe it.
+        for (node = head; node != &last->node; node = node->next) {
+            if (node == &source->sentinel) {
+                return -EINVAL;
+            }
+            n++;
+        }
+
+        if (target->size > SIZE_MAX - n) {
+            // Detect pathological overflow case.
+            return -EOVERFLOW;
+        }
+    }
+
+    tail = last->node.prev;
+
+    // Unlink [head, tail]. Readers inside the range still leave it through @c last, as before.
+    __atomic_store_n(&head->prev->next, &last->node, __ATOMIC_RELEASE);
+    last->node.prev = head->prev;
+    source->size -= n;
+    source->generation++;
+
+    // Relinking right away could send a reader inside the range to its new position, skipping or repeating elements.
+    impl_gp_wait(impl_gp_start());
+
+    if (target != source) {
+        for (node = head; node != &last->node; node = node->next) {
+            node->list = target;
+        }
+    }
+
+    // Link [head, tail] before @c it; publish last.
+    head->prev = it->node.prev;
+    tail->next = &it->node;
+    __atomic_store_n(&it->node.prev->next, head, __ATOMIC_RELEASE);
+    it->node.prev = tail;
+    target->size += n;
+    target->generation++;
+
+    return 0;
+}
+
+int list_rcu_splice(struct list_iter *iter, struct list_iter *source_iter)
+{
+    struct list *l;
+
+    if (!iter || !source_iter) {
+        return -EFAULT;
+    }
+
+    l = list_inline_owner(&iter->node);
+    if (!l || l != list_inline_owner(&source_iter->node)) {
+        // Iterator not linked, or splice between different lists.
+        return -EINVAL;
+    }
+
+    // The single element is the range [source_iter, next).
+    return list_rcu_splice_range(iter, source_iter, (struct list_iter *)source_iter->node.next);
+}
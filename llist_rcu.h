@@ -0,0 +1,135 @@
+#ifndef LIBLIST_LLIST_RCU_H_
+#define LIBLIST_LLIST_RCU_H_
+
+/// Read-copy-update (RCU) access to a list.
+///
+/// Lets any number of reader threads traverse a @c struct list while one writer changes it, with neither side
+/// taking a lock. Readers pay no atomic read-modify-write and, where the kernel supports @c membarrier, no memory
+/// fence: the writer imposes the ordering on them when it needs it.
+///
+/// Readers:
+///
+///     list_rcu_register();                    // Once per thread.
+///
+///     list_rcu_read_lock();
+///     for (it = list_rcu_cbegin(l); it != list_cend(l); it = list_rcu_cnext(it)) {
+///         use(list_at_const(it));
+///     }
+///     list_rcu_read_unlock();
+///
+/// The writer uses @c list_rcu_insert, @c list_rcu_erase, @c list_rcu_splice and @c list_rcu_splice_range instead
+/// of their plain counterparts. Each publishes its change with release ordering, so that a reader sees either the
+/// old or the new links, and nodes removed from under a reader remain readable until the reader leaves its
+/// read-side critical section (grace period).
+///
+/// Return conventions follow @c llist.h.
+///
+/// @note Only one thread at a time may change the list; writers must be serialised by the caller. The writer may
+///       use every read-only function of @c llist.h.
+/// @note Inside a read-side critical section, use only @c list_rcu_cbegin, @c list_rcu_cnext, @c list_cend and
+///       @c list_at_const: no backward traversal, positional queries or changes.
+/// @note Requires C11 atomics and the GCC atomic builtins.
+
+#include "llist_inline.h"
+
+/// Register the calling thread as a reader. Threads may register again after @c list_rcu_unregister.
+/// @return Zero on success, negative errno otherwise.
+///   - ENOMEM: Insufficient memory.
+/// @note Registering a thread that is already registered has no effect.
+int list_rcu_register(void) PUBLIC;
+
+/// Unregister the calling thread; threads that exit are unregistered automatically.
+/// @warning Must not be called from within a read-side critical section.
+void list_rcu_unregister(void) PUBLIC;
+
+/// Enter a read-side critical section. Sections nest.
+/// @warning The calling thread must be registered.
+void list_rcu_read_lock(void) PUBLIC;
+
+/// Leave a read-side critical section.
+void list_rcu_read_unlock(void) PUBLIC;
+
+/// Get iterator to first element of list, for a reader.
+/// @see list_cbegin.
+static inline const struct list_iter *list_rcu_cbegin(const struct list *l)
+{
+    if (!l) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    // Pairs with the writer's release store: the node is fully initialised before it becomes reachable.
+    return (const struct list_iter *)__atomic_load_n(&l->sentinel.next, __ATOMIC_CONSUME);
+}
+
+/// Forward move iterator, for a reader.
+/// @see list_cnext.
+static inline const struct list_iter *list_rcu_cnext(const struct list_iter *it)
+{
+    if (!it) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    if (!it->node.list) {
+        // Iterator not linked.
+        errno = EINVAL;
+        return NULL;
+    }
+
+    if (&it->node == &it->node.list->sentinel) {
+        errno = ERANGE;
+        return NULL;
+    }
+
+    return (const struct list_iter *)__atomic_load_n(&it->node.next, __ATOMIC_CONSUME);
+}
+
+/// Insert element before iterator, publishing it to readers.
+/// @see list_insert.
+struct list_iter *list_rcu_insert(struct list_iter *, void *element) PUBLIC;
+
+/// Insert element at front of list, publishing it to readers.
+/// @see list_rcu_insert.
+struct list_iter *list_rcu_push_front(struct list *, void *element) PUBLIC;
+
+/// Insert element at end of list, publishing it to readers.
+/// @see list_rcu_insert.
+struct list_iter *list_rcu_push_back(struct list *, void *element) PUBLIC;
+
+/// Remove the element at iterator; call @c destructor for it after a grace period.
+/// Readers already positioned on the element may still read it, and move on from it. Every other function treats it
+/// as not linked, so erasing it again fails with EINVAL.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Iterator invalid, or already erased.
+///   - ENOENT: Iterator @c list_end cannot be erased.
+///   - ENOMEM: Insufficient memory.
+/// @note Does not wait: destruction happens in a later @c list_rcu_erase or @c list_rcu_synchronize call, once
+///       every reader that could hold the element has left its critical section.
+/// @note Memory ownership: If @c destructor is NULL then the caller regains ownership once @c list_rcu_synchronize
+///       returns.
+int list_rcu_erase(struct list_iter *, void (*destructor)(void *)) PUBLIC;
+
+/// Move single element @c source_iter to before @c iter.
+/// @see list_splice.
+/// @note Waits for a grace period between unlinking and relinking the element, so that readers never follow it to
+///       its new position.
+/// @warning For that whole grace period the element is in neither position: readers that start a traversal meanwhile
+///          do not see it at all, and @c list_size does not count it.
+/// @warning Must not be called from within a read-side critical section.
+int list_rcu_splice(struct list_iter *iter, struct list_iter *source_iter) PUBLIC;
+
+/// Move elements in the range [@c first, @c last) to before @c iter.
+/// @see list_splice_range.
+/// @note Waits for a grace period between unlinking and relinking the range; see @c list_rcu_splice.
+/// @warning For that whole grace period the range is invisible to readers of both lists.
+/// @note Complexity: O(k) for k moved elements, plus the grace period.
+/// @warning Must not be called from within a read-side critical section.
+int list_rcu_splice_range(struct list_iter *iter, struct list_iter *first, struct list_iter *last) PUBLIC;
+
+/// Wait for a grace period, then destroy every element erased before the call.
+/// @warning Must not be called from within a read-side critical section.
+void list_rcu_synchronize(void) PUBLIC;
+
+#endif
@@ -0,0 +1,372 @@
+#include "lru.h"
+#include "llist_inline.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// Initial number of hash buckets; a power of two.
+#define LRU_BUCKETS_MIN 16
+
+struct lru {
+    /// Elements, most recently used first.
+    struct list *list;
+    /// Elements being evicted; handed to the eviction callback.
+    struct list *victims;
+    /// Hash index: @c mask + 1 bucket chains, linked through @c lru_node.chain.
+    struct lru_node **buckets;
+    size_t mask;
+    size_t bytes;
+    size_t max_count;
+    size_t max_bytes;
+    size_t offset;
+    size_t (*hash)(const void *);
+    int (*cmp)(const void *, const void *);
+    void (*evict)(struct list *, void *);
+    void *ctx;
+    size_t batch;
+};
+
+struct lru *lru_new(size_t offset, size_t (*hash)(const void *), int (*cmp)(const void *, const void *))
+{
+    struct lru *c;
+
+    if (!hash || !cmp) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    if ((offset % sizeof(void *)) != 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    c = calloc(1, sizeof(struct lru));
+    if (!c) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    c->list = list_new(offset);
+    c->victims = list_new(offset);
+    c->buckets = calloc(LRU_BUCKETS_MIN, sizeof(struct lru_node *));
+    if (!c->list || !c->victims || !c->buckets) {
+        lru_delete(c, NULL);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    c->mask = LRU_BUCKETS_MIN - 1;
+    c->offset = offset;
+    c->hash = hash;
+    c->cmp = cmp;
+    return c;
+}
+
+void lru_delete(struct lru *c, void (*destructor)(void *))
+{
+    if (!c) {
+        return;
+    }
+
+    list_delete(c->list, destructor);
+    list_delete(c->victims, NULL);
+    free(c->buckets);
+    free(c);
+}
+
+size_t lru_size(const struct lru *c)
+{
+    if (!c) {
+        return 0;
+    }
+
+    return list_size(c->list);
+}
+
+size_t lru_bytes(const struct lru *c)
+{
+    if (!c) {
+        return 0;
+    }
+
+    return c->bytes;
+}
+
+static struct lru_node *impl_node(const struct lru *c, const void *element)
+{
+    return (struct lru_node *)((char *)element + c->offset);
+}
+
+static void *impl_element(const struct lru *c, struct lru_node *node)
+{
+    return (char *)node - c->offset;
+}
+
+/// @return Link to the node equal to @c key in its bucket chain, or to the NULL at the end of the chain.
+static struct lru_node **impl_find(const struct lru *c, const void *key, size_t hash)
+{
+    struct lru_node **link = &c->buckets[hash & c->mask];
+
+    while (*link && ((*link)->hash != hash || c->cmp(impl_element(c, *link), key) != 0)) {
+        link = &(*link)->chain;
+    }
+
+    return link;
+}
+
+/// Remove @c node from its bucket chain.
+static void impl_unchain(struct lru *c, struct lru_node *node)
+{
+    struct lru_node **link = &c->buckets[node->hash & c->mask];
+
+    while (*link != node) {
+        link = &(*link)->chain;
+    }
+
+    *link = node->chain;
+    node->chain = NULL;
+}
+
+/// Double the buckets once there are more elements than buckets.
+/// If memory is short the index is left as is; chains just grow longer.
+static void impl_grow(struct lru *c)
+{
+    struct lru_node **buckets;
+    size_t mask = c->mask * 2 + 1;
+
+    if (list_size(c->list) <= c->mask + 1 || mask < c->mask) {
+        return;
+    }
+
+    buckets = calloc(mask + 1, sizeof(struct lru_node *));
+    if (!buckets) {
+        return;
+    }
+
+    for (size_t i = 0; i <= c->mask; i++) {
+        struct lru_node *node = c->buckets[i];
+
+        while (node) {
+            struct lru_node *chain = node->chain;
+            node->chain = buckets[node->hash & mask];
+            buckets[node->hash & mask] = node;
+            node = chain;
+        }
+    }
+
+    free(c->buckets);
+    c->buckets = buckets;
+    c->mask = mask;
+}
+
+/// Evict the @c n least recently used elements, and pass them to the eviction callback.
+static size_t impl_evict(struct lru *c, size_t n)
+{
+    struct list_iter *first = list_end(c->list);
+
+    if (n == 0) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        struct lru_node *node;
+
+        first = list_prev(first);
+        node = impl_node(c, list_at(first));
+        impl_unchain(c, node);
+        c->bytes -= node->charge;
+    }
+
+    list_splice_range(list_end(c->victims), first, list_end(c->list));
+    if (c->evict) {
+        c->evict(c->victims, c->ctx);
+    }
+    list_clear(c->victims, NULL);
+
+    return n;
+}
+
+/// Evict elements in excess of capacity, at least @c batch at a time.
+static void impl_trim(struct lru *c)
+{
+    const struct list_iter *it = list_cend(c->list);
+    size_t count = list_size(c->list);
+    size_t bytes = c->bytes;
+    size_t n = 0;
+
+    if ((!c->max_count || count <= c->max_count) && (!c->max_bytes || bytes <= c->max_bytes)) {
+        return;
+    }
+
+    while (count > 0 && ((c->max_count && count > c->max_count) || (c->max_bytes && bytes > c->max_bytes) ||
+                         n < c->batch)) {
+        it = list_cprev(it);
+        bytes -= impl_node(c, list_at_const(it))->charge;
+        count--;
+        n++;
+    }
+
+    impl_evict(c, n);
+}
+
+int lru_set_capacity(struct lru *c, size_t count, size_t bytes)
+{
+    if (!c) {
+        return -EFAULT;
+    }
+
+    c->max_count = count;
+    c->max_bytes = bytes;
+    impl_trim(c);
+    return 0;
+}
+
+int lru_set_eviction(struct lru *c, void (*evict)(struct list *, void *), void *ctx, size_t batch)
+{
+    if (!c) {
+        return -EFAULT;
+    }
+
+    c->evict = evict;
+    c->ctx = ctx;
+    c->batch = batch;
+    return 0;
+}
+
+/// Move @c node to the front of the recency list.
+static void impl_promote(struct lru *c, struct lru_node *node)
+{
+    struct list_iter *front = list_begin(c->list);
+
+    if (&front->node != &node->link) {
+        list_splice(front, (struct list_iter *)&node->link);
+    }
+}
+
+void *lru_get(struct lru *c, const void *key)
+{
+    struct lru_node *node;
+
+    if (!c || !key) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    node = *impl_find(c, key, c->hash(key));
+    if (!node) {
+        errno = ENOENT;
+        return NULL;
+    }
+
+    impl_promote(c, node);
+    return impl_element(c, node);
+}
+
+void *lru_peek(const struct lru *c, const void *key)
+{
+    struct lru_node *node;
+
+    if (!c || !key) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    node = *impl_find(c, key, c->hash(key));
+    if (!node) {
+        errno = ENOENT;
+        return NULL;
+    }
+
+    return impl_element(c, node);
+}
+
+int lru_put(struct lru *c, void *element, size_t charge)
+{
+    struct lru_node *node;
+    struct lru_node **link;
+    size_t hash;
+
+    if (!c || !element) {
+        return -EFAULT;
+    }
+
+    if (list_size(c->list) == SIZE_MAX || c->bytes > SIZE_MAX - charge) {
+        // Detect pathological overflow case.
+        return -EOVERFLOW;
+    }
+
+    hash = c->hash(element);
+    link = impl_find(c, element, hash);
+    if (*link) {
+        return -EEXIST;
+    }
+
+    node = impl_node(c, element);
+    node->chain = NULL;
+    node->hash = hash;
+    node->charge = charge;
+    *link = node;
+
+    list_push_front(c->list, element);
+    c->bytes += charge;
+
+    impl_grow(c);
+    impl_trim(c);
+    return 0;
+}
+
+int lru_touch(struct lru *c, void *element)
+{
+    struct lru_node *node;
+
+    if (!c || !element) {
+        return -EFAULT;
+    }
+
+    node = impl_node(c, element);
+    if (node->link.list != c->list) {
+        return -EINVAL;
+    }
+
+    impl_promote(c, node);
+    return 0;
+}
+
+void *lru_remove(struct lru *c, const void *key)
+{
+    struct lru_node **link;
+    struct lru_node *node;
+
+    if (!c || !key) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    link = impl_find(c, key, c->hash(key));
+    node = *link;
+    if (!node) {
+        errno = ENOENT;
+        return NULL;
+    }
+
+    *link = node->chain;
+    node->chain = NULL;
+    c->bytes -= node->charge;
+    list_erase((struct list_iter *)&node->link, NULL);
+
+    return impl_element(c, node);
+}
+
+size_t lru_evict(struct lru *c, size_t n)
+{
+    if (!c) {
+        return 0;
+    }
+
+    if (n > list_size(c->list)) {
+        n = list_size(c->list);
+    }
+
+    return impl_evict(c, n);
+}
@@ -0,0 +1,135 @@
+#ifndef LIBLIST_LRU_H_
+#define LIBLIST_LRU_H_
+
+/// Least-recently-used (LRU) cache.
+///
+/// Elements embed @c LRU_NODE, which links them both into a recency list and into a hash index, so that lookup,
+/// insertion and promotion are O(1) and never allocate. When the cache exceeds its capacity, by element count or by
+/// bytes charged, the least recently used elements are evicted and handed to an eviction callback.
+///
+/// Example:
+///
+///     struct my_item {
+///         int key;
+///         LRU_NODE(link);
+///     };
+///
+///     struct lru *cache = lru_new(offsetof(struct my_item, link), hash_key, cmp_key);
+///
+///     lru_set_capacity(cache, 1000, 0);
+///     lru_put(cache, item, 0);
+///     item = lru_get(cache, &(struct my_item){ .key = 42 });
+///
+/// Return conventions follow @c llist.h.
+
+#define LRU_NODE(name) struct lru_node name
+
+#include "llist.h"
+
+#include <stddef.h>
+
+/// LRU cache object.
+/// This library is **not** thread-safe.
+struct lru;
+
+struct lru_node {
+    /// Recency list link; must come first, so that the list offset equals the @c lru_node offset.
+    struct list_node link;
+    /// Next node in the same hash bucket.
+    struct lru_node *chain;
+    /// Cached hash of the element.
+    size_t hash;
+    /// Bytes charged for the element.
+    size_t charge;
+};
+
+/// Constructor.
+/// @param offset The offset to @c lru_node in elements.
+/// @param hash Hash function of an element's key.
+/// @param cmp Comparison function returning zero if two elements have equal keys, non-zero otherwise.
+/// @return Pointer to cache on success.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Offset invalid.
+///   - ENOMEM: Insufficient memory.
+/// @note The cache is unbounded until @c lru_set_capacity is called.
+/// @note Memory ownership: Caller must lru_delete() the returned pointer.
+struct lru *lru_new(size_t offset, size_t (*hash)(const void *), int (*cmp)(const void *, const void *)) PUBLIC;
+
+/// Destructor.
+/// @see list_delete.
+/// @note The eviction callback is not called.
+void lru_delete(struct lru *, void (*destructor)(void *)) PUBLIC;
+
+/// Get number of elements in cache.
+/// @return The number of elements, or zero if NULL.
+size_t lru_size(const struct lru *) PUBLIC;
+
+/// Get bytes charged for elements in cache.
+/// @return Sum of the charges given to @c lru_put, or zero if NULL.
+size_t lru_bytes(const struct lru *) PUBLIC;
+
+/// Set capacity, and evict elements in excess of it.
+/// @param count Maximum number of elements, or zero for no limit.
+/// @param bytes Maximum bytes charged, or zero for no limit.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+int lru_set_capacity(struct lru *, size_t count, size_t bytes) PUBLIC;
+
+/// Set the eviction callback.
+/// Whenever the cache exceeds its capacity, it evicts least recently used elements until it is within capacity and
+/// at least @c batch elements were evicted, and passes them to @c evict in one call, most recently used first.
+/// @param evict Function called with a list of evicted elements and @c ctx; it takes ownership of the elements, and
+///              may remove them from the list. Elements left in the list are unlinked when it returns. May be NULL,
+///              in which case the caller keeps ownership of evicted elements.
+/// @param batch Minimum number of elements to evict at once, or zero; larger batches make eviction less frequent.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+/// @warning @c evict must not access the cache.
+int lru_set_eviction(struct lru *, void (*evict)(struct list *victims, void *ctx), void *ctx, size_t batch) PUBLIC;
+
+/// Look up the element equal to @c key, and mark it most recently used.
+/// @param key Element, or an object of the element type with the key fields set.
+/// @return Pointer to element on success.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+///   - ENOENT: No equal element.
+/// @note Complexity: O(1) expected.
+void *lru_get(struct lru *, const void *key) PUBLIC;
+
+/// Look up the element equal to @c key, without changing its recency.
+/// @see lru_get.
+void *lru_peek(const struct lru *, const void *key) PUBLIC;
+
+/// Insert @c element as most recently used, then evict elements in excess of capacity.
+/// @param charge Bytes charged for the element against the byte capacity.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EEXIST: An equal element is already present.
+///   - EOVERFLOW: Cache cannot grow.
+/// @note An element charged more than the byte capacity is evicted at once.
+/// @note Memory ownership: On success the cache takes ownership of the element, until it is evicted or removed.
+/// @note Complexity: O(1) expected, plus eviction; the hash index occasionally doubles in O(n).
+int lru_put(struct lru *, void *element, size_t charge) PUBLIC;
+
+/// Mark @c element most recently used.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Element not in this cache.
+/// @note Complexity: O(1); needs no lookup.
+int lru_touch(struct lru *, void *element) PUBLIC;
+
+/// Remove the element equal to @c key.
+/// @return Pointer to the removed element on success.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+///   - ENOENT: No equal element.
+/// @note Memory ownership: On success the caller regains ownership of the element.
+void *lru_remove(struct lru *, const void *key) PUBLIC;
+
+/// Evict up to @c n least recently used elements, regardless of capacity.
+/// @return Number of elements evicted; zero if NULL.
+/// @see lru_set_eviction.
+size_t lru_evict(struct lru *, size_t n) PUBLIC;
+
+#endif
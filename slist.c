@@ -0,0 +1,283 @@
+#include "slist.h"
+#include "llist_inline.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+struct slist {
+    /// Uses a dummy 'sentinel' node; the last node links back to it.
+    ///
+    ///     +--------+    +------+         +------+
+    ///     |    next|--->| node |-->...-->| tail |---+
+    ///     |sentinel|    +------+         +------+   |
+    ///     +--------+                                |
+    ///          ^                                    |
+    ///          +------------------------------------+
+    ///
+    /// Linked nodes therefore never have a NULL @c next, which marks unlinked nodes.
+    struct slist_node sentinel;
+    struct slist_node *tail;
+    size_t size;
+    size_t offset;
+};
+
+/// Iterator has the same layout as slist_node.
+struct slist_iter {
+    struct slist_node node;
+};
+
+struct slist *slist_new(size_t offset)
+{
+    struct slist *l;
+
+    if ((offset % sizeof(void *)) != 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    l = calloc(1, sizeof(struct slist));
+    if (!l) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    l->sentinel.next = &l->sentinel;
+    l->tail = &l->sentinel;
+    l->offset = offset;
+    return l;
+}
+
+void slist_delete(struct slist *l, void (*destructor)(void *))
+{
+    if (!l) {
+        return;
+    }
+
+    slist_clear(l, destructor);
+    free(l);
+}
+
+bool slist_empty(const struct slist *l)
+{
+    return slist_size(l) == 0;
+}
+
+size_t slist_size(const struct slist *l)
+{
+    if (!l) {
+        return 0;
+    }
+
+    return l->size;
+}
+
+int slist_clear(struct slist *l, void (*destructor)(void *))
+{
+    struct slist_node *node;
+
+    if (!l) {
+        return -EFAULT;
+    }
+
+    node = l->sentinel.next;
+
+    // Detach all nodes, so that destructors never observe dangling links.
+    l->sentinel.next = &l->sentinel;
+    l->tail = &l->sentinel;
+    l->size = 0;
+
+    while (node != &l->sentinel) {
+        struct slist_node *next = node->next;
+
+        LLIST_PREFETCH(next);
+
+        // Mark node as unlinked.
+        node->next = NULL;
+
+        if (destructor) {
+            destructor((char *)node - l->offset);
+        }
+
+        node = next;
+    }
+
+    return 0;
+}
+
+struct slist_iter *slist_before_begin(struct slist *l)
+{
+    return slist_end(l);
+}
+
+struct slist_iter *slist_begin(struct slist *l)
+{
+    if (!l) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    return (struct slist_iter *)l->sentinel.next;
+}
+
+struct slist_iter *slist_end(struct slist *l)
+{
+    if (!l) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    return (struct slist_iter *)&l->sentinel;
+}
+
+/// Sanity check list and iterator arguments.
+/// @return Zero if valid, negative errno otherwise.
+static int check_iter(const struct slist *l, const struct slist_iter *it)
+{
+    if (!l || !it) {
+        return -EFAULT;
+    }
+
+    if (!it->node.next) {
+        // Iterator not linked.
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
+struct slist_iter *slist_next(struct slist *l, struct slist_iter *it)
+{
+    int r = check_iter(l, it);
+    if (r < 0) {
+        errno = -r;
+        return NULL;
+    }
+
+    if (&it->node == &l->sentinel) {
+        errno = ERANGE;
+        return NULL;
+    }
+
+    return (struct slist_iter *)it->node.next;
+}
+
+void *slist_at(struct slist *l, struct slist_iter *it)
+{
+    int r = check_iter(l, it);
+    if (r < 0) {
+        errno = -r;
+        return NULL;
+    }
+
+    if (&it->node == &l->sentinel) {
+        errno = ENOENT;
+        return NULL;
+    }
+
+    return (char *)it - l->offset;
+}
+
+struct slist_iter *slist_insert_after(struct slist *l, struct slist_iter *it, void *element)
+{
+    struct slist_node *node;
+    int r;
+
+    r = check_iter(l, it);
+    if (r < 0) {
+        errno = -r;
+        return NULL;
+    }
+
+    if (!element) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    if (l->size == SIZE_MAX) {
+        // Detect pathological overflow case.
+        errno = EOVERFLOW;
+        return NULL;
+    }
+
+    node = (struct slist_node *)((char *)element + l->offset);
+    node->next = it->node.next;
+    it->node.next = node;
+
+    if (l->tail == &it->node) {
+        l->tail = node;
+    }
+
+    l->size++;
+
+    return (struct slist_iter *)node;
+}
+
+struct slist_iter *slist_push_front(struct slist *l, void *element)
+{
+    return slist_insert_after(l, slist_before_begin(l), element);
+}
+
+struct slist_iter *slist_push_back(struct slist *l, void *element)
+{
+    if (!l) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    return slist_insert_after(l, (struct slist_iter *)l->tail, element);
+}
+
+/// @return Unlinked element that follows the given iterator.
+static void *impl_unlink_after(struct slist *l, struct slist_iter *it)
+{
+    struct slist_node *node;
+    int r;
+
+    r = check_iter(l, it);
+    if (r < 0) {
+        errno = -r;
+        return NULL;
+    }
+
+    node = it->node.next;
+    if (node == &l->sentinel) {
+        errno = ENOENT;
+        return NULL;
+    }
+
+    it->node.next = node->next;
+
+    if (l->tail == node) {
+        l->tail = &it->node;
+    }
+
+    l->size--;
+
+    // Mark node as unlinked.
+    node->next = NULL;
+
+    return (char *)node - l->offset;
+}
+
+void *slist_pop_front(struct slist *l)
+{
+    return impl_unlink_after(l, slist_before_begin(l));
+}
+
+int slist_erase_after(struct slist *l, struct slist_iter *it, void (*destructor)(void *))
+{
+    void *element;
+
+    element = impl_unlink_after(l, it);
+    if (!element) {
+        return -errno;
+    }
+
+    if (destructor) {
+        destructor(element);
+    }
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+#ifndef LIBLIST_SLIST_H_
+#define LIBLIST_SLIST_H_
+
+/// Singly-linked list, suited to FIFO queues.
+///
+/// Elements embed @c SLIST_NODE, a single @c next pointer.
+/// The list keeps a tail pointer so that both @c slist_push_back and @c slist_pop_front are O(1).
+///
+/// Example:
+///
+///     struct my_item {
+///         int value;
+///         SLIST_NODE(link);
+///     };
+///
+///     struct slist *q = slist_new(offsetof(my_item, link));
+///
+/// Return conventions follow @c llist.h.
+///
+/// @note Nodes do not record their list, so operations take the list as their first argument.
+/// @warning Iterators passed to an operation must belong to the list passed with them; this cannot be verified.
+
+#define SLIST_NODE(name) struct slist_node name
+
+#include "llist.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/// Singly-linked list object.
+/// This library is **not** thread-safe.
+struct slist;
+
+struct slist_node {
+    struct slist_node *next;
+};
+
+/// Iterator object.
+/// @note Memory ownership: Owned by the object; valid until the element is removed, or the list is cleared or deleted.
+struct slist_iter;
+
+/// Constructor.
+/// @see list_new.
+struct slist *slist_new(size_t offset) PUBLIC;
+
+/// Destructor.
+/// @see list_delete.
+void slist_delete(struct slist *, void (*destructor)(void *)) PUBLIC;
+
+/// Test if list is empty.
+/// @return True if list is empty or NULL, false otherwise.
+bool slist_empty(const struct slist *) PUBLIC;
+
+/// Get number of elements in list.
+/// @return The number of elements in the list, or zero if empty or NULL.
+/// @note Complexity: O(1).
+size_t slist_size(const struct slist *) PUBLIC;
+
+/// Erases all elements from the container.
+/// @see list_clear.
+int slist_clear(struct slist *, void (*destructor)(void *)) PUBLIC;
+
+/// Get an iterator that precedes the first element.
+/// Only valid as the position argument of @c slist_insert_after and @c slist_erase_after.
+/// @return Pointer to iterator on success.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+/// @note The same sentinel also acts as @c slist_end.
+struct slist_iter *slist_before_begin(struct slist *) PUBLIC;
+
+/// Get iterator to first element of list.
+/// @see list_begin.
+struct slist_iter *slist_begin(struct slist *) PUBLIC;
+
+/// Get an iterator past the last element of list.
+/// @see list_end.
+struct slist_iter *slist_end(struct slist *) PUBLIC;
+
+/// Forward move iterator.
+/// @return Pointer to iterator on success.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Iterator invalid.
+///   - ERANGE: Iterator is @c slist_end.
+struct slist_iter *slist_next(struct slist *, struct slist_iter *) PUBLIC;
+
+/// Dereference iterator.
+/// @return Pointer to element on success.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Iterator invalid.
+///   - ENOENT: Iterator @c slist_end cannot be dereferenced.
+void *slist_at(struct slist *, struct slist_iter *) PUBLIC;
+
+/// Insert element after iterator.
+/// @return Pointer to iterator on success.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Iterator invalid.
+///   - EOVERFLOW: List cannot grow.
+/// @warning The @c element must not be already inserted to a list.
+/// @note Does not invalidate existing iterators.
+struct slist_iter *slist_insert_after(struct slist *, struct slist_iter *, void *element) PUBLIC;
+
+/// Insert element at front of list.
+/// @see slist_insert_after.
+struct slist_iter *slist_push_front(struct slist *, void *element) PUBLIC;
+
+/// Insert element at end of list.
+/// @see slist_insert_after.
+/// @note Complexity: O(1).
+struct slist_iter *slist_push_back(struct slist *, void *element) PUBLIC;
+
+/// Unlink and return the first element of the list.
+/// @see list_pop_front.
+void *slist_pop_front(struct slist *) PUBLIC;
+
+/// Remove the element after iterator, calling @c destructor.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Iterator invalid.
+///   - ENOENT: No element follows the iterator.
+/// @note Invalidates iterators pointing to the removed node.
+/// @note Memory ownership: On success if @c destructor is NULL then the caller regains ownership.
+int slist_erase_after(struct slist *, struct slist_iter *, void (*destructor)(void *)) PUBLIC;
+
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+
+// Private API.
+// Benchmark helpers.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/// @return Monotonic clock in nanoseconds.
+static inline uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/// Print the average cost of one operation.
+/// @param name Benchmark name.
+/// @param ops Number of operations timed.
+/// @param elapsed_ns Total elapsed time.
+static inline void bench_report(const char *name, size_t ops, uint64_t elapsed_ns)
+{
+    printf("%-40s %10.2f ns/op\n", name, ops ? (double)elapsed_ns / (double)ops : 0.0);
+}
+
+/// Defeat dead code elimination of benchmark results.
+static inline void bench_sink(const void *p)
+{
+    __asm__ __volatile__("" : : "r"(p) : "memory");
+}
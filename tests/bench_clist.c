@@ -0,0 +1,165 @@
+// Compare concurrent set throughput of clist and a mutex-protected llist, by thread count.
+
+#include "clist.h"
+#include "llist.h"
+
+#include "bench.h"
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+struct item
+{
+    int key;
+    CLIST_NODE(clink);
+    LIST_NODE(link);
+};
+
+enum { KEYS = 1024, OPS = 200000, MAX_THREADS = 8 };
+
+static int cmp_item(const void *a, const void *b)
+{
+    const struct item *x = a;
+    const struct item *y = b;
+    return (x->key > y->key) - (x->key < y->key);
+}
+
+struct worker {
+    struct clist *cl;
+    struct list *l;
+    pthread_mutex_t *lock;
+    unsigned seed;
+    int thread;
+};
+
+/// Keys are interleaved across threads, so that they contend for the same region of the list.
+static int key_of(int thread, unsigned r)
+{
+    return (int)(r % KEYS) * MAX_THREADS + thread;
+}
+
+static struct item *make(int key)
+{
+    struct item *it = calloc(1, sizeof(struct item));
+    it->key = key;
+    return it;
+}
+
+/// Mix: 80% lookups, 10% inserts, 10% removes.
+static void *run_clist(void *arg)
+{
+    struct worker *w = arg;
+
+    for (int i = 0; i < OPS; i++) {
+        unsigned r = rand_r(&w->seed);
+        struct item key = { .key = key_of(w->thread, r) };
+
+        if (r % 10 == 0) {
+            struct item *it = make(key.key);
+            if (clist_insert(w->cl, it) < 0) {
+                free(it);
+            }
+        } else if (r % 10 == 1) {
+            clist_remove(w->cl, &key, free);
+        } else {
+            bench_sink((void *)(size_t)clist_contains(w->cl, &key));
+        }
+    }
+
+    return NULL;
+}
+
+static struct list_iter *find(struct list *l, const struct item *key)
+{
+    struct list_iter *it = list_begin(l);
+    struct list_iter *end = list_end(l);
+
+    while (it != end) {
+        int c = cmp_item(list_at(it), key);
+        if (c >= 0) {
+            break;
+        }
+        it = list_next(it);
+    }
+
+    return it;
+}
+
+static void *run_mutex(void *arg)
+{
+    struct worker *w = arg;
+
+    for (int i = 0; i < OPS; i++) {
+        unsigned r = rand_r(&w->seed);
+        struct item key = { .key = key_of(w->thread, r) };
+        struct list_iter *pos;
+        bool hit;
+
+        pthread_mutex_lock(w->lock);
+        pos = find(w->l, &key);
+        hit = pos != list_end(w->l) && cmp_item(list_at(pos), &key) == 0;
+        if (r % 10 == 0) {
+            if (!hit) {
+                list_insert(pos, make(key.key));
+            }
+        } else if (r % 10 == 1) {
+            if (hit) {
+                list_erase(pos, free);
+            }
+        } else {
+            bench_sink((void *)(size_t)hit);
+        }
+        pthread_mutex_unlock(w->lock);
+    }
+
+    return NULL;
+}
+
+static void run(const char *name, void *(*fn)(void *), int threads)
+{
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    struct clist *cl = clist_new(offsetof(struct item, clink), cmp_item);
+    struct list *l = list_new(offsetof(struct item, link));
+    struct worker workers[MAX_THREADS];
+    pthread_t tids[MAX_THREADS];
+    char label[64];
+    uint64_t t;
+
+    // Prefill half the keys of each thread.
+    for (int i = 0; i < threads; i++) {
+        for (unsigned k = 0; k < KEYS; k += 2) {
+            struct item *it = make(key_of(i, k));
+            clist_insert(cl, it);
+            it = make(key_of(i, k));
+            list_insert(find(l, it), it);
+        }
+    }
+
+    t = bench_now_ns();
+    for (int i = 0; i < threads; i++) {
+        workers[i] = (struct worker){ .cl = cl, .l = l, .lock = &lock, .seed = (unsigned)i + 1, .thread = i };
+        pthread_create(&tids[i], NULL, fn, &workers[i]);
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    t = bench_now_ns() - t;
+
+    snprintf(label, sizeof(label), "%s, %d threads", name, threads);
+    bench_report(label, (size_t)OPS * (size_t)threads, t);
+
+    clist_synchronize();
+    clist_delete(cl, free);
+    list_delete(l, free);
+}
+
+int main(void)
+{
+    for (int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+        run("clist", run_clist, threads);
+        run("llist + mutex", run_mutex, threads);
+    }
+
+    return 0;
+}
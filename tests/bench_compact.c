@@ -0,0 +1,86 @@
+// Compare memory footprint and throughput of LIST_NODE and LIST_NODE_COMPACT.
+
+#include "llist.h"
+#include "llist_compact.h"
+
+#include "bench.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+/// Objects participating in four lists at once.
+struct item
+{
+    int value;
+    LIST_NODE(link[4]);
+};
+
+struct item_compact
+{
+    int value;
+    LIST_NODE_COMPACT(link[4]);
+};
+
+enum { N = 2000000, ROUNDS = 10 };
+
+int main(void)
+{
+    struct item *items = calloc(N, sizeof(struct item));
+    struct item_compact *compact = calloc(N, sizeof(struct item_compact));
+    struct list *l = list_new(offsetof(struct item, link[0]));
+    struct list_compact *c = list_compact_new(offsetof(struct item_compact, link[0]));
+    uint64_t t;
+
+    printf("%-40s %10zu bytes\n", "sizeof(struct list_node)", sizeof(struct list_node));
+    printf("%-40s %10zu bytes\n", "sizeof(struct list_compact_node)", sizeof(struct list_compact_node));
+    printf("%-40s %10zu bytes\n", "object with 4 LIST_NODE", sizeof(struct item));
+    printf("%-40s %10zu bytes\n", "object with 4 LIST_NODE_COMPACT", sizeof(struct item_compact));
+    printf("%-40s %10.1f MiB\n", "saved per 100M objects",
+           (double)(sizeof(struct item) - sizeof(struct item_compact)) * 1e8 / (1024.0 * 1024.0));
+
+    t = bench_now_ns();
+    for (size_t i = 0; i < N; i++) {
+        list_push_back(l, &items[i]);
+    }
+    bench_report("push_back (list)", N, bench_now_ns() - t);
+
+    t = bench_now_ns();
+    for (size_t i = 0; i < N; i++) {
+        list_compact_push_back(c, &compact[i]);
+    }
+    bench_report("push_back (compact)", N, bench_now_ns() - t);
+
+    t = bench_now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (struct list_iter *it = list_begin(l); it != list_end(l); it = list_next(it)) {
+            bench_sink(list_at(it));
+        }
+    }
+    bench_report("traverse (list)", (size_t)N * ROUNDS, bench_now_ns() - t);
+
+    t = bench_now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (struct list_compact_iter *it = list_compact_begin(c); it != list_compact_end(c); it = list_compact_next(c, it)) {
+            bench_sink(list_compact_at(c, it));
+        }
+    }
+    bench_report("traverse (compact)", (size_t)N * ROUNDS, bench_now_ns() - t);
+
+    t = bench_now_ns();
+    while (!list_empty(l)) {
+        bench_sink(list_pop_front(l));
+    }
+    bench_report("pop_front (list)", N, bench_now_ns() - t);
+
+    t = bench_now_ns();
+    while (!list_compact_empty(c)) {
+        bench_sink(list_compact_pop_front(c));
+    }
+    bench_report("pop_front (compact)", N, bench_now_ns() - t);
+
+    list_delete(l, NULL);
+    list_compact_delete(c, NULL);
+    free(items);
+    free(compact);
+    return 0;
+}
@@ -0,0 +1,97 @@
+// Compare full-list traversal with list_next and with prefetching list_for_each.
+// Lists are larger than the last-level cache, and laid out in allocation order or shuffled.
+//
+// Usage: bench_for_each [elements]
+
+#include "llist.h"
+
+#include "bench.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+struct item
+{
+    LIST_NODE(link);
+    char pad[40];
+    long value;
+};
+
+static int sum(void *element, void *ctx)
+{
+    *(long *)ctx += ((struct item *)element)->value;
+    return 0;
+}
+
+static void run(const char *layout, struct list *l, size_t n)
+{
+    static const size_t distances[] = { 0, 4, 8, 16, 32 };
+    char name[64];
+    long total;
+    uint64_t t;
+
+    total = 0;
+    t = bench_now_ns();
+    for (struct list_iter *it = list_begin(l); it != list_end(l); it = list_next(it)) {
+        total += ((struct item *)list_at(it))->value;
+    }
+    snprintf(name, sizeof(name), "list_next (%s)", layout);
+    bench_report(name, n, bench_now_ns() - t);
+    bench_sink(&total);
+
+    for (size_t i = 0; i < sizeof(distances) / sizeof(distances[0]); i++) {
+        total = 0;
+        t = bench_now_ns();
+        list_for_each_prefetch(l, sum, &total, distances[i], offsetof(struct item, value));
+        snprintf(name, sizeof(name), "list_for_each d=%zu (%s)", distances[i], layout);
+        bench_report(name, n, bench_now_ns() - t);
+        bench_sink(&total);
+    }
+
+    total = 0;
+    t = bench_now_ns();
+    list_for_each_reverse(l, sum, &total);
+    snprintf(name, sizeof(name), "list_for_each_reverse (%s)", layout);
+    bench_report(name, n, bench_now_ns() - t);
+    bench_sink(&total);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 0) : 4000000;
+    struct item *items = calloc(n, sizeof(struct item));
+    size_t *order = malloc(n * sizeof(size_t));
+    struct list *l = list_new(offsetof(struct item, link));
+    unsigned seed = 1;
+
+    for (size_t i = 0; i < n; i++) {
+        items[i].value = (long)i;
+        order[i] = i;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        list_push_back(l, &items[i]);
+    }
+    run("sequential", l, n);
+    list_clear(l, NULL);
+
+    for (size_t i = n - 1; i > 0; i--) {
+        size_t j;
+        size_t tmp;
+        seed = seed * 1103515245u + 12345u;
+        j = ((size_t)seed << 16 ^ (size_t)(seed >> 8)) % (i + 1);
+        tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        list_push_back(l, &items[order[i]]);
+    }
+    run("shuffled", l, n);
+
+    list_delete(l, NULL);
+    free(order);
+    free(items);
+    return 0;
+}
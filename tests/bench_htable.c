@@ -0,0 +1,104 @@
+// Latency of insertion into a growing hash table: the incremental rehash of htable against the stop-the-world rehash
+// of the LRU cache index, unbounded. Reports mean, 99.99th percentile and worst single insertion, then lookup cost.
+// Usage: bench_htable [elements]
+
+#include "htable.h"
+#include "lru.h"
+
+#include "bench.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+struct item
+{
+    HTABLE_NODE(link);
+    LRU_NODE(lru);
+    unsigned key;
+};
+
+static size_t hash_key(const void *key)
+{
+    return (size_t)*(const unsigned *)key * (size_t)0x9E3779B97F4A7C15u;
+}
+
+static int cmp_key(const void *a, const void *b)
+{
+    return *(const unsigned *)a != *(const unsigned *)b;
+}
+
+static size_t hash_item(const void *element)
+{
+    return hash_key(&((const struct item *)element)->key);
+}
+
+static int cmp_item(const void *a, const void *b)
+{
+    return cmp_key(&((const struct item *)a)->key, &((const struct item *)b)->key);
+}
+
+static int cmp_latency(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void report(const char *name, uint64_t *latency, size_t n)
+{
+    uint64_t total = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        total += latency[i];
+    }
+    qsort(latency, n, sizeof(uint64_t), cmp_latency);
+
+    printf("%-40s %10.2f ns/op  p99.99 %8llu ns  max %10llu ns\n", name, (double)total / (double)n,
+           (unsigned long long)latency[n - n / 10000 - 1], (unsigned long long)latency[n - 1]);
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 0) : 4000000;
+    struct item *items = calloc(n, sizeof(struct item));
+    uint64_t *latency = malloc(n * sizeof(uint64_t));
+    struct htable *t = htable_new(offsetof(struct item, link), offsetof(struct item, key), hash_key, cmp_key);
+    struct lru *c = lru_new(offsetof(struct item, lru), hash_item, cmp_item);
+    uint64_t start;
+
+    for (size_t i = 0; i < n; i++) {
+        items[i].key = (unsigned)i;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        start = bench_now_ns();
+        htable_insert(t, &items[i]);
+        latency[i] = bench_now_ns() - start;
+    }
+    report("htable insert (incremental rehash)", latency, n);
+
+    for (size_t i = 0; i < n; i++) {
+        start = bench_now_ns();
+        lru_put(c, &items[i], 0);
+        latency[i] = bench_now_ns() - start;
+    }
+    report("lru insert (stop-the-world rehash)", latency, n);
+
+    start = bench_now_ns();
+    for (size_t i = 0; i < n; i++) {
+        bench_sink(htable_find(t, &items[(i * 7919) % n].key));
+    }
+    bench_report("htable find", n, bench_now_ns() - start);
+
+    start = bench_now_ns();
+    for (size_t i = 0; i < n; i++) {
+        bench_sink(lru_peek(c, &items[(i * 7919) % n]));
+    }
+    bench_report("lru peek", n, bench_now_ns() - start);
+
+    htable_delete(t, NULL);
+    lru_delete(c, NULL);
+    free(latency);
+    free(items);
+    return 0;
+}
@@ -0,0 +1,68 @@
+// Compare indexed access with and without a positional index, and the index upkeep cost on insert and erase.
+//
+// Usage: bench_index [elements]
+
+#include "llist.h"
+
+#include "bench.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+struct item
+{
+    long value;
+    LIST_NODE(link);
+};
+
+enum { LOOKUPS = 1000, UPDATES = 1000000 };
+
+static void lookups(const char *name, struct list *l, size_t n)
+{
+    unsigned seed = 1;
+    uint64_t t = bench_now_ns();
+
+    for (size_t i = 0; i < LOOKUPS; i++) {
+        seed = seed * 1103515245u + 12345u;
+        bench_sink(list_advance(list_begin(l), (ssize_t)(((size_t)seed << 8 ^ seed >> 8) % n)));
+    }
+    bench_report(name, LOOKUPS, bench_now_ns() - t);
+}
+
+static void updates(const char *name, struct list *l, struct item *spare)
+{
+    struct list_iter *it = list_nth(l, list_size(l) / 2);
+    uint64_t t = bench_now_ns();
+
+    for (size_t i = 0; i < UPDATES; i++) {
+        list_insert(it, spare);
+        list_erase(list_prev(it), NULL);
+    }
+    bench_report(name, UPDATES, bench_now_ns() - t);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 0) : 1000000;
+    struct item *items = calloc(n + 1, sizeof(struct item));
+    struct list *l = list_new(offsetof(struct item, link));
+    uint64_t t;
+
+    for (size_t i = 0; i < n; i++) {
+        list_push_back(l, &items[i]);
+    }
+
+    lookups("list_advance (walk)", l, n);
+    updates("insert+erase (no index)", l, &items[n]);
+
+    t = bench_now_ns();
+    list_index_enable(l);
+    bench_report("list_index_enable", n, bench_now_ns() - t);
+
+    lookups("list_advance (index)", l, n);
+    updates("insert+erase (index)", l, &items[n]);
+
+    list_delete(l, NULL);
+    free(items);
+    return 0;
+}
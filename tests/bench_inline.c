@@ -0,0 +1,110 @@
+// Compare out-of-line library calls with the LLIST_INLINE fast paths and the unchecked variants.
+
+#define LLIST_INLINE
+#include "llist.h"
+
+#include "bench.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+struct node
+{
+    int n;
+    LIST_NODE(link);
+};
+
+enum { N = 1000000, ROUNDS = 20 };
+
+int main(void)
+{
+    struct node *nodes = calloc(N, sizeof(struct node));
+    struct list *l = list_new(offsetof(struct node, link));
+    struct list_iter *it;
+    uint64_t t;
+
+    t = bench_now_ns();
+    for (size_t i = 0; i < N; i++) {
+        (list_insert)((list_end)(l), &nodes[i]);
+    }
+    bench_report("insert (library)", N, bench_now_ns() - t);
+    list_clear(l, NULL);
+
+    t = bench_now_ns();
+    for (size_t i = 0; i < N; i++) {
+        list_insert(list_end(l), &nodes[i]);
+    }
+    bench_report("insert (inline)", N, bench_now_ns() - t);
+
+    t = bench_now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (it = (list_begin)(l); it != (list_end)(l); it = (list_next)(it)) {
+            bench_sink((list_at)(it));
+        }
+    }
+    bench_report("next+at (library)", (size_t)N * ROUNDS, bench_now_ns() - t);
+
+    t = bench_now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (it = list_begin(l); it != list_end(l); it = list_next(it)) {
+            bench_sink(list_at(it));
+        }
+    }
+    bench_report("next+at (inline)", (size_t)N * ROUNDS, bench_now_ns() - t);
+
+    t = bench_now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (it = list_begin(l); it != list_end(l); it = list_next_unchecked(it)) {
+            bench_sink(list_at_unchecked(it));
+        }
+    }
+    bench_report("next+at (unchecked)", (size_t)N * ROUNDS, bench_now_ns() - t);
+
+    t = bench_now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (it = (list_prev)((list_end)(l)); it; it = (list_prev)(it)) {
+            bench_sink(it);
+        }
+    }
+    bench_report("prev (library)", (size_t)N * ROUNDS, bench_now_ns() - t);
+
+    t = bench_now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (it = list_prev(list_end(l)); it; it = list_prev(it)) {
+            bench_sink(it);
+        }
+    }
+    bench_report("prev (inline)", (size_t)N * ROUNDS, bench_now_ns() - t);
+
+    t = bench_now_ns();
+    while (!list_empty(l)) {
+        bench_sink((list_pop_front)(l));
+    }
+    bench_report("pop_front (library)", N, bench_now_ns() - t);
+
+    for (size_t i = 0; i < N; i++) {
+        list_push_back(l, &nodes[i]);
+    }
+
+    t = bench_now_ns();
+    while (!list_empty(l)) {
+        bench_sink(list_pop_front(l));
+    }
+    bench_report("pop_front (inline)", N, bench_now_ns() - t);
+
+    t = bench_now_ns();
+    for (size_t i = 0; i < N; i++) {
+        list_push_back_unchecked(l, &nodes[i]);
+    }
+    bench_report("push_back (unchecked)", N, bench_now_ns() - t);
+
+    t = bench_now_ns();
+    while (!list_empty(l)) {
+        bench_sink(list_pop_front_unchecked(l));
+    }
+    bench_report("pop_front (unchecked)", N, bench_now_ns() - t);
+
+    list_delete(l, NULL);
+    free(nodes);
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Sorted insertion of near-sequential keys: a walk from list_begin for each element, against list_insert_sorted with
+// its cached finger, and list_insert_sorted_n with batches of 64.
+// Usage: bench_insert_sorted [elements]
+
+#include "llist.h"
+
+#include "bench.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+struct item
+{
+    long key;
+    LIST_NODE(link);
+};
+
+enum { BATCH = 64 };
+
+static int cmp_key(const void *a, const void *b)
+{
+    long x = ((const struct item *)a)->key;
+    long y = ((const struct item *)b)->key;
+    return (x > y) - (x < y);
+}
+
+/// Keys that mostly increase, each within a few places of its sorted position.
+static void fill(struct item *items, size_t n)
+{
+    unsigned seed = 1;
+
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        items[i].key = (long)(i * 8) + (long)((seed >> 16) % 32) - 16;
+    }
+}
+
+static int cmp_ptr(const void *a, const void *b)
+{
+    return cmp_key(*(const void *const *)a, *(const void *const *)b);
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 0) : 1000000;
+    size_t walk = n < 20000 ? n : 20000;
+    struct item *items = calloc(n, sizeof(struct item));
+    void *batch[BATCH];
+    struct list *l;
+    uint64_t t;
+
+    fill(items, n);
+
+    l = list_new(offsetof(struct item, link));
+    t = bench_now_ns();
+    for (size_t i = 0; i < walk; i++) {
+        struct list_iter *it = list_begin(l);
+
+        while (it != list_end(l) && cmp_key(list_at(it), &items[i]) <= 0) {
+            it = list_next(it);
+        }
+        list_insert(it, &items[i]);
+    }
+    bench_report("walk from list_begin (20k)", walk, bench_now_ns() - t);
+    list_delete(l, NULL);
+
+    l = list_new(offsetof(struct item, link));
+    t = bench_now_ns();
+    for (size_t i = 0; i < n; i++) {
+        list_insert_sorted(l, &items[i], cmp_key, NULL);
+    }
+    bench_report("list_insert_sorted", n, bench_now_ns() - t);
+    list_delete(l, NULL);
+
+    l = list_new(offsetof(struct item, link));
+    t = bench_now_ns();
+    for (size_t i = 0; i + BATCH <= n; i += BATCH) {
+        for (size_t j = 0; j < BATCH; j++) {
+            batch[j] = &items[i + j];
+        }
+        qsort(batch, BATCH, sizeof(void *), cmp_ptr);
+        list_insert_sorted_n(l, batch, BATCH, cmp_key);
+    }
+    bench_report("list_insert_sorted_n (sort + merge)", n - n % BATCH, bench_now_ns() - t);
+    list_delete(l, NULL);
+
+    free(items);
+    return 0;
+}
@@ -0,0 +1,177 @@
+// Compare concurrent set throughput of lflist (lock-free) and clist (per-node locks), by thread count and update
+// ratio.
+
+#include "clist.h"
+#include "lflist.h"
+
+#include "bench.h"
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+struct item
+{
+    int key;
+    CLIST_NODE(clink);
+    LFLIST_NODE(lflink);
+};
+
+enum { KEYS = 512, OPS = 200000, MAX_THREADS = 8 };
+
+static int cmp_item(const void *a, const void *b)
+{
+    const struct item *x = a;
+    const struct item *y = b;
+    return (x->key > y->key) - (x->key < y->key);
+}
+
+/// Operations on one of the two sets.
+struct set_ops {
+    const char *name;
+    void *(*create)(void);
+    void (*destroy)(void *);
+    int (*insert)(void *, void *);
+    int (*remove)(void *, const void *);
+    bool (*contains)(void *, const void *);
+};
+
+static void *clist_create(void)
+{
+    return clist_new(offsetof(struct item, clink), cmp_item);
+}
+
+static void clist_destroy(void *set)
+{
+    clist_synchronize();
+    clist_delete(set, free);
+}
+
+static int clist_insert_(void *set, void *element)
+{
+    return clist_insert(set, element);
+}
+
+static int clist_remove_(void *set, const void *key)
+{
+    return clist_remove(set, key, free);
+}
+
+static bool clist_contains_(void *set, const void *key)
+{
+    return clist_contains(set, key);
+}
+
+static void *lflist_create(void)
+{
+    return lflist_new(offsetof(struct item, lflink), cmp_item);
+}
+
+static void lflist_destroy(void *set)
+{
+    lflist_synchronize();
+    lflist_delete(set, free);
+}
+
+static int lflist_insert_(void *set, void *element)
+{
+    return lflist_insert(set, element);
+}
+
+static int lflist_remove_(void *set, const void *key)
+{
+    return lflist_remove(set, key, free);
+}
+
+static bool lflist_contains_(void *set, const void *key)
+{
+    return lflist_contains(set, key);
+}
+
+static const struct set_ops sets[] = {
+    { "lflist", lflist_create, lflist_destroy, lflist_insert_, lflist_remove_, lflist_contains_ },
+    { "clist", clist_create, clist_destroy, clist_insert_, clist_remove_, clist_contains_ },
+};
+
+struct worker {
+    const struct set_ops *ops;
+    void *set;
+    unsigned seed;
+    /// Percentage of operations that insert or remove.
+    unsigned updates;
+};
+
+static struct item *make(int key)
+{
+    struct item *it = calloc(1, sizeof(struct item));
+    it->key = key;
+    return it;
+}
+
+static void *run_worker(void *arg)
+{
+    struct worker *w = arg;
+
+    // All threads share one key range, so that updates contend for the same nodes.
+    for (int i = 0; i < OPS; i++) {
+        unsigned r = rand_r(&w->seed);
+        unsigned op = r % 100;
+        struct item key = { .key = (int)((r / 100) % KEYS) };
+
+        if (op < w->updates / 2) {
+            struct item *it = make(key.key);
+            if (w->ops->insert(w->set, it) < 0) {
+                free(it);
+            }
+        } else if (op < w->updates) {
+            w->ops->remove(w->set, &key);
+        } else {
+            bench_sink((void *)(size_t)w->ops->contains(w->set, &key));
+        }
+    }
+
+    return NULL;
+}
+
+static void run(const struct set_ops *ops, int threads, unsigned updates)
+{
+    void *set = ops->create();
+    struct worker workers[MAX_THREADS];
+    pthread_t tids[MAX_THREADS];
+    char label[64];
+    uint64_t t;
+
+    for (int k = 0; k < KEYS; k += 2) {
+        ops->insert(set, make(k));
+    }
+
+    t = bench_now_ns();
+    for (int i = 0; i < threads; i++) {
+        workers[i] = (struct worker){ .ops = ops, .set = set, .seed = (unsigned)i + 1, .updates = updates };
+        pthread_create(&tids[i], NULL, run_worker, &workers[i]);
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    t = bench_now_ns() - t;
+
+    snprintf(label, sizeof(label), "%s, %d threads, %u%% updates", ops->name, threads, updates);
+    bench_report(label, (size_t)OPS * (size_t)threads, t);
+
+    ops->destroy(set);
+}
+
+int main(void)
+{
+    const unsigned mixes[] = { 10, 50 };
+
+    for (size_t m = 0; m < sizeof(mixes) / sizeof(mixes[0]); m++) {
+        for (int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+            for (size_t s = 0; s < sizeof(sets) / sizeof(sets[0]); s++) {
+                run(&sets[s], threads, mixes[m]);
+            }
+        }
+    }
+
+    return 0;
+}
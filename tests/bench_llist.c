@@ -0,0 +1,225 @@
+// Core list operations by list size and node layout, against a <sys/queue.h> TAILQ baseline.
+// Nodes are linked either in allocation order ("sequential") or in a random permutation of it ("shuffled").
+// For each size, layout and implementation, the list is built, traversed, then exercised with push_back/pop_front
+// pairs, erase/insert pairs and single-element splices at random positions, and finally cleared.
+// Results are printed as JSON, one object per measurement, so that runs can be diffed between builds.
+//
+// Usage: bench_llist [max elements]
+// Sizes go up by powers of ten from 10 to the maximum (default 10^7; 10^8 needs about 6 GB of memory).
+
+#include "llist.h"
+
+#include "bench.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <sys/queue.h>
+
+struct item
+{
+    LIST_NODE(link);
+    TAILQ_ENTRY(item) entry;
+    long value;
+};
+
+TAILQ_HEAD(tailq, item);
+
+/// Operations timed per random-access measurement.
+enum { OPS = 1 << 20 };
+
+/// Elements visited per traversal or clear measurement, at least.
+enum { VISITS = 1 << 22 };
+
+static int g_first = 1;
+
+static void emit(const char *impl, const char *op, size_t size, const char *layout, size_t ops, uint64_t ns)
+{
+    printf("%s\n    {\"impl\": \"%s\", \"op\": \"%s\", \"size\": %zu, \"layout\": \"%s\", \"ns_per_op\": %.3f}",
+           g_first ? "" : ",", impl, op, size, layout, ops ? (double)ns / (double)ops : 0.0);
+    g_first = 0;
+    fflush(stdout);
+}
+
+static uint64_t g_seed = 88172645463325252u;
+
+/// @return Pseudo-random number in [0, n).
+static size_t rand_below(size_t n)
+{
+    g_seed ^= g_seed << 13;
+    g_seed ^= g_seed >> 7;
+    g_seed ^= g_seed << 17;
+    return (size_t)(g_seed % n);
+}
+
+/// @return Random index in [0, n) other than @c i.
+static size_t rand_other(size_t i, size_t n)
+{
+    size_t j = rand_below(n - 1);
+    return j < i ? j : j + 1;
+}
+
+static struct list_iter *iter(struct item *item)
+{
+    return list_element(item, offsetof(struct item, link));
+}
+
+static void run_llist(struct item *items, const size_t *order, size_t n, const char *layout)
+{
+    struct list *l = list_new(offsetof(struct item, link));
+    size_t reps = VISITS / n ? VISITS / n : 1;
+    uint64_t elapsed = 0;
+    uint64_t t;
+    long total = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        list_push_back(l, &items[order[i]]);
+    }
+
+    t = bench_now_ns();
+    for (size_t r = 0; r < reps; r++) {
+        for (struct list_iter *it = list_begin(l); it != list_end(l); it = list_next(it)) {
+            total += ((struct item *)list_at(it))->value;
+        }
+    }
+    emit("llist", "traverse", n, layout, reps * n, bench_now_ns() - t);
+    bench_sink(&total);
+
+    t = bench_now_ns();
+    for (size_t k = 0; k < OPS; k++) {
+        list_push_back(l, list_pop_front(l));
+    }
+    emit("llist", "push_pop", n, layout, OPS, bench_now_ns() - t);
+
+    if (n > 1) {
+        t = bench_now_ns();
+        for (size_t k = 0; k < OPS; k++) {
+            size_t i = rand_below(n);
+            struct item *other = &items[rand_other(i, n)];
+
+            list_erase(iter(&items[i]), NULL);
+            list_insert(iter(other), &items[i]);
+        }
+        emit("llist", "erase_insert_random", n, layout, OPS, bench_now_ns() - t);
+
+        t = bench_now_ns();
+        for (size_t k = 0; k < OPS; k++) {
+            size_t i = rand_below(n);
+            list_splice(iter(&items[rand_other(i, n)]), iter(&items[i]));
+        }
+        emit("llist", "splice_random", n, layout, OPS, bench_now_ns() - t);
+    }
+
+    for (size_t r = 0; r < reps; r++) {
+        if (r > 0) {
+            for (size_t i = 0; i < n; i++) {
+                list_push_back(l, &items[order[i]]);
+            }
+        }
+        t = bench_now_ns();
+        list_clear(l, NULL);
+        elapsed += bench_now_ns() - t;
+    }
+    emit("llist", "clear", n, layout, reps * n, elapsed);
+
+    list_delete(l, NULL);
+}
+
+static void run_tailq(struct item *items, const size_t *order, size_t n, const char *layout)
+{
+    struct tailq q;
+    size_t reps = VISITS / n ? VISITS / n : 1;
+    uint64_t elapsed = 0;
+    uint64_t t;
+    long total = 0;
+    struct item *item;
+
+    TAILQ_INIT(&q);
+    for (size_t i = 0; i < n; i++) {
+        TAILQ_INSERT_TAIL(&q, &items[order[i]], entry);
+    }
+
+    t = bench_now_ns();
+    for (size_t r = 0; r < reps; r++) {
+        TAILQ_FOREACH(item, &q, entry) {
+            total += item->value;
+        }
+    }
+    emit("tailq", "traverse", n, layout, reps * n, bench_now_ns() - t);
+    bench_sink(&total);
+
+    t = bench_now_ns();
+    for (size_t k = 0; k < OPS; k++) {
+        item = TAILQ_FIRST(&q);
+        TAILQ_REMOVE(&q, item, entry);
+        TAILQ_INSERT_TAIL(&q, item, entry);
+    }
+    emit("tailq", "push_pop", n, layout, OPS, bench_now_ns() - t);
+
+    if (n > 1) {
+        // TAILQ has no splice; moving an element is a remove and an insert, as for erase_insert_random.
+        t = bench_now_ns();
+        for (size_t k = 0; k < OPS; k++) {
+            size_t i = rand_below(n);
+            struct item *other = &items[rand_other(i, n)];
+
+            TAILQ_REMOVE(&q, &items[i], entry);
+            TAILQ_INSERT_BEFORE(other, &items[i], entry);
+        }
+        emit("tailq", "erase_insert_random", n, layout, OPS, bench_now_ns() - t);
+    }
+
+    // Unlink every element, as list_clear does.
+    for (size_t r = 0; r < reps; r++) {
+        if (r > 0) {
+            for (size_t i = 0; i < n; i++) {
+                TAILQ_INSERT_TAIL(&q, &items[order[i]], entry);
+            }
+        }
+        t = bench_now_ns();
+        while ((item = TAILQ_FIRST(&q))) {
+            TAILQ_REMOVE(&q, item, entry);
+        }
+        elapsed += bench_now_ns() - t;
+    }
+    emit("tailq", "clear", n, layout, reps * n, elapsed);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t max = argc > 1 ? strtoul(argv[1], NULL, 0) : 10000000;
+    struct item *items = calloc(max, sizeof(struct item));
+    size_t *order = malloc(max * sizeof(size_t));
+
+    if (!items || !order) {
+        fprintf(stderr, "bench_llist: cannot allocate %zu elements\n", max);
+        return 1;
+    }
+
+    for (size_t i = 0; i < max; i++) {
+        items[i].value = (long)i;
+    }
+
+    printf("{\"benchmark\": \"bench_llist\", \"results\": [");
+    for (size_t n = 10; n <= max; n *= 10) {
+        for (size_t i = 0; i < n; i++) {
+            order[i] = i;
+        }
+        run_llist(items, order, n, "sequential");
+        run_tailq(items, order, n, "sequential");
+
+        // Fisher-Yates shuffle.
+        for (size_t i = n - 1; i > 0; i--) {
+            size_t j = rand_below(i + 1);
+            size_t swap = order[i];
+            order[i] = order[j];
+            order[j] = swap;
+        }
+        run_llist(items, order, n, "shuffled");
+        run_tailq(items, order, n, "shuffled");
+    }
+    printf("\n]}\n");
+
+    free(order);
+    free(items);
+    return 0;
+}
@@ -0,0 +1,116 @@
+// Hit rate and throughput of the LRU cache on Zipfian key streams.
+// Each operation looks a key up, and on a miss inserts it.
+// Usage: bench_lru [keys] [operations]
+
+#include "lru.h"
+
+#include "bench.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+struct item
+{
+    unsigned key;
+    LRU_NODE(link);
+};
+
+static size_t hash_key(const void *element)
+{
+    return (size_t)((const struct item *)element)->key * (size_t)0x9E3779B97F4A7C15u;
+}
+
+static int cmp_key(const void *a, const void *b)
+{
+    return ((const struct item *)a)->key != ((const struct item *)b)->key;
+}
+
+/// Fill @c stream with @c n keys in [0, keys), drawn from a Zipf distribution with exponent @c s.
+static void zipf(unsigned *stream, size_t n, size_t keys, double s)
+{
+    double *cdf = malloc(keys * sizeof(double));
+    double total = 0;
+    unsigned seed = 12345;
+
+    for (size_t k = 0; k < keys; k++) {
+        total += 1.0 / pow((double)(k + 1), s);
+        cdf[k] = total;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        double u;
+        size_t lo = 0;
+        size_t hi = keys - 1;
+
+        seed = seed * 1103515245u + 12345u;
+        u = (double)(seed >> 8) / (double)(1u << 24) * total;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (cdf[mid] < u) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+
+        // Scatter popular keys across the key space.
+        stream[i] = (unsigned)((lo * 2654435761u) % keys);
+    }
+
+    free(cdf);
+}
+
+static void run(struct item *items, size_t keys, const unsigned *stream, size_t n, double s, size_t capacity,
+                size_t batch)
+{
+    struct lru *cache = lru_new(offsetof(struct item, link), hash_key, cmp_key);
+    size_t hits = 0;
+    char name[80];
+    uint64_t t;
+
+    lru_set_capacity(cache, capacity, 0);
+    lru_set_eviction(cache, NULL, NULL, batch);
+
+    t = bench_now_ns();
+    for (size_t i = 0; i < n; i++) {
+        struct item *item = &items[stream[i]];
+
+        if (lru_get(cache, item)) {
+            hits++;
+        } else {
+            lru_put(cache, item, 0);
+        }
+    }
+    t = bench_now_ns() - t;
+
+    snprintf(name, sizeof(name), "s=%.2f cap=%zu%% batch=%zu hit=%.1f%%", s, capacity * 100 / keys, batch,
+             100.0 * (double)hits / (double)n);
+    bench_report(name, n, t);
+
+    lru_delete(cache, NULL);
+}
+
+int main(int argc, char **argv)
+{
+    size_t keys = argc > 1 ? strtoul(argv[1], NULL, 0) : 1000000;
+    size_t n = argc > 2 ? strtoul(argv[2], NULL, 0) : 5000000;
+    struct item *items = calloc(keys, sizeof(struct item));
+    unsigned *stream = malloc(n * sizeof(unsigned));
+    const double exponents[] = { 0.8, 0.99, 1.2 };
+
+    for (size_t k = 0; k < keys; k++) {
+        items[k].key = (unsigned)k;
+    }
+
+    for (size_t e = 0; e < sizeof(exponents) / sizeof(exponents[0]); e++) {
+        zipf(stream, n, keys, exponents[e]);
+        run(items, keys, stream, n, exponents[e], keys / 100, 0);
+        run(items, keys, stream, n, exponents[e], keys / 100, 64);
+        run(items, keys, stream, n, exponents[e], keys / 10, 0);
+    }
+
+    free(stream);
+    free(items);
+    return 0;
+}
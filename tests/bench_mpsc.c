@@ -0,0 +1,118 @@
+// Compare producer-to-consumer handoff through list_mpsc and a mutex-protected llist, by producer count.
+
+#include "llist.h"
+#include "llist_mpsc.h"
+
+#include "bench.h"
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+struct item
+{
+    int value;
+    LIST_NODE(link);
+};
+
+enum { PER_PRODUCER = 500000, MAX_PRODUCERS = 8 };
+
+static struct list_mpsc *g_queue;
+static struct list *g_locked;
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void *produce_mpsc(void *arg)
+{
+    struct item *items = arg;
+
+    for (size_t i = 0; i < PER_PRODUCER; i++) {
+        list_mpsc_push(g_queue, &items[i]);
+    }
+
+    return NULL;
+}
+
+static void *produce_mutex(void *arg)
+{
+    struct item *items = arg;
+
+    for (size_t i = 0; i < PER_PRODUCER; i++) {
+        pthread_mutex_lock(&g_lock);
+        list_push_back(g_locked, &items[i]);
+        pthread_mutex_unlock(&g_lock);
+    }
+
+    return NULL;
+}
+
+/// Consumer: batch drain into a private list, then release the batch.
+static void consume_mpsc(size_t total)
+{
+    struct list *batch = list_new(offsetof(struct item, link));
+
+    while (total) {
+        ssize_t n = list_mpsc_drain(g_queue, batch);
+        total -= (size_t)n;
+        while (!list_empty(batch)) {
+            bench_sink(list_pop_front(batch));
+        }
+    }
+
+    list_delete(batch, NULL);
+}
+
+/// Consumer: one element per lock acquisition.
+static void consume_mutex(size_t total)
+{
+    while (total) {
+        void *element;
+
+        pthread_mutex_lock(&g_lock);
+        element = list_pop_front(g_locked);
+        pthread_mutex_unlock(&g_lock);
+
+        if (element) {
+            bench_sink(element);
+            total--;
+        }
+    }
+}
+
+static void run(const char *name, void *(*produce)(void *), void (*consume)(size_t), struct item *items,
+                int producers)
+{
+    pthread_t tids[MAX_PRODUCERS];
+    char label[64];
+    uint64_t t;
+
+    t = bench_now_ns();
+    for (int i = 0; i < producers; i++) {
+        pthread_create(&tids[i], NULL, produce, &items[(size_t)i * PER_PRODUCER]);
+    }
+    consume((size_t)producers * PER_PRODUCER);
+    for (int i = 0; i < producers; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    t = bench_now_ns() - t;
+
+    snprintf(label, sizeof(label), "%s, %d producers", name, producers);
+    bench_report(label, (size_t)producers * PER_PRODUCER, t);
+}
+
+int main(void)
+{
+    struct item *items = calloc((size_t)MAX_PRODUCERS * PER_PRODUCER, sizeof(struct item));
+
+    g_queue = list_mpsc_new(offsetof(struct item, link));
+    g_locked = list_new(offsetof(struct item, link));
+
+    for (int producers = 1; producers <= MAX_PRODUCERS; producers *= 2) {
+        run("list_mpsc + drain", produce_mpsc, consume_mpsc, items, producers);
+        run("llist + mutex", produce_mutex, consume_mutex, items, producers);
+    }
+
+    list_delete(g_locked, NULL);
+    list_mpsc_delete(g_queue, NULL);
+    free(items);
+    return 0;
+}
@@ -0,0 +1,78 @@
+// Compare list_precedes with and without order-maintenance labels, and the labelling cost on insert.
+//
+// Usage: bench_order [elements]
+
+#include "llist.h"
+
+#include "bench.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+struct item
+{
+    long value;
+    LIST_NODE(link);
+};
+
+enum { WALKS = 100, QUERIES = 1000000, INSERTS = 1000000 };
+
+static void queries(const char *name, struct list_iter **its, size_t n, size_t count)
+{
+    unsigned seed = 1;
+    size_t yes = 0;
+    uint64_t t = bench_now_ns();
+
+    for (size_t i = 0; i < count; i++) {
+        seed = seed * 1103515245u + 12345u;
+        yes += list_precedes(its[(seed >> 4) % n], its[((size_t)seed << 8 ^ seed) % n]);
+    }
+    bench_report(name, count, bench_now_ns() - t);
+    bench_sink(&yes);
+}
+
+static void inserts(const char *name, struct list *l, struct item *items)
+{
+    struct list_iter *it = list_nth(l, list_size(l) / 2);
+    uint64_t t = bench_now_ns();
+
+    // Insert at one point, which exhausts label gaps fastest.
+    for (size_t i = 0; i < INSERTS; i++) {
+        list_insert(it, &items[i]);
+    }
+    bench_report(name, INSERTS, bench_now_ns() - t);
+
+    for (size_t i = 0; i < INSERTS; i++) {
+        list_erase(list_element(&items[i], offsetof(struct item, link)), NULL);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 0) : 1000000;
+    struct item *items = calloc(n, sizeof(struct item));
+    struct item *spare = calloc(INSERTS, sizeof(struct item));
+    struct list_iter **its = malloc(n * sizeof(*its));
+    struct list *l = list_new(offsetof(struct item, link));
+    uint64_t t;
+
+    for (size_t i = 0; i < n; i++) {
+        its[i] = list_push_back(l, &items[i]);
+    }
+
+    queries("list_precedes (walk)", its, n, WALKS);
+    inserts("list_insert (no labels)", l, spare);
+
+    t = bench_now_ns();
+    list_order_enable(l);
+    bench_report("list_order_enable", n, bench_now_ns() - t);
+
+    queries("list_precedes (labels)", its, n, QUERIES);
+    inserts("list_insert (labels)", l, spare);
+
+    list_delete(l, NULL);
+    free(its);
+    free(spare);
+    free(items);
+    return 0;
+}
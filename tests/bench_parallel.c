@@ -0,0 +1,107 @@
+// Scaling of list_parallel_for_each, list_parallel_reduce and list_parallel_count_if from 1 to N threads, with and
+// without a positional index for partitioning.
+// Usage: bench_parallel [elements] [max threads]
+
+#include "llist.h"
+#include "llist_parallel.h"
+
+#include "bench.h"
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+struct node
+{
+    unsigned key;
+    double weight;
+    LIST_NODE(link);
+};
+
+/// A few dozen cycles of independent work per element.
+static double work(const struct node *node)
+{
+    double x = node->weight;
+
+    for (int i = 0; i < 8; i++) {
+        x = x * 1.0000001 + 0.5;
+    }
+
+    return x;
+}
+
+static int visit(void *element, void *ctx)
+{
+    bench_sink((void *)(size_t)work(element));
+    (void)ctx;
+    return 0;
+}
+
+static void fold(void *acc, const void *element, void *ctx)
+{
+    (void)ctx;
+    *(double *)acc += work(element);
+}
+
+static void combine(void *acc, const void *other, void *ctx)
+{
+    (void)ctx;
+    *(double *)acc += *(const double *)other;
+}
+
+static bool pred(const void *element, void *ctx)
+{
+    (void)ctx;
+    return work(element) > 1.5e9;
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 0) : 4000000;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t max_threads = argc > 2 ? strtoul(argv[2], NULL, 0) : (size_t)(cpus > 0 ? cpus : 1);
+    struct node *nodes = calloc(n, sizeof(struct node));
+    struct list *l = list_new(offsetof(struct node, link));
+    unsigned seed = 12345;
+    char name[64];
+    uint64_t t;
+
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        nodes[i].key = seed;
+        nodes[i].weight = (double)seed;
+        list_push_back(l, &nodes[i]);
+    }
+
+    for (int indexed = 0; indexed <= 1; indexed++) {
+        if (indexed) {
+            list_index_enable(l);
+            list_nth(l, 0);
+        }
+
+        for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+            double sum = 0;
+
+            t = bench_now_ns();
+            list_parallel_for_each(l, visit, NULL, threads);
+            snprintf(name, sizeof(name), "for_each%s threads=%zu", indexed ? " indexed" : "", threads);
+            bench_report(name, n, bench_now_ns() - t);
+
+            t = bench_now_ns();
+            list_parallel_reduce(l, &sum, sizeof(sum), fold, combine, NULL, threads);
+            snprintf(name, sizeof(name), "reduce%s threads=%zu", indexed ? " indexed" : "", threads);
+            bench_report(name, n, bench_now_ns() - t);
+            bench_sink((void *)(size_t)sum);
+
+            t = bench_now_ns();
+            bench_sink((void *)list_parallel_count_if(l, pred, NULL, threads));
+            snprintf(name, sizeof(name), "count_if%s threads=%zu", indexed ? " indexed" : "", threads);
+            bench_report(name, n, bench_now_ns() - t);
+        }
+    }
+
+    list_delete(l, NULL);
+    free(nodes);
+    return 0;
+}
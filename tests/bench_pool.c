@@ -0,0 +1,77 @@
+// Compare element allocation and list teardown with malloc and with a pool.
+
+#include "llist.h"
+#include "llist_pool.h"
+
+#include "bench.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+struct item
+{
+    int value;
+    LIST_NODE(link);
+};
+
+enum { N = 1000000, ROUNDS = 5 };
+
+int main(void)
+{
+    uint64_t alloc_ns = 0;
+    uint64_t delete_ns = 0;
+    uint64_t t;
+
+    for (int r = 0; r < ROUNDS; r++) {
+        struct list *l = list_new(offsetof(struct item, link));
+
+        t = bench_now_ns();
+        for (size_t i = 0; i < N; i++) {
+            list_push_back(l, malloc(sizeof(struct item)));
+        }
+        alloc_ns += bench_now_ns() - t;
+
+        t = bench_now_ns();
+        list_delete(l, free);
+        delete_ns += bench_now_ns() - t;
+    }
+    bench_report("alloc+push (malloc)", (size_t)N * ROUNDS, alloc_ns);
+    bench_report("list_delete (free)", (size_t)N * ROUNDS, delete_ns);
+
+    alloc_ns = delete_ns = 0;
+    for (int r = 0; r < ROUNDS; r++) {
+        struct list_pool *pool = list_pool_new(sizeof(struct item));
+        struct list *l = list_new(offsetof(struct item, link));
+
+        t = bench_now_ns();
+        for (size_t i = 0; i < N; i++) {
+            list_push_back(l, list_pool_alloc(pool));
+        }
+        alloc_ns += bench_now_ns() - t;
+
+        t = bench_now_ns();
+        list_pool_release(pool, l);
+        delete_ns += bench_now_ns() - t;
+    }
+    bench_report("alloc+push (pool)", (size_t)N * ROUNDS, alloc_ns);
+    bench_report("list_pool_release", (size_t)N * ROUNDS, delete_ns);
+
+    alloc_ns = 0;
+    for (int r = 0; r < ROUNDS; r++) {
+        struct list_pool *pool = list_pool_new(sizeof(struct item));
+        struct list *l = list_new(offsetof(struct item, link));
+
+        for (size_t i = 0; i < N; i++) {
+            list_push_back(l, list_pool_alloc(pool));
+        }
+
+        t = bench_now_ns();
+        list_clear(l, list_pool_free);
+        alloc_ns += bench_now_ns() - t;
+
+        list_pool_release(pool, l);
+    }
+    bench_report("list_clear (list_pool_free)", (size_t)N * ROUNDS, alloc_ns);
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+// Compare reader throughput of RCU traversal against a rwlock and a mutex, by reader count, while one writer keeps
+// replacing elements.
+
+#include "llist_rcu.h"
+#include "llist.h"
+
+#include "bench.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+struct item
+{
+    long value;
+    LIST_NODE(link);
+};
+
+enum { ELEMENTS = 256, PASSES = 20000, MAX_READERS = 8 };
+
+enum mode { MODE_RCU, MODE_RWLOCK, MODE_MUTEX };
+
+struct shared {
+    struct list *l;
+    enum mode mode;
+    pthread_rwlock_t rwlock;
+    pthread_mutex_t mutex;
+    atomic_bool stop;
+};
+
+static struct item *make(long value)
+{
+    struct item *it = calloc(1, sizeof(struct item));
+    it->value = value;
+    return it;
+}
+
+static long sum(const struct list *l)
+{
+    long total = 0;
+
+    for (const struct list_iter *it = list_rcu_cbegin(l); it != list_cend(l); it = list_rcu_cnext(it)) {
+        total += ((const struct item *)list_at_const(it))->value;
+    }
+
+    return total;
+}
+
+static void *run_reader(void *arg)
+{
+    struct shared *s = arg;
+
+    list_rcu_register();
+
+    for (int i = 0; i < PASSES; i++) {
+        long total;
+
+        switch (s->mode) {
+        case MODE_RCU:
+            list_rcu_read_lock();
+            total = sum(s->l);
+            list_rcu_read_unlock();
+            break;
+        case MODE_RWLOCK:
+            pthread_rwlock_rdlock(&s->rwlock);
+            total = sum(s->l);
+            pthread_rwlock_unlock(&s->rwlock);
+            break;
+        default:
+            pthread_mutex_lock(&s->mutex);
+            total = sum(s->l);
+            pthread_mutex_unlock(&s->mutex);
+            break;
+        }
+
+        bench_sink((void *)total);
+    }
+
+    return NULL;
+}
+
+/// Replace the first element with a new last one, then pause; about one update per 100 reader passes.
+static void *run_writer(void *arg)
+{
+    struct shared *s = arg;
+    struct timespec pause = { .tv_nsec = 100 * 1000 };
+    long value = ELEMENTS;
+
+    while (!atomic_load(&s->stop)) {
+        switch (s->mode) {
+        case MODE_RCU:
+            list_rcu_push_back(s->l, make(value++));
+            list_rcu_erase(list_begin(s->l), free);
+            break;
+        case MODE_RWLOCK:
+            pthread_rwlock_wrlock(&s->rwlock);
+            list_push_back(s->l, make(value++));
+            list_erase(list_begin(s->l), free);
+            pthread_rwlock_unlock(&s->rwlock);
+            break;
+        default:
+            pthread_mutex_lock(&s->mutex);
+            list_push_back(s->l, make(value++));
+            list_erase(list_begin(s->l), free);
+            pthread_mutex_unlock(&s->mutex);
+            break;
+        }
+
+        nanosleep(&pause, NULL);
+    }
+
+    return NULL;
+}
+
+static void run(const char *name, enum mode mode, int readers)
+{
+    struct shared s = { .l = list_new(offsetof(struct item, link)), .mode = mode };
+    pthread_t tids[MAX_READERS];
+    pthread_t writer;
+    char label[64];
+    uint64_t t;
+
+    pthread_rwlock_init(&s.rwlock, NULL);
+    pthread_mutex_init(&s.mutex, NULL);
+    atomic_init(&s.stop, false);
+
+    for (long i = 0; i < ELEMENTS; i++) {
+        list_push_back(s.l, make(i));
+    }
+
+    pthread_create(&writer, NULL, run_writer, &s);
+
+    t = bench_now_ns();
+    for (int i = 0; i < readers; i++) {
+        pthread_create(&tids[i], NULL, run_reader, &s);
+    }
+    for (int i = 0; i < readers; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    t = bench_now_ns() - t;
+
+    atomic_store(&s.stop, true);
+    pthread_join(writer, NULL);
+
+    snprintf(label, sizeof(label), "%s, %d readers", name, readers);
+    bench_report(label, (size_t)PASSES * (size_t)readers, t);
+
+    list_rcu_synchronize();
+    list_delete(s.l, free);
+    pthread_rwlock_destroy(&s.rwlock);
+    pthread_mutex_destroy(&s.mutex);
+}
+
+int main(void)
+{
+    printf("Cost of one traversal of %d elements:\n", ELEMENTS);
+
+    for (int readers = 1; readers <= MAX_READERS; readers *= 2) {
+        run("rcu", MODE_RCU, readers);
+        run("rwlock", MODE_RWLOCK, readers);
+        run("mutex", MODE_MUTEX, readers);
+    }
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+// Compare FIFO queue throughput of slist and llist.
+
+#include "llist.h"
+#include "slist.h"
+
+#include "bench.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+struct item
+{
+    int value;
+    LIST_NODE(link);
+};
+
+struct item_slist
+{
+    int value;
+    SLIST_NODE(link);
+};
+
+enum { N = 1000000, DEPTH = 64, ROUNDS = 10 };
+
+int main(void)
+{
+    struct item *items = calloc(N, sizeof(struct item));
+    struct item_slist *sitems = calloc(N, sizeof(struct item_slist));
+    struct list *l = list_new(offsetof(struct item, link));
+    struct slist *q = slist_new(offsetof(struct item_slist, link));
+    uint64_t t;
+
+    printf("%-40s %10zu bytes\n", "sizeof(struct list_node)", sizeof(struct list_node));
+    printf("%-40s %10zu bytes\n", "sizeof(struct slist_node)", sizeof(struct slist_node));
+
+    // Fill, then drain.
+    t = bench_now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (size_t i = 0; i < N; i++) {
+            list_push_back(l, &items[i]);
+        }
+        while (!list_empty(l)) {
+            bench_sink(list_pop_front(l));
+        }
+    }
+    bench_report("fill+drain (llist)", (size_t)N * ROUNDS, bench_now_ns() - t);
+
+    t = bench_now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (size_t i = 0; i < N; i++) {
+            slist_push_back(q, &sitems[i]);
+        }
+        while (!slist_empty(q)) {
+            bench_sink(slist_pop_front(q));
+        }
+    }
+    bench_report("fill+drain (slist)", (size_t)N * ROUNDS, bench_now_ns() - t);
+
+    // Steady state at a shallow queue depth.
+    for (size_t i = 0; i < DEPTH; i++) {
+        list_push_back(l, &items[i]);
+        slist_push_back(q, &sitems[i]);
+    }
+
+    t = bench_now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (size_t i = DEPTH; i < N; i++) {
+            list_push_back(l, &items[i]);
+            bench_sink(list_pop_front(l));
+        }
+        while (!list_empty(l)) {
+            list_pop_front(l);
+        }
+        for (size_t i = 0; i < DEPTH; i++) {
+            list_push_back(l, &items[i]);
+        }
+    }
+    bench_report("push+pop depth 64 (llist)", (size_t)(N - DEPTH) * ROUNDS, bench_now_ns() - t);
+
+    t = bench_now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (size_t i = DEPTH; i < N; i++) {
+            slist_push_back(q, &sitems[i]);
+            bench_sink(slist_pop_front(q));
+        }
+        while (!slist_empty(q)) {
+            slist_pop_front(q);
+        }
+        for (size_t i = 0; i < DEPTH; i++) {
+            slist_push_back(q, &sitems[i]);
+        }
+    }
+    bench_report("push+pop depth 64 (slist)", (size_t)(N - DEPTH) * ROUNDS, bench_now_ns() - t);
+
+    list_delete(l, NULL);
+    slist_delete(q, NULL);
+    free(items);
+    free(sitems);
+    return 0;
+}
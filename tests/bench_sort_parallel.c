@@ -0,0 +1,66 @@
+// Scaling of list_sort_parallel from 1 to N threads, compared with list_sort.
+// Usage: bench_sort_parallel [elements] [max threads]
+
+#include "llist.h"
+#include "llist_parallel.h"
+
+#include "bench.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+struct node
+{
+    unsigned key;
+    LIST_NODE(link);
+};
+
+static int cmp_key(const void *a, const void *b)
+{
+    const struct node *x = a;
+    const struct node *y = b;
+    return (x->key > y->key) - (x->key < y->key);
+}
+
+/// Fill @c l with @c n nodes in a reproducible random key order.
+static void fill(struct list *l, struct node *nodes, size_t n)
+{
+    unsigned seed = 12345;
+
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        nodes[i].key = seed;
+        list_push_back(l, &nodes[i]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 0) : 4000000;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t max_threads = argc > 2 ? strtoul(argv[2], NULL, 0) : (size_t)(cpus > 0 ? cpus : 1);
+    struct node *nodes = calloc(n, sizeof(struct node));
+    struct list *l = list_new(offsetof(struct node, link));
+    char name[64];
+    uint64_t t;
+
+    fill(l, nodes, n);
+    t = bench_now_ns();
+    list_sort(l, cmp_key);
+    bench_report("list_sort", n, bench_now_ns() - t);
+    list_clear(l, NULL);
+
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        fill(l, nodes, n);
+        t = bench_now_ns();
+        list_sort_parallel(l, cmp_key, threads);
+        snprintf(name, sizeof(name), "list_sort_parallel threads=%zu", threads);
+        bench_report(name, n, bench_now_ns() - t);
+        list_clear(l, NULL);
+    }
+
+    list_delete(l, NULL);
+    free(nodes);
+    return 0;
+}
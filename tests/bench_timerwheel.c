@@ -0,0 +1,104 @@
+// Cost of timer operations with 1M active timers: the timing wheel against a list kept sorted by expiry.
+// Usage: bench_timerwheel [timers] [horizon ticks]
+
+#include "timerwheel.h"
+#include "llist.h"
+
+#include "bench.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+struct timer
+{
+    TIMERWHEEL_NODE(node);
+};
+
+static size_t g_expired;
+static size_t g_batches;
+
+static void on_expire(struct list *batch, void *ctx)
+{
+    (void)ctx;
+    g_expired += list_size(batch);
+    g_batches++;
+}
+
+static int cmp_expires(const void *a, const void *b)
+{
+    uint64_t x = ((const struct timer *)a)->node.expires;
+    uint64_t y = ((const struct timer *)b)->node.expires;
+    return (x > y) - (x < y);
+}
+
+static uint64_t rand_tick(unsigned *seed, uint64_t horizon)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return 1 + (uint64_t)(*seed >> 4) % horizon;
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 0) : 1000000;
+    uint64_t horizon = argc > 2 ? strtoull(argv[2], NULL, 0) : 100000;
+    struct timer *timers = calloc(n, sizeof(struct timer));
+    struct timerwheel *w = timerwheel_new(offsetof(struct timer, node), 0, on_expire, NULL);
+    struct list *sorted = list_new(offsetof(struct timer, node));
+    size_t sample = n < 100 ? n : 100;
+    unsigned seed = 1;
+    uint64_t t;
+
+    t = bench_now_ns();
+    for (size_t i = 0; i < n; i++) {
+        timerwheel_schedule(w, &timers[i], rand_tick(&seed, horizon));
+    }
+    bench_report("wheel schedule", n, bench_now_ns() - t);
+
+    t = bench_now_ns();
+    for (size_t i = 0; i < n; i++) {
+        timerwheel_schedule(w, &timers[i], rand_tick(&seed, horizon));
+    }
+    bench_report("wheel reschedule", n, bench_now_ns() - t);
+
+    t = bench_now_ns();
+    for (size_t i = 0; i < n; i += 10) {
+        timerwheel_cancel(w, &timers[i]);
+    }
+    bench_report("wheel cancel", n / 10, bench_now_ns() - t);
+
+    t = bench_now_ns();
+    timerwheel_advance(w, horizon);
+    t = bench_now_ns() - t;
+    printf("%-40s %10.2f ns/op  (%zu timers in %zu batches over %llu ticks)\n", "wheel expire",
+           (double)t / (double)g_expired, g_expired, g_batches, (unsigned long long)horizon);
+
+    // Sorted list baseline: insertion walks from the front to the first later timer.
+    timerwheel_delete(w, NULL);
+    for (size_t i = sample; i < n; i++) {
+        timers[i].node.expires = rand_tick(&seed, horizon);
+        list_push_back(sorted, &timers[i]);
+    }
+    list_sort(sorted, cmp_expires);
+
+    t = bench_now_ns();
+    for (size_t i = 0; i < sample; i++) {
+        struct list_iter *it = list_begin(sorted);
+
+        timers[i].node.expires = rand_tick(&seed, horizon);
+        while (it != list_end(sorted) && cmp_expires(list_at(it), &timers[i]) <= 0) {
+            it = list_next(it);
+        }
+        list_insert(it, &timers[i]);
+    }
+    bench_report("sorted list schedule", sample, bench_now_ns() - t);
+
+    t = bench_now_ns();
+    while (!list_empty(sorted)) {
+        bench_sink(list_pop_front(sorted));
+    }
+    bench_report("sorted list expire", n, bench_now_ns() - t);
+
+    list_delete(sorted, NULL);
+    free(timers);
+    return 0;
+}
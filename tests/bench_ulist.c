@@ -0,0 +1,121 @@
+// Compare sequential scan and mid-list insertion of ulist and llist.
+
+#include "llist.h"
+#include "ulist.h"
+
+#include "bench.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+struct item
+{
+    long value;
+    LIST_NODE(link);
+};
+
+enum { N = 2000000, INSERTS = 100000, ROUNDS = 5 };
+
+int main(void)
+{
+    struct item *items = calloc(N + INSERTS, sizeof(struct item));
+    size_t *order = malloc(N * sizeof(size_t));
+    struct list *l = list_new(offsetof(struct item, link));
+    struct ulist *u = ulist_new();
+    unsigned seed = 1;
+    long total;
+    uint64_t t;
+
+    // Shuffled allocation order, as for elements allocated over time.
+    for (size_t i = 0; i < N; i++) {
+        order[i] = i;
+    }
+    for (size_t i = N - 1; i > 0; i--) {
+        size_t j;
+        size_t tmp;
+        seed = seed * 1103515245u + 12345u;
+        j = ((size_t)seed << 16 ^ (size_t)(seed >> 8)) % (i + 1);
+        tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+
+    for (size_t i = 0; i < N; i++) {
+        items[order[i]].value = (long)i;
+        list_push_back(l, &items[order[i]]);
+        ulist_push_back(u, &items[order[i]]);
+    }
+
+    total = 0;
+    t = bench_now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (struct list_iter *it = list_begin(l); it != list_end(l); it = list_next(it)) {
+            total += ((struct item *)list_at(it))->value;
+        }
+    }
+    bench_report("scan (llist)", (size_t)N * ROUNDS, bench_now_ns() - t);
+    bench_sink(&total);
+
+    total = 0;
+    t = bench_now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        struct ulist_iter end = ulist_end(u);
+        for (struct ulist_iter it = ulist_begin(u); !ulist_iter_equal(it, end); it = ulist_next(it)) {
+            total += ((struct item *)ulist_at(it))->value;
+        }
+    }
+    bench_report("scan (ulist)", (size_t)N * ROUNDS, bench_now_ns() - t);
+    bench_sink(&total);
+
+    // Pointer-only scan, where ulist avoids touching the elements' list nodes.
+    total = 0;
+    t = bench_now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (struct list_iter *it = list_begin(l); it != list_end(l); it = list_next(it)) {
+            total += (long)(size_t)list_at(it);
+        }
+    }
+    bench_report("scan pointers (llist)", (size_t)N * ROUNDS, bench_now_ns() - t);
+    bench_sink(&total);
+
+    total = 0;
+    t = bench_now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        struct ulist_iter end = ulist_end(u);
+        for (struct ulist_iter it = ulist_begin(u); !ulist_iter_equal(it, end); it = ulist_next(it)) {
+            total += (long)(size_t)ulist_at(it);
+        }
+    }
+    bench_report("scan pointers (ulist)", (size_t)N * ROUNDS, bench_now_ns() - t);
+    bench_sink(&total);
+
+    // Insert in the middle, at a cursor that walks forward.
+    {
+        struct list_iter *it = list_advance(list_begin(l), N / 2);
+        t = bench_now_ns();
+        for (size_t i = 0; i < INSERTS; i++) {
+            list_insert(it, &items[N + i]);
+            it = list_next(it);
+        }
+        bench_report("mid insert (llist)", INSERTS, bench_now_ns() - t);
+    }
+
+    {
+        struct ulist_iter it = ulist_begin(u);
+        for (size_t i = 0; i < N / 2; i++) {
+            it = ulist_next(it);
+        }
+        t = bench_now_ns();
+        for (size_t i = 0; i < INSERTS; i++) {
+            ulist_insert(&it, &items[N + i]);
+            it = ulist_next(it);
+        }
+        bench_report("mid insert (ulist)", INSERTS, bench_now_ns() - t);
+    }
+
+    list_delete(l, NULL);
+    ulist_delete(u, NULL);
+    free(order);
+    free(items);
+    return 0;
+}
@@ -2,6 +2,8 @@
 
 #include <dlfcn.h>
 #include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -12,9 +14,12 @@ static void * (*g_libc_calloc)(size_t, size_t);
 static char * (*g_libc_strdup)(const char *);
 static char * (*g_libc_strndup)(const char *, size_t);
 static void * (*g_libc_realloc)(void *, size_t);
+static int (*g_libc_posix_memalign)(void **, size_t, size_t);
+static int (*g_libc_pthread_create)(pthread_t *, const pthread_attr_t *, void *(*)(void *), void *);
 
-static unsigned count_;
-static unsigned n_;
+// Atomic, since the concurrent containers allocate from several threads at once.
+static atomic_uint count_;
+static atomic_uint n_;
 
 void memory_shim_reset(void)
 {
@@ -107,3 +112,30 @@ void *realloc(void *ptr, size_t size)
     errno = ENOMEM;
     return NULL;
 }
+
+int posix_memalign(void **ptr, size_t alignment, size_t size)
+{
+    if (!g_libc_posix_memalign) {
+        g_libc_posix_memalign = (int (*)(void **, size_t, size_t))dlsym(RTLD_NEXT, "posix_memalign");
+    }
+
+    if (allow()) {
+        return g_libc_posix_memalign(ptr, alignment, size);
+    }
+
+    return ENOMEM;
+}
+
+/// Thread creation allocates a stack, so it is subject to simulated failure too.
+int pthread_create(pthread_t *thread, const pthread_attr_t *attr, void *(*start)(void *), void *arg)
+{
+    if (!g_libc_pthread_create) {
+        g_libc_pthread_create = (int (*)(pthread_t *, const pthread_attr_t *, void *(*)(void *), void *))dlsym(RTLD_NEXT, "pthread_create");
+    }
+
+    if (allow()) {
+        return g_libc_pthread_create(thread, attr, start, arg);
+    }
+
+    return EAGAIN;
+}
@@ -0,0 +1,402 @@
+#include "clist.h"
+
+#include "memory_shim.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "clist.c"
+#include "llist_epoch.c"
+
+struct node
+{
+    int n;
+    CLIST_NODE(link);
+};
+
+enum { THREADS = 4, KEYS = 64, OPS = 20000 };
+
+static int cmp_node(const void *a, const void *b)
+{
+    const struct node *x = a;
+    const struct node *y = b;
+    return (x->n > y->n) - (x->n < y->n);
+}
+
+static struct node *make_n(int n)
+{
+    struct node *node = calloc(1, sizeof(struct node));
+    node->n = n;
+    return node;
+}
+
+static atomic_int destroyed;
+
+static void destroy(void *element)
+{
+    atomic_fetch_add(&destroyed, 1);
+    free(element);
+}
+
+/// Record visited values in ascending order.
+struct visit {
+    int values[KEYS];
+    size_t count;
+    int stop_at;
+};
+
+static int visit_fn(void *element, void *ctx)
+{
+    struct visit *v = ctx;
+    int n = ((struct node *)element)->n;
+
+    v->values[v->count++] = n;
+    return n == v->stop_at ? n : 0;
+}
+
+static void test_registration_failure(void)
+{
+    // Must run first: the main thread registers with the epoch module on its first operation.
+    struct clist *l = clist_new(offsetof(struct node, link), cmp_node);
+    struct node key = { .n = 1 };
+    struct visit v = { .stop_at = -1 };
+
+    memory_shim_fail_at(1);
+    assert(-ENOMEM == clist_insert(l, &key));
+    memory_shim_fail_at(1);
+    errno = 0;
+    assert(!clist_contains(l, &key));
+    assert(ENOMEM == errno);
+    memory_shim_fail_at(1);
+    assert(-ENOMEM == clist_for_each(l, visit_fn, &v));
+    memory_shim_fail_at(1);
+    assert(-ENOMEM == clist_remove(l, &key, NULL));
+    memory_shim_fail_at(2);
+    assert(-ENOMEM == clist_remove(l, &key, NULL));
+    memory_shim_reset();
+
+    assert(0 == clist_size(l));
+    clist_delete(l, NULL);
+}
+
+static void test_clist_new(void)
+{
+    struct clist *l;
+
+    errno = 0;
+    assert(NULL == clist_new(offsetof(struct node, link), NULL));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == clist_new(1, cmp_node));
+    assert(EINVAL == errno);
+
+    memory_shim_fail_at(1);
+    errno = 0;
+    l = clist_new(offsetof(struct node, link), cmp_node);
+    memory_shim_reset();
+    assert(NULL == l);
+    assert(ENOMEM == errno);
+
+    l = clist_new(offsetof(struct node, link), cmp_node);
+    assert(l);
+    assert(0 == clist_size(l));
+    assert(0 == clist_size(NULL));
+    clist_delete(l, NULL);
+    clist_delete(NULL, NULL);
+}
+
+static void test_clist_ops(void)
+{
+    struct clist *l = clist_new(offsetof(struct node, link), cmp_node);
+    struct node key = { .n = 0 };
+    struct visit v = { .stop_at = -1 };
+    const int order[] = { 5, 1, 9, 3, 7 };
+    struct node *dup = make_n(5);
+    struct node *nodes[5];
+
+    assert(-EFAULT == clist_insert(NULL, dup));
+    assert(-EFAULT == clist_insert(l, NULL));
+    assert(-EFAULT == clist_remove(NULL, &key, NULL));
+    assert(-EFAULT == clist_remove(l, NULL, NULL));
+    assert(-EFAULT == clist_for_each(NULL, visit_fn, &v));
+    assert(-EFAULT == clist_for_each(l, NULL, &v));
+    errno = 0;
+    assert(!clist_contains(NULL, &key));
+    assert(EFAULT == errno);
+    errno = 0;
+    assert(!clist_contains(l, NULL));
+    assert(EFAULT == errno);
+
+    for (size_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+        nodes[i] = make_n(order[i]);
+        assert(0 == clist_insert(l, nodes[i]));
+    }
+    assert(-EEXIST == clist_insert(l, dup));
+    free(dup);
+    assert(5 == clist_size(l));
+
+    // Sorted traversal.
+    assert(0 == clist_for_each(l, visit_fn, &v));
+    assert(5 == v.count);
+    for (size_t i = 0; i < v.count; i++) {
+        assert((int)(2 * i + 1) == v.values[i]);
+    }
+
+    // Early stop.
+    v = (struct visit){ .stop_at = 3 };
+    assert(3 == clist_for_each(l, visit_fn, &v));
+    assert(2 == v.count);
+
+    key.n = 7;
+    assert(clist_contains(l, &key));
+    key.n = 4;
+    assert(!clist_contains(l, &key));
+    key.n = 100;
+    assert(!clist_contains(l, &key));
+
+    key.n = 4;
+    assert(-ENOENT == clist_remove(l, &key, destroy));
+    key.n = 100;
+    assert(-ENOENT == clist_remove(l, &key, destroy));
+
+    atomic_store(&destroyed, 0);
+    key.n = 7;
+    assert(0 == clist_remove(l, &key, destroy));
+    assert(!clist_contains(l, &key));
+    assert(4 == clist_size(l));
+    clist_synchronize();
+    assert(1 == atomic_load(&destroyed));
+
+    // The caller regains ownership after a grace period.
+    key.n = 1;
+    assert(0 == clist_remove(l, &key, NULL));
+    clist_synchronize();
+    assert(1 == atomic_load(&destroyed));
+    free(nodes[1]);
+
+    clist_delete(l, free);
+}
+
+static void test_clist_marked(void)
+{
+    struct clist *l = clist_new(offsetof(struct node, link), cmp_node);
+    struct node *a = make_n(1);
+    struct node *b = make_n(2);
+    struct visit v = { .stop_at = -1 };
+
+    assert(0 == clist_insert(l, a));
+    assert(0 == clist_insert(l, b));
+
+    // A node marked by a remove in progress is already absent to readers.
+    atomic_store(&a->link.marked, true);
+    assert(!clist_contains(l, a));
+    assert(0 == clist_for_each(l, visit_fn, &v));
+    assert(1 == v.count);
+    assert(2 == v.values[0]);
+
+    // Validation fails for a marked node, or nodes no longer adjacent; neither is left locked.
+    assert(!impl_lock_validate(&l->head, &a->link));
+    assert(!impl_lock_validate(&l->head, &b->link));
+    atomic_store(&a->link.marked, false);
+    assert(impl_lock_validate(&l->head, &a->link));
+    impl_unlock(&a->link);
+    impl_unlock(&l->head);
+
+    clist_delete(l, free);
+}
+
+static int remove_visited(void *element, void *ctx)
+{
+    struct clist *l = ctx;
+
+    // The visited node stays readable until the traversal ends.
+    assert(0 == clist_remove(l, element, destroy));
+    return 0;
+}
+
+static void test_clist_remove_during_for_each(void)
+{
+    struct clist *l = clist_new(offsetof(struct node, link), cmp_node);
+
+    for (int i = 0; i < 10; i++) {
+        assert(0 == clist_insert(l, make_n(i)));
+    }
+
+    atomic_store(&destroyed, 0);
+    assert(0 == clist_for_each(l, remove_visited, l));
+    assert(0 == clist_size(l));
+    clist_synchronize();
+    assert(10 == atomic_load(&destroyed));
+
+    clist_delete(l, free);
+}
+
+static void test_clist_batched_reclaim(void)
+{
+    struct clist *l = clist_new(offsetof(struct node, link), cmp_node);
+
+    for (int i = 0; i < 200; i++) {
+        assert(0 == clist_insert(l, make_n(i)));
+    }
+
+    // Each thread collects its own retirements in batches, without waiting for a grace period.
+    atomic_store(&destroyed, 0);
+    for (int i = 0; i < 200; i++) {
+        struct node key = { .n = i };
+        assert(0 == clist_remove(l, &key, destroy));
+    }
+    assert(atomic_load(&destroyed) >= LIST_EPOCH_BATCH);
+    assert(atomic_load(&destroyed) < 200);
+
+    clist_synchronize();
+    assert(200 == atomic_load(&destroyed));
+
+    clist_delete(l, free);
+}
+
+static void *remove_one(void *arg)
+{
+    struct clist *l = arg;
+    struct node key = { .n = 1 };
+
+    assert(0 == clist_remove(l, &key, destroy));
+    return NULL;
+}
+
+static void *retire_unregistered(void *arg)
+{
+    // A thread without a record hands the element straight to the next collector.
+    list_epoch_retire(malloc(sizeof(struct list_epoch_retired)), arg, destroy);
+    return NULL;
+}
+
+static void test_clist_orphans(void)
+{
+    struct clist *l = clist_new(offsetof(struct node, link), cmp_node);
+    pthread_t thread;
+
+    assert(0 == clist_insert(l, make_n(1)));
+    atomic_store(&destroyed, 0);
+
+    // Pending elements of an exiting thread outlive it, and are destroyed by a later collection.
+    assert(0 == pthread_create(&thread, NULL, remove_one, l));
+    assert(0 == pthread_join(thread, NULL));
+    assert(0 == pthread_create(&thread, NULL, retire_unregistered, make_n(2)));
+    assert(0 == pthread_join(thread, NULL));
+    assert(0 == atomic_load(&destroyed));
+
+    clist_synchronize();
+    assert(2 == atomic_load(&destroyed));
+
+    clist_delete(l, free);
+}
+
+static void *insert_one(void *arg)
+{
+    struct clist *l = arg;
+    assert(0 == clist_insert(l, make_n(1)));
+    return NULL;
+}
+
+static void test_clist_lock_contention(void)
+{
+    struct clist *l = clist_new(offsetof(struct node, link), cmp_node);
+    struct timespec pause = { .tv_nsec = 20 * 1000 * 1000 };
+    pthread_t thread;
+
+    // Hold the head lock, so that the inserter spins, then yields.
+    impl_lock(&l->head);
+    assert(0 == pthread_create(&thread, NULL, insert_one, l));
+    nanosleep(&pause, NULL);
+    impl_unlock(&l->head);
+    assert(0 == pthread_join(thread, NULL));
+    assert(1 == clist_size(l));
+
+    clist_delete(l, free);
+}
+
+struct worker {
+    struct clist *l;
+    unsigned seed;
+    long inserted;
+    long removed;
+};
+
+static void *worker_run(void *arg)
+{
+    struct worker *w = arg;
+    struct node key;
+
+    for (int i = 0; i < OPS; i++) {
+        int n = (int)(rand_r(&w->seed) % KEYS);
+        unsigned op = rand_r(&w->seed) % 4;
+
+        key.n = n;
+        if (op == 0) {
+            struct node *node = make_n(n);
+            if (clist_insert(w->l, node) == 0) {
+                w->inserted++;
+            } else {
+                free(node);
+            }
+        } else if (op == 1) {
+            if (clist_remove(w->l, &key, destroy) == 0) {
+                w->removed++;
+            }
+        } else if (op == 2) {
+            clist_contains(w->l, &key);
+        } else {
+            struct visit v = { .stop_at = -1 };
+            assert(0 == clist_for_each(w->l, visit_fn, &v));
+            for (size_t j = 1; j < v.count; j++) {
+                assert(v.values[j - 1] < v.values[j]);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static void test_clist_concurrent(void)
+{
+    struct clist *l = clist_new(offsetof(struct node, link), cmp_node);
+    struct worker workers[THREADS];
+    pthread_t threads[THREADS];
+    long balance = 0;
+
+    for (int i = 0; i < THREADS; i++) {
+        workers[i] = (struct worker){ .l = l, .seed = (unsigned)i + 1 };
+        assert(0 == pthread_create(&threads[i], NULL, worker_run, &workers[i]));
+    }
+    for (int i = 0; i < THREADS; i++) {
+        assert(0 == pthread_join(threads[i], NULL));
+        balance += workers[i].inserted - workers[i].removed;
+    }
+
+    assert((size_t)balance == clist_size(l));
+
+    // Worker records are reused by later threads.
+    assert(0 == pthread_create(&threads[0], NULL, worker_run, &workers[0]));
+    assert(0 == pthread_join(threads[0], NULL));
+
+    clist_synchronize();
+    clist_delete(l, free);
+}
+
+int main(void)
+{
+    test_registration_failure();
+    test_clist_new();
+    test_clist_ops();
+    test_clist_marked();
+    test_clist_remove_during_for_each();
+    test_clist_batched_reclaim();
+    test_clist_orphans();
+    test_clist_lock_contention();
+    test_clist_concurrent();
+    return 0;
+}
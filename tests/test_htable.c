@@ -0,0 +1,294 @@
+#include "htable.h"
+
+#include "memory_shim.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+
+#include "htable.c"
+
+struct node
+{
+    HTABLE_NODE(link);
+    int key;
+};
+
+static size_t hash_key(const void *key)
+{
+    return (size_t)*(const int *)key;
+}
+
+/// Forces every key into the same bucket.
+static size_t hash_zero(const void *key)
+{
+    (void)key;
+    return 0;
+}
+
+static int cmp_key(const void *a, const void *b)
+{
+    return *(const int *)a != *(const int *)b;
+}
+
+static struct node *make_n(int key)
+{
+    struct node *node = calloc(1, sizeof(struct node));
+    node->key = key;
+    return node;
+}
+
+static struct htable *make_t(size_t (*hash)(const void *))
+{
+    return htable_new(offsetof(struct node, link), offsetof(struct node, key), hash, cmp_key);
+}
+
+static int sum_keys(void *element, void *ctx)
+{
+    *(int *)ctx += ((struct node *)element)->key;
+    return 0;
+}
+
+static int stop_at_key(void *element, void *ctx)
+{
+    return ((struct node *)element)->key == *(int *)ctx ? 7 : 0;
+}
+
+static int erase_odd(void *element, void *ctx)
+{
+    if (((struct node *)element)->key % 2) {
+        assert(0 == htable_erase(ctx, element));
+        free(element);
+    }
+    return 0;
+}
+
+static void test_htable_new(void)
+{
+    struct htable *t;
+
+    errno = 0;
+    assert(NULL == htable_new(0, 0, NULL, cmp_key));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == htable_new(0, 0, hash_key, NULL));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == htable_new(1, 0, hash_key, cmp_key));
+    assert(EINVAL == errno);
+
+    for (unsigned nth = 1; nth <= 2; nth++) {
+        memory_shim_fail_at(nth);
+        errno = 0;
+        t = make_t(hash_key);
+        memory_shim_reset();
+        assert(NULL == t);
+        assert(ENOMEM == errno);
+    }
+
+    t = make_t(hash_key);
+    assert(t);
+    assert(0 == htable_size(t));
+    assert(0 == htable_size(NULL));
+    htable_delete(t, free);
+    htable_delete(NULL, NULL);
+}
+
+static void test_htable_ops(void)
+{
+    struct htable *t = make_t(hash_key);
+    struct node *dup = make_n(2);
+    struct node loose = { .key = 9 };
+    struct node *node;
+    int key = 0;
+
+    assert(-EFAULT == htable_insert(NULL, dup));
+    assert(-EFAULT == htable_insert(t, NULL));
+    assert(-EFAULT == htable_erase(NULL, dup));
+    assert(-EFAULT == htable_erase(t, NULL));
+    assert(-EFAULT == htable_for_each(NULL, sum_keys, &key));
+    assert(-EFAULT == htable_for_each(t, NULL, &key));
+    errno = 0;
+    assert(NULL == htable_find(NULL, &key));
+    assert(EFAULT == errno);
+    errno = 0;
+    assert(NULL == htable_find(t, NULL));
+    assert(EFAULT == errno);
+    errno = 0;
+    assert(NULL == htable_remove(NULL, &key));
+    assert(EFAULT == errno);
+
+    for (int i = 1; i <= 4; i++) {
+        assert(0 == htable_insert(t, make_n(i)));
+    }
+    assert(-EEXIST == htable_insert(t, dup));
+    assert(4 == htable_size(t));
+
+    // Hits and misses.
+    key = 3;
+    node = htable_find(t, &key);
+    assert(3 == node->key);
+    key = 7;
+    errno = 0;
+    assert(NULL == htable_find(t, &key));
+    assert(ENOENT == errno);
+    errno = 0;
+    assert(NULL == htable_remove(t, &key));
+    assert(ENOENT == errno);
+
+    // Traversal.
+    key = 0;
+    assert(0 == htable_for_each(t, sum_keys, &key));
+    assert(10 == key);
+    key = 2;
+    assert(7 == htable_for_each(t, stop_at_key, &key));
+
+    // Remove returns ownership.
+    key = 3;
+    assert(node == htable_remove(t, &key));
+    assert(!node->link.link.next);
+    assert(3 == htable_size(t));
+    assert(-EINVAL == htable_erase(t, node));
+    assert(-EINVAL == htable_erase(t, &loose));
+
+    // Erase needs no lookup.
+    assert(0 == htable_insert(t, node));
+    assert(0 == htable_erase(t, node));
+    assert(3 == htable_size(t));
+    free(node);
+
+    // Overflow.
+    t->size = SIZE_MAX;
+    assert(-EOVERFLOW == htable_insert(t, dup));
+    t->size = 3;
+    free(dup);
+
+    htable_delete(t, free);
+}
+
+static void test_htable_collisions(void)
+{
+    struct htable *t = make_t(hash_zero);
+    int key;
+
+    for (int i = 0; i < 8; i++) {
+        assert(0 == htable_insert(t, make_n(i)));
+    }
+
+    // Unlink from the middle, the head and the tail of one chain.
+    key = 4;
+    free(htable_remove(t, &key));
+    key = 7;
+    free(htable_remove(t, &key));
+    key = 0;
+    free(htable_remove(t, &key));
+    assert(5 == htable_size(t));
+
+    for (key = 1; key < 7; key++) {
+        assert((key == 4) == (NULL == htable_find(t, &key)));
+    }
+
+    htable_delete(t, free);
+}
+
+static void test_htable_grow(void)
+{
+    struct htable *t = make_t(hash_key);
+    struct node *nodes[17];
+    int key = 0;
+
+    // The seventeenth element starts a rehash.
+    for (int i = 0; i < 17; i++) {
+        nodes[i] = make_n(i);
+        assert(0 == htable_insert(t, nodes[i]));
+    }
+    assert(31 == t->cur.mask);
+    assert(t->old.heads);
+    assert(15 == t->old.mask);
+    assert(0 == t->migrated);
+
+    // Each lookup rehashes a few old buckets; elements are found on both sides.
+    key = 0;
+    assert(nodes[0] == htable_find(t, &key));
+    assert(HTABLE_REHASH_STEP == t->migrated);
+    key = 14;
+    assert(nodes[14] == htable_remove(t, &key));
+    free(nodes[14]);
+    assert(2 * HTABLE_REHASH_STEP == t->migrated);
+
+    // New elements go to whichever side their bucket is on.
+    assert(0 == htable_insert(t, make_n(47)));
+    assert(3 * HTABLE_REHASH_STEP == t->migrated);
+    assert(t->old.heads[15].next != &t->old.heads[15]);
+    key = 0;
+    assert(0 == htable_for_each(t, sum_keys, &key));
+    assert(136 - 14 + 47 == key);
+    key = 13;
+    assert(7 == htable_for_each(t, stop_at_key, &key));
+
+    // Erase does not rehash.
+    assert(0 == htable_erase(t, nodes[15]));
+    free(nodes[15]);
+    assert(3 * HTABLE_REHASH_STEP == t->migrated);
+
+    // The last step releases the old buckets.
+    key = 47;
+    assert(47 == ((struct node *)htable_find(t, &key))->key);
+    assert(!t->old.heads);
+    assert(0 == t->migrated);
+    assert(16 == htable_size(t));
+
+    htable_delete(t, free);
+}
+
+static void test_htable_large(void)
+{
+    struct htable *t = make_t(hash_key);
+    int key = 0;
+
+    for (int i = 0; i < 1000; i++) {
+        assert(0 == htable_insert(t, make_n(i)));
+    }
+    assert(1023 == t->cur.mask);
+
+    for (int i = 0; i < 1000; i++) {
+        key = i;
+        assert(i == ((struct node *)htable_find(t, &key))->key);
+    }
+
+    // Erasing from within the traversal.
+    assert(0 == htable_for_each(t, erase_odd, t));
+    assert(500 == htable_size(t));
+    key = 0;
+    assert(0 == htable_for_each(t, sum_keys, &key));
+    assert(249500 == key);
+
+    // Without memory for more buckets, chains grow longer.
+    for (int i = 1000; i < 2100; i++) {
+        struct node *node = make_n(i);
+        memory_shim_fail_at(1);
+        assert(0 == htable_insert(t, node));
+        memory_shim_reset();
+    }
+    assert(1023 == t->cur.mask);
+    key = 2050;
+    assert(2050 == ((struct node *)htable_find(t, &key))->key);
+
+    // Deleting mid-rehash destroys elements on both sides.
+    assert(0 == htable_insert(t, make_n(3000)));
+    assert(2047 == t->cur.mask);
+    assert(t->old.heads);
+    htable_delete(t, free);
+}
+
+int main(void)
+{
+    test_htable_new();
+    test_htable_ops();
+    test_htable_collisions();
+    test_htable_grow();
+    test_htable_large();
+    return 0;
+}
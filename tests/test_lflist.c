@@ -0,0 +1,405 @@
+#include "lflist.h"
+
+#include "memory_shim.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "lflist.c"
+#include "llist_epoch.c"
+
+struct node
+{
+    int n;
+    LFLIST_NODE(link);
+};
+
+enum { THREADS = 4, KEYS = 64, OPS = 20000 };
+
+/// When set, called once from cmp_node on comparing the element valued @c g_hook_at, to simulate a concurrent update
+/// that lands at that moment.
+static void (*g_hook)(void);
+static int g_hook_at;
+static struct lflist *g_list;
+
+static int cmp_node(const void *a, const void *b)
+{
+    const struct node *x = a;
+    const struct node *y = b;
+
+    if (g_hook && x->n == g_hook_at) {
+        void (*hook)(void) = g_hook;
+        g_hook = NULL;
+        hook();
+    }
+
+    return (x->n > y->n) - (x->n < y->n);
+}
+
+static struct node *make_n(int n)
+{
+    struct node *node = calloc(1, sizeof(struct node));
+    node->n = n;
+    return node;
+}
+
+static atomic_int destroyed;
+
+static void destroy(void *element)
+{
+    atomic_fetch_add(&destroyed, 1);
+    free(element);
+}
+
+/// Record visited values in ascending order.
+struct visit {
+    int values[KEYS];
+    size_t count;
+    int stop_at;
+};
+
+static int visit_fn(void *element, void *ctx)
+{
+    struct visit *v = ctx;
+    int n = ((struct node *)element)->n;
+
+    v->values[v->count++] = n;
+    return n == v->stop_at ? n : 0;
+}
+
+static void test_registration_failure(void)
+{
+    // Must run first: the main thread registers with the epoch module on its first operation.
+    struct lflist *l = lflist_new(offsetof(struct node, link), cmp_node);
+    struct node key = { .n = 1 };
+    struct visit v = { .stop_at = -1 };
+
+    memory_shim_fail_at(1);
+    assert(-ENOMEM == lflist_insert(l, &key));
+    memory_shim_fail_at(1);
+    errno = 0;
+    assert(!lflist_contains(l, &key));
+    assert(ENOMEM == errno);
+    memory_shim_fail_at(1);
+    assert(-ENOMEM == lflist_for_each(l, visit_fn, &v));
+    memory_shim_fail_at(1);
+    assert(-ENOMEM == lflist_remove(l, &key, NULL));
+    memory_shim_fail_at(2);
+    assert(-ENOMEM == lflist_remove(l, &key, NULL));
+    memory_shim_reset();
+
+    assert(0 == lflist_size(l));
+    lflist_delete(l, NULL);
+}
+
+static void test_lflist_new(void)
+{
+    struct lflist *l;
+
+    errno = 0;
+    assert(NULL == lflist_new(offsetof(struct node, link), NULL));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == lflist_new(1, cmp_node));
+    assert(EINVAL == errno);
+
+    memory_shim_fail_at(1);
+    errno = 0;
+    l = lflist_new(offsetof(struct node, link), cmp_node);
+    memory_shim_reset();
+    assert(NULL == l);
+    assert(ENOMEM == errno);
+
+    l = lflist_new(offsetof(struct node, link), cmp_node);
+    assert(l);
+    assert(0 == lflist_size(l));
+    assert(0 == lflist_size(NULL));
+    lflist_delete(l, NULL);
+    lflist_delete(NULL, NULL);
+}
+
+static void test_lflist_ops(void)
+{
+    struct lflist *l = lflist_new(offsetof(struct node, link), cmp_node);
+    struct node key = { .n = 0 };
+    struct visit v = { .stop_at = -1 };
+    const int order[] = { 5, 1, 9, 3, 7 };
+    struct node *dup = make_n(5);
+    struct node *nodes[5];
+
+    assert(-EFAULT == lflist_insert(NULL, dup));
+    assert(-EFAULT == lflist_insert(l, NULL));
+    assert(-EFAULT == lflist_remove(NULL, &key, NULL));
+    assert(-EFAULT == lflist_remove(l, NULL, NULL));
+    assert(-EFAULT == lflist_for_each(NULL, visit_fn, &v));
+    assert(-EFAULT == lflist_for_each(l, NULL, &v));
+    errno = 0;
+    assert(!lflist_contains(NULL, &key));
+    assert(EFAULT == errno);
+    errno = 0;
+    assert(!lflist_contains(l, NULL));
+    assert(EFAULT == errno);
+
+    for (size_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+        nodes[i] = make_n(order[i]);
+        assert(0 == lflist_insert(l, nodes[i]));
+    }
+    assert(-EEXIST == lflist_insert(l, dup));
+    free(dup);
+    assert(5 == lflist_size(l));
+
+    // Sorted traversal.
+    assert(0 == lflist_for_each(l, visit_fn, &v));
+    assert(5 == v.count);
+    for (size_t i = 0; i < v.count; i++) {
+        assert((int)(2 * i + 1) == v.values[i]);
+    }
+
+    // Early stop.
+    v = (struct visit){ .stop_at = 3 };
+    assert(3 == lflist_for_each(l, visit_fn, &v));
+    assert(2 == v.count);
+
+    key.n = 7;
+    assert(lflist_contains(l, &key));
+    key.n = 4;
+    assert(!lflist_contains(l, &key));
+    key.n = 100;
+    assert(!lflist_contains(l, &key));
+
+    key.n = 4;
+    assert(-ENOENT == lflist_remove(l, &key, destroy));
+    key.n = 100;
+    assert(-ENOENT == lflist_remove(l, &key, destroy));
+
+    atomic_store(&destroyed, 0);
+    key.n = 7;
+    assert(0 == lflist_remove(l, &key, destroy));
+    assert(!lflist_contains(l, &key));
+    assert(4 == lflist_size(l));
+    lflist_synchronize();
+    assert(1 == atomic_load(&destroyed));
+
+    // The caller regains ownership after a grace period.
+    key.n = 1;
+    assert(0 == lflist_remove(l, &key, NULL));
+    lflist_synchronize();
+    assert(1 == atomic_load(&destroyed));
+    free(nodes[1]);
+
+    lflist_delete(l, free);
+}
+
+static void mark(struct node *node)
+{
+    atomic_fetch_or(&node->link.next, LFLIST_MARK);
+}
+
+static void test_lflist_marked(void)
+{
+    struct lflist *l = lflist_new(offsetof(struct node, link), cmp_node);
+    struct node *a = make_n(1);
+    struct node *b = make_n(2);
+    struct visit v = { .stop_at = -1 };
+
+    assert(0 == lflist_insert(l, a));
+    assert(0 == lflist_insert(l, b));
+
+    // A node marked by a remove in progress is already absent to readers.
+    mark(a);
+    assert(!lflist_contains(l, a));
+    assert(0 == lflist_for_each(l, visit_fn, &v));
+    assert(1 == v.count);
+    assert(2 == v.values[0]);
+
+    // The next update unlinks it on the way past; the remover keeps ownership.
+    assert(0 == lflist_insert(l, make_n(3)));
+    assert((uintptr_t)&b->link == atomic_load(&l->head.next));
+    free(a);
+
+    lflist_delete(l, free);
+}
+
+static void hook_insert_25(void)
+{
+    assert(0 == lflist_insert(g_list, make_n(25)));
+}
+
+static void hook_insert_20(void)
+{
+    assert(0 == lflist_insert(g_list, make_n(20)));
+}
+
+static struct node *g_victim;
+
+static void hook_insert_20_mark_victim(void)
+{
+    hook_insert_20();
+    // Act as a remover that is about to unlink the victim.
+    mark(g_victim);
+    atomic_fetch_sub(&g_list->size, 1);
+}
+
+/// Assert that list @c l holds exactly the values @c expect[0..n).
+static void assert_values(struct lflist *l, const int *expect, size_t n)
+{
+    struct visit v = { .stop_at = -1 };
+
+    assert(0 == lflist_for_each(l, visit_fn, &v));
+    assert(n == v.count);
+    assert(n == lflist_size(l));
+    for (size_t i = 0; i < n; i++) {
+        assert(expect[i] == v.values[i]);
+    }
+}
+
+static void test_lflist_races(void)
+{
+    struct node key = { .n = 0 };
+
+    // Insert: the predecessor gains a new successor between the search and the swap.
+    g_list = lflist_new(offsetof(struct node, link), cmp_node);
+    lflist_insert(g_list, make_n(10));
+    lflist_insert(g_list, make_n(30));
+    g_hook_at = 30;
+    g_hook = hook_insert_25;
+    assert(0 == lflist_insert(g_list, make_n(20)));
+    assert_values(g_list, (const int[]){ 10, 20, 25, 30 }, 4);
+    lflist_delete(g_list, free);
+
+    // Remove: after marking, the predecessor no longer links to the removed node; a new search unlinks it.
+    g_list = lflist_new(offsetof(struct node, link), cmp_node);
+    lflist_insert(g_list, make_n(10));
+    lflist_insert(g_list, make_n(30));
+    g_hook_at = 30;
+    g_hook = hook_insert_20;
+    key.n = 30;
+    assert(0 == lflist_remove(g_list, &key, free));
+    assert_values(g_list, (const int[]){ 10, 20 }, 2);
+    lflist_synchronize();
+    lflist_delete(g_list, free);
+
+    // Search: a node is marked, and its predecessor changes, while the search is between them; it restarts.
+    g_list = lflist_new(offsetof(struct node, link), cmp_node);
+    g_victim = make_n(30);
+    lflist_insert(g_list, make_n(10));
+    lflist_insert(g_list, g_victim);
+    lflist_insert(g_list, make_n(50));
+    g_hook_at = 10;
+    g_hook = hook_insert_20_mark_victim;
+    key.n = 50;
+    assert(0 == lflist_remove(g_list, &key, free));
+    free(g_victim);
+    assert_values(g_list, (const int[]){ 10, 20 }, 2);
+    lflist_synchronize();
+    lflist_delete(g_list, free);
+}
+
+static int remove_visited(void *element, void *ctx)
+{
+    struct lflist *l = ctx;
+
+    // The visited node stays readable until the traversal ends.
+    assert(0 == lflist_remove(l, element, destroy));
+    return 0;
+}
+
+static void test_lflist_remove_during_for_each(void)
+{
+    struct lflist *l = lflist_new(offsetof(struct node, link), cmp_node);
+
+    for (int i = 0; i < 10; i++) {
+        assert(0 == lflist_insert(l, make_n(i)));
+    }
+
+    atomic_store(&destroyed, 0);
+    assert(0 == lflist_for_each(l, remove_visited, l));
+    assert(0 == lflist_size(l));
+    lflist_synchronize();
+    assert(10 == atomic_load(&destroyed));
+
+    lflist_delete(l, free);
+}
+
+struct worker {
+    struct lflist *l;
+    unsigned seed;
+    long inserted;
+    long removed;
+};
+
+static void *worker_run(void *arg)
+{
+    struct worker *w = arg;
+    struct node key;
+
+    for (int i = 0; i < OPS; i++) {
+        int n = (int)(rand_r(&w->seed) % KEYS);
+        unsigned op = rand_r(&w->seed) % 4;
+
+        key.n = n;
+        if (op == 0) {
+            struct node *node = make_n(n);
+            if (lflist_insert(w->l, node) == 0) {
+                w->inserted++;
+            } else {
+                free(node);
+            }
+        } else if (op == 1) {
+            if (lflist_remove(w->l, &key, destroy) == 0) {
+                w->removed++;
+            }
+        } else if (op == 2) {
+            lflist_contains(w->l, &key);
+        } else {
+            struct visit v = { .stop_at = -1 };
+            assert(0 == lflist_for_each(w->l, visit_fn, &v));
+            for (size_t j = 1; j < v.count; j++) {
+                assert(v.values[j - 1] < v.values[j]);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static void test_lflist_concurrent(void)
+{
+    struct lflist *l = lflist_new(offsetof(struct node, link), cmp_node);
+    struct worker workers[THREADS];
+    pthread_t threads[THREADS];
+    long balance = 0;
+
+    for (int i = 0; i < THREADS; i++) {
+        workers[i] = (struct worker){ .l = l, .seed = (unsigned)i + 1 };
+        assert(0 == pthread_create(&threads[i], NULL, worker_run, &workers[i]));
+    }
+    for (int i = 0; i < THREADS; i++) {
+        assert(0 == pthread_join(threads[i], NULL));
+        balance += workers[i].inserted - workers[i].removed;
+    }
+
+    assert((size_t)balance == lflist_size(l));
+
+    // Worker records are reused by later threads.
+    assert(0 == pthread_create(&threads[0], NULL, worker_run, &workers[0]));
+    assert(0 == pthread_join(threads[0], NULL));
+
+    lflist_synchronize();
+    lflist_delete(l, free);
+}
+
+int main(void)
+{
+    test_registration_failure();
+    test_lflist_new();
+    test_lflist_ops();
+    test_lflist_marked();
+    test_lflist_remove_during_for_each();
+    test_lflist_races();
+    test_lflist_concurrent();
+    return 0;
+}
@@ -5,6 +5,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "llist.c"
 
@@ -26,6 +27,32 @@ static struct node *make_n(int n)
     return node;
 }
 
+/// Assert that list @c l holds exactly the values @c expect[0..n).
+static void assert_values(struct list *l, const int *expect, size_t n)
+{
+    struct list_iter *it = list_begin(l);
+
+    assert(n == list_size(l));
+    for (size_t i = 0; i < n; i++) {
+        assert(it->node.list == l);
+        assert(expect[i] == ((struct node *)list_at(it))->n);
+        it = list_next(it);
+    }
+    assert(it == list_end(l));
+}
+
+/// @return New list holding values [first, last).
+static struct list *make_list(int first, int last)
+{
+    struct list *l = list_new(offsetof(struct node, link));
+
+    for (int i = first; i < last; i++) {
+        list_push_back(l, make_n(i));
+    }
+
+    return l;
+}
+
 static void test_list_new(void)
 {
     struct list *l;
@@ -92,6 +119,60 @@ static void test_list_clear(void)
     assert(0 == list_clear(l, NULL));
     assert(0 == list_clear(l, NULL));
 
+    list_push_back(l, make_n(1));
+    list_push_back(l, make_n(2));
+    assert(0 == list_clear(l, free));
+    assert(list_empty(l));
+    assert(list_begin(l) == list_end(l));
+
+    // The list is reusable.
+    list_push_back(l, make_n(3));
+    assert_values(l, (const int[]){3}, 1);
+
+    list_delete(l, free);
+}
+
+static size_t batch_calls;
+static size_t batch_elements;
+
+static void free_batch(void **elements, size_t n)
+{
+    assert(n > 0 && n <= LIST_ERASE_BATCH);
+    batch_calls++;
+    batch_elements += n;
+    for (size_t i = 0; i < n; i++) {
+        free(elements[i]);
+    }
+}
+
+static void test_list_clear_batch(void)
+{
+    struct list *l;
+    struct list_iter *it;
+    struct node *n;
+
+    assert(-EFAULT == list_clear_batch(NULL, free_batch));
+
+    l = make_list(0, 0);
+    assert(0 == list_clear_batch(l, free_batch));
+    assert(0 == batch_calls);
+    list_delete(l, free);
+
+    l = make_list(0, LIST_ERASE_BATCH * 2 + 1);
+    assert(0 == list_clear_batch(l, free_batch));
+    assert(list_empty(l));
+    assert(list_begin(l) == list_end(l));
+    assert(3 == batch_calls);
+    assert(LIST_ERASE_BATCH * 2 + 1 == batch_elements);
+
+    // Without destructor the caller regains ownership; nodes are marked unlinked.
+    n = make_n(1);
+    it = list_push_back(l, n);
+    assert(0 == list_clear_batch(l, NULL));
+    assert(list_empty(l));
+    assert(-EINVAL == list_erase(it, free));
+    free(n);
+
     list_delete(l, free);
 }
 
@@ -262,6 +343,9 @@ static void test_list_advance(void)
     it = list_advance(list_begin(l), 3);
     assert(it == list_end(l));
 
+    it = list_advance(list_end(l), -3);
+    assert(it == list_begin(l));
+
     errno = 0;
     it = list_advance(list_begin(l), 4);
     assert(NULL == it);
@@ -444,6 +528,80 @@ static void test_list_push_back(void)
     list_delete(l, free);
 }
 
+static void test_list_insert_n(void)
+{
+    struct list *l;
+    struct list_iter *it;
+    struct node *nodes[4];
+    void *elements[4];
+    size_t generation;
+
+    for (int i = 0; i < 4; i++) {
+        nodes[i] = make_n(i + 1);
+        elements[i] = nodes[i];
+    }
+
+    errno = 0;
+    assert(NULL == list_insert_n(NULL, elements, 1));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == list_push_back_n(NULL, elements, 1));
+    assert(EFAULT == errno);
+
+    l = make_list(0, 1);
+    list_push_back(l, make_n(5));
+
+    errno = 0;
+    assert(NULL == list_insert_n(list_end(l), NULL, 1));
+    assert(EFAULT == errno);
+
+    // Invalid iterator.
+    errno = 0;
+    assert(NULL == list_insert_n((struct list_iter *)&nodes[0]->link, elements, 1));
+    assert(EINVAL == errno);
+
+    // Simulate size overflow.
+    l->size = SIZE_MAX - 2;
+    errno = 0;
+    assert(NULL == list_push_back_n(l, elements, 3));
+    assert(EOVERFLOW == errno);
+    l->size = 2;
+
+    // NULL element: the list and the preceding elements are unchanged.
+    elements[2] = NULL;
+    nodes[0]->link.next = &nodes[1]->link;
+    errno = 0;
+    assert(NULL == list_push_back_n(l, elements, 4));
+    assert(EFAULT == errno);
+    assert_values(l, (const int[]){ 0, 5 }, 2);
+    assert(&nodes[1]->link == nodes[0]->link.next);
+    assert(!nodes[0]->link.list);
+    assert(!nodes[1]->link.list);
+    nodes[0]->link.next = NULL;
+    elements[2] = nodes[2];
+
+    // Nothing to insert.
+    it = list_begin(l);
+    assert(it == list_insert_n(it, elements, 0));
+    assert(2 == list_size(l));
+
+    generation = l->generation;
+    it = list_insert_n(list_next(list_begin(l)), elements, 3);
+    assert(&nodes[0]->link == &it->node);
+    assert(l->generation != generation);
+    assert_values(l, (const int[]){ 0, 1, 2, 3, 5 }, 5);
+    assert(3 == *(int *)list_at(list_prev(list_prev(list_end(l)))));
+
+    // Into an empty list.
+    list_clear(l, free);
+    assert(&nodes[3]->link == &list_push_back_n(l, elements + 3, 1)->node);
+    assert_values(l, (const int[]){ 4 }, 1);
+    assert(nodes[3] == list_at(list_prev(list_end(l))));
+
+    list_delete(l, free);
+}
+
 static void test_list_pop_front(void)
 {
     struct list *l;
@@ -580,6 +738,94 @@ static void test_list_erase(void)
     list_delete(l, free);
 }
 
+/// List that @c free_observing checks, and the size it expects.
+static struct list *g_observed;
+static size_t g_observed_size;
+
+/// Destructor that checks the list is already consistent without the erased range.
+static void free_observing(void *element)
+{
+    assert(g_observed_size == list_size(g_observed));
+    assert(4 == ((struct node *)list_at(list_next(list_begin(g_observed))))->n);
+    assert(4 == ((struct node *)list_at(list_nth(g_observed, 1)))->n);
+    free(element);
+}
+
+static void test_list_erase_range(void)
+{
+    struct list *l;
+    struct list *l2;
+    struct list_iter *first;
+    struct list_iter *last;
+    struct node *n;
+
+    l = make_list(0, 6);
+    l2 = make_list(0, 1);
+
+    assert(-EFAULT == list_erase_range(NULL, list_end(l), free));
+    assert(-EFAULT == list_erase_range(list_begin(l), NULL, free));
+
+    // Iterators must be linked, and within one list.
+    n = make();
+    assert(-EINVAL == list_erase_range((struct list_iter *)&n->link, list_end(l), free));
+    assert(-EINVAL == list_erase_range(list_begin(l), (struct list_iter *)&n->link, free));
+    free(n);
+    assert(-EINVAL == list_erase_range(list_begin(l), list_end(l2), free));
+
+    // Empty range.
+    assert(0 == list_erase_range(list_begin(l), list_begin(l), free));
+    assert(0 == list_erase_range(list_end(l), list_end(l), free));
+
+    // Erasing list_end() does not make sense.
+    assert(-ENOENT == list_erase_range(list_end(l), list_begin(l), free));
+
+    // @c last must follow @c first.
+    first = list_advance(list_begin(l), 3);
+    assert(-EINVAL == list_erase_range(first, list_begin(l), free));
+    assert_values(l, (const int[]){0, 1, 2, 3, 4, 5}, 6);
+
+    // Erase [1, 3).
+    first = list_next(list_begin(l));
+    last = list_advance(first, 2);
+    assert(0 == list_erase_range(first, last, free));
+    assert_values(l, (const int[]){0, 3, 4, 5}, 4);
+
+    // Erase [4, end).
+    assert(0 == list_erase_range(list_advance(list_begin(l), 2), list_end(l), free));
+    assert_values(l, (const int[]){0, 3}, 2);
+
+    // Erase [begin, 3) without destructor; caller regains ownership.
+    n = list_at(list_begin(l));
+    first = list_begin(l);
+    assert(0 == list_erase_range(first, list_next(first), NULL));
+    assert_values(l, (const int[]){3}, 1);
+    assert(NULL == list_at(first));
+    free(n);
+
+    list_delete(l, free);
+
+    l = make_list(0, LIST_ERASE_BATCH + 3);
+    batch_calls = 0;
+    batch_elements = 0;
+    assert(-EFAULT == list_erase_range_batch(NULL, list_end(l), free_batch));
+    assert(0 == list_erase_range_batch(list_next(list_begin(l)), list_prev(list_end(l)), free_batch));
+    assert(2 == batch_calls);
+    assert(LIST_ERASE_BATCH + 1 == batch_elements);
+    assert_values(l, (const int[]){0, LIST_ERASE_BATCH + 2}, 2);
+    list_delete(l, free);
+
+    // Destructors see the list without the range, and an index that positional queries no longer trust.
+    l = make_list(0, 5);
+    assert(0 == list_index_enable(l));
+    g_observed = l;
+    g_observed_size = 2;
+    assert(0 == list_erase_range(list_next(list_begin(l)), list_advance(list_begin(l), 4), free_observing));
+    assert_values(l, (const int[]){0, 4}, 2);
+    list_delete(l, free);
+
+    list_delete(l2, free);
+}
+
 static void test_list_splice(void)
 {
     struct list *l;
@@ -653,6 +899,685 @@ static void test_list_splice(void)
     list_delete(l, free);
 }
 
+static void test_list_splice_range(void)
+{
+    struct list *l;
+    struct list *l2;
+    struct list *l3;
+    struct list_iter *first;
+    struct list_iter *last;
+    struct node *n;
+
+    l = make_list(1, 6);
+    l2 = make_list(10, 13);
+
+    assert(-EFAULT == list_splice_range(NULL, list_begin(l), list_end(l)));
+    assert(-EFAULT == list_splice_range(list_begin(l), NULL, list_end(l)));
+    assert(-EFAULT == list_splice_range(list_begin(l), list_begin(l), NULL));
+
+    // Iterators must be linked.
+    n = make();
+    assert(-EINVAL == list_splice_range((struct list_iter *)&n->link, list_begin(l), list_end(l)));
+    assert(-EINVAL == list_splice_range(list_begin(l), (struct list_iter *)&n->link, list_end(l)));
+    free(n);
+
+    // Range must be within one list.
+    assert(-EINVAL == list_splice_range(list_begin(l), list_begin(l), list_end(l2)));
+
+    // Lists must use the same offset.
+    l3 = list_new(0);
+    assert(-EINVAL == list_splice_range(list_end(l3), list_begin(l), list_end(l)));
+    list_delete(l3, NULL);
+
+    // Empty range.
+    assert(0 == list_splice_range(list_begin(l2), list_begin(l), list_begin(l)));
+
+    // Source list_end() not allowed.
+    assert(-ENOENT == list_splice_range(list_begin(l2), list_end(l), list_begin(l)));
+
+    // Disallow inserting before itself.
+    assert(-EINVAL == list_splice_range(list_begin(l), list_begin(l), list_end(l)));
+
+    // Range already before target.
+    assert(0 == list_splice_range(list_end(l), list_begin(l), list_end(l)));
+    assert_values(l, (const int[]){1, 2, 3, 4, 5}, 5);
+
+    // Same list: move [4, 5] to front.
+    first = list_advance(list_begin(l), 3);
+    assert(0 == list_splice_range(list_begin(l), first, list_end(l)));
+    assert_values(l, (const int[]){4, 5, 1, 2, 3}, 5);
+
+    // Same list: move [4, 5] to back.
+    last = list_advance(list_begin(l), 2);
+    assert(0 == list_splice_range(list_end(l), list_begin(l), last));
+    assert_values(l, (const int[]){1, 2, 3, 4, 5}, 5);
+
+    // Between lists: move [2, 3] before 11.
+    first = list_next(list_begin(l));
+    last = list_advance(first, 2);
+    assert(0 == list_splice_range(list_next(list_begin(l2)), first, last));
+    assert_values(l, (const int[]){1, 4, 5}, 3);
+    assert_values(l2, (const int[]){10, 2, 3, 11, 12}, 5);
+
+    // Iterators remain valid.
+    assert(2 == ((struct node *)list_at(first))->n);
+    assert(4 == ((struct node *)list_at(last))->n);
+
+    // Between lists, @c last must follow @c first; ownership is restored.
+    assert(-EINVAL == list_splice_range(list_begin(l2), list_next(list_begin(l)), list_begin(l)));
+    assert_values(l, (const int[]){1, 4, 5}, 3);
+    assert_values(l2, (const int[]){10, 2, 3, 11, 12}, 5);
+
+    // Simulate size overflow; ownership is restored.
+    l2->size = SIZE_MAX;
+    assert(-EOVERFLOW == list_splice_range(list_end(l2), list_begin(l), list_end(l)));
+    l2->size = 5;
+    assert_values(l, (const int[]){1, 4, 5}, 3);
+
+    list_delete(l, free);
+    list_delete(l2, free);
+}
+
+static void test_list_concat(void)
+{
+    struct list *l;
+    struct list *l2;
+
+    l = make_list(1, 3);
+    l2 = make_list(3, 5);
+
+    assert(-EFAULT == list_concat(NULL, l2));
+    assert(-EFAULT == list_concat(l, NULL));
+    assert(-EINVAL == list_concat(l, l));
+
+    assert(0 == list_concat(l, l2));
+    assert_values(l, (const int[]){1, 2, 3, 4}, 4);
+    assert_values(l2, NULL, 0);
+
+    // Concatenating an empty list is a no-op.
+    assert(0 == list_concat(l, l2));
+    assert_values(l, (const int[]){1, 2, 3, 4}, 4);
+
+    assert(0 == list_concat(l2, l));
+    assert_values(l, NULL, 0);
+    assert_values(l2, (const int[]){1, 2, 3, 4}, 4);
+
+    list_delete(l, free);
+    list_delete(l2, free);
+}
+
+static void test_list_split(void)
+{
+    struct list *l;
+    struct list *l2;
+    struct list *split;
+    struct node *n;
+
+    l = make_list(1, 5);
+    l2 = make_list(1, 2);
+
+    errno = 0;
+    assert(NULL == list_split(NULL, list_begin(l)));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == list_split(l, NULL));
+    assert(EFAULT == errno);
+
+    // Iterator must belong to the list.
+    errno = 0;
+    assert(NULL == list_split(l, list_begin(l2)));
+    assert(EINVAL == errno);
+
+    n = make();
+    errno = 0;
+    assert(NULL == list_split(l, (struct list_iter *)&n->link));
+    assert(EINVAL == errno);
+    free(n);
+
+    memory_shim_fail_at(1);
+    errno = 0;
+    assert(NULL == list_split(l, list_begin(l)));
+    memory_shim_reset();
+    assert(ENOMEM == errno);
+
+    split = list_split(l, list_advance(list_begin(l), 2));
+    assert(split);
+    assert_values(l, (const int[]){1, 2}, 2);
+    assert_values(split, (const int[]){3, 4}, 2);
+    list_delete(split, free);
+
+    // Split at end yields an empty list.
+    split = list_split(l, list_end(l));
+    assert(split);
+    assert(list_empty(split));
+    assert_values(l, (const int[]){1, 2}, 2);
+    list_delete(split, free);
+
+    list_delete(l, free);
+    list_delete(l2, free);
+}
+
+static int cmp_node(const void *a, const void *b)
+{
+    const struct node *x = a;
+    const struct node *y = b;
+    return (x->n > y->n) - (x->n < y->n);
+}
+
+/// Compare by decade only, so that sort stability is observable.
+static int cmp_decade(const void *a, const void *b)
+{
+    const struct node *x = a;
+    const struct node *y = b;
+    return (x->n / 10 > y->n / 10) - (x->n / 10 < y->n / 10);
+}
+
+static void test_list_sort(void)
+{
+    struct list *l;
+    struct list_iter *it;
+    struct list_iter *its[3];
+    int values[200];
+    int prev;
+
+    l = make_list(0, 0);
+
+    assert(-EFAULT == list_sort(NULL, cmp_node));
+    assert(-EFAULT == list_sort(l, NULL));
+
+    // Empty, and single element.
+    assert(0 == list_sort(l, cmp_node));
+    assert_values(l, NULL, 0);
+    list_push_back(l, make_n(1));
+    assert(0 == list_sort(l, cmp_node));
+    assert_values(l, (const int[]){1}, 1);
+    list_clear(l, free);
+
+    // Small lists of various sizes.
+    for (int n = 2; n < 9; n++) {
+        for (int i = 0; i < n; i++) {
+            values[i] = (i * 11 + 3) % n;
+            list_push_back(l, make_n(values[i]));
+        }
+        assert(0 == list_sort(l, cmp_node));
+        for (int i = 0; i < n; i++) {
+            values[i] = i;
+        }
+        assert_values(l, values, (size_t)n);
+        list_clear(l, free);
+    }
+
+    // Iterators remain valid.
+    its[0] = list_push_back(l, make_n(3));
+    its[1] = list_push_back(l, make_n(1));
+    its[2] = list_push_back(l, make_n(2));
+    assert(0 == list_sort(l, cmp_node));
+    assert_values(l, (const int[]){1, 2, 3}, 3);
+    assert(its[1] == list_begin(l));
+    assert(its[2] == list_next(its[1]));
+    assert(its[0] == list_next(its[2]));
+    assert(list_end(l) == list_next(its[0]));
+    assert(its[1] == list_prev(its[2]));
+    list_clear(l, free);
+
+    // Stability: equal keys keep insertion order.
+    for (int i = 0; i < 200; i++) {
+        list_push_back(l, make_n((i * 37) % 200));
+    }
+    assert(0 == list_sort(l, cmp_decade));
+    assert(200 == list_size(l));
+    prev = -1;
+    for (it = list_begin(l); it != list_end(l); it = list_next(it)) {
+        int n = ((struct node *)list_at(it))->n;
+        if (prev >= 0) {
+            assert(prev / 10 <= n / 10);
+            if (prev / 10 == n / 10) {
+                // Within a decade, (i * 37) % 200 was inserted in order of i.
+                int pi = 0;
+                int ni = 0;
+                while ((pi * 37) % 200 != prev) {
+                    pi++;
+                }
+                while ((ni * 37) % 200 != n) {
+                    ni++;
+                }
+                assert(pi < ni);
+            }
+        }
+        prev = n;
+    }
+
+    list_delete(l, free);
+}
+
+static void test_list_merge(void)
+{
+    struct list *l;
+    struct list *l2;
+    struct list *l3;
+    struct node *n;
+
+    l = make_list(0, 0);
+    l2 = make_list(0, 0);
+
+    assert(-EFAULT == list_merge(NULL, l2, cmp_node));
+    assert(-EFAULT == list_merge(l, NULL, cmp_node));
+    assert(-EFAULT == list_merge(l, l2, NULL));
+    assert(-EINVAL == list_merge(l, l, cmp_node));
+
+    l3 = list_new(0);
+    assert(-EINVAL == list_merge(l, l3, cmp_node));
+    list_delete(l3, NULL);
+
+    // Both empty.
+    assert(0 == list_merge(l, l2, cmp_node));
+    assert_values(l, NULL, 0);
+
+    list_push_back(l, make_n(1));
+    list_push_back(l, make_n(4));
+    list_push_back(l, make_n(7));
+    list_push_back(l2, make_n(0));
+    list_push_back(l2, make_n(4));
+    list_push_back(l2, make_n(5));
+    list_push_back(l2, make_n(9));
+    n = list_at(list_advance(list_begin(l2), 1));
+
+    assert(0 == list_merge(l, l2, cmp_node));
+    assert_values(l, (const int[]){0, 1, 4, 4, 5, 7, 9}, 7);
+    assert_values(l2, NULL, 0);
+
+    // Stable: the equal element from @c source follows the one from @c list.
+    assert(n == list_at(list_advance(list_begin(l), 3)));
+
+    // Merge into empty list.
+    assert(0 == list_merge(l2, l, cmp_node));
+    assert_values(l2, (const int[]){0, 1, 4, 4, 5, 7, 9}, 7);
+
+    // Simulate size overflow.
+    list_push_back(l, make_n(1));
+    l2->size = SIZE_MAX;
+    assert(-EOVERFLOW == list_merge(l2, l, cmp_node));
+    l2->size = 7;
+
+    list_delete(l, free);
+    list_delete(l2, free);
+}
+
+static void test_list_insert_sorted(void)
+{
+    struct list *l = make_list(0, 0);
+    struct list *l2 = make_list(0, 0);
+    struct node *nodes[4];
+    struct node *a = make_n(15);
+    struct node *b = make_n(12);
+    struct list_iter *it;
+
+    // Argument validation.
+    errno = 0;
+    assert(NULL == list_insert_sorted(NULL, a, cmp_node, NULL));
+    assert(EFAULT == errno);
+    errno = 0;
+    assert(NULL == list_insert_sorted(l, NULL, cmp_node, NULL));
+    assert(EFAULT == errno);
+    errno = 0;
+    assert(NULL == list_insert_sorted(l, a, NULL, NULL));
+    assert(EFAULT == errno);
+    errno = 0;
+    assert(NULL == list_insert_sorted(l, a, cmp_node, list_end(l2)));
+    assert(EINVAL == errno);
+
+    // Into an empty list, then both ways from the finger.
+    for (int i = 0; i < 8; i++) {
+        int v = (int[]){ 5, 6, 3, 9, 7, 8, 1, 6 }[i];
+        it = list_insert_sorted(l, make_n(v), cmp_node, NULL);
+        assert(v == ((struct node *)list_at(it))->n);
+        assert(l->finger == &it->node);
+    }
+    assert_values(l, (const int[]){ 1, 3, 5, 6, 6, 7, 8, 9 }, 8);
+
+    // Equal elements go after existing ones.
+    assert(list_next(list_advance(list_begin(l), 3)) == list_element(list_at(it), offsetof(struct node, link)));
+
+    // Any other change drops the finger; the search then starts from the end.
+    free(list_pop_back(l));
+    assert(list_end(l) == (struct list_iter *)impl_finger(l));
+    list_insert_sorted(l, make_n(0), cmp_node, NULL);
+    assert_values(l, (const int[]){ 0, 1, 3, 5, 6, 6, 7, 8 }, 8);
+
+    // With a hint, on either side.
+    list_insert_sorted(l, make_n(4), cmp_node, list_begin(l));
+    list_insert_sorted(l, make_n(2), cmp_node, list_advance(list_begin(l), 6));
+    list_insert_sorted(l, make_n(10), cmp_node, list_end(l));
+    assert_values(l, (const int[]){ 0, 1, 2, 3, 4, 5, 6, 6, 7, 8, 10 }, 11);
+
+    // Overflow.
+    l->size = SIZE_MAX;
+    errno = 0;
+    assert(NULL == list_insert_sorted(l, a, cmp_node, NULL));
+    assert(EOVERFLOW == errno);
+    l->size = 11;
+
+    // Batch argument validation leaves the list unchanged.
+    nodes[0] = a;
+    nodes[1] = b;
+    errno = 0;
+    assert(NULL == list_insert_sorted_n(NULL, (void **)nodes, 2, cmp_node));
+    assert(EFAULT == errno);
+    errno = 0;
+    assert(NULL == list_insert_sorted_n(l, NULL, 2, cmp_node));
+    assert(EFAULT == errno);
+    errno = 0;
+    assert(NULL == list_insert_sorted_n(l, (void **)nodes, 2, NULL));
+    assert(EFAULT == errno);
+    errno = 0;
+    assert(NULL == list_insert_sorted_n(l, (void **)nodes, 2, cmp_node));
+    assert(EINVAL == errno);
+    nodes[1] = NULL;
+    errno = 0;
+    assert(NULL == list_insert_sorted_n(l, (void **)nodes, 2, cmp_node));
+    assert(EFAULT == errno);
+    l->size = SIZE_MAX;
+    errno = 0;
+    assert(NULL == list_insert_sorted_n(l, (void **)nodes, 2, cmp_node));
+    assert(EOVERFLOW == errno);
+    l->size = 11;
+    assert(list_end(l) == list_insert_sorted_n(l, (void **)nodes, 0, cmp_node));
+    assert_values(l, (const int[]){ 0, 1, 2, 3, 4, 5, 6, 6, 7, 8, 10 }, 11);
+    free(a);
+    free(b);
+
+    // Batch merge, starting from the end without a finger.
+    nodes[0] = make_n(-1);
+    nodes[1] = make_n(6);
+    nodes[2] = make_n(6);
+    nodes[3] = make_n(12);
+    l->generation++;
+    it = list_insert_sorted_n(l, (void **)nodes, 4, cmp_node);
+    assert(nodes[0] == list_at(it));
+    assert_values(l, (const int[]){ -1, 0, 1, 2, 3, 4, 5, 6, 6, 6, 6, 7, 8, 10, 12 }, 15);
+    assert(nodes[1] == list_at(list_advance(list_begin(l), 9)));
+    assert(nodes[2] == list_at(list_advance(list_begin(l), 10)));
+    assert(l->finger == &nodes[3]->link);
+
+    // Sequential batch appends start from the finger.
+    nodes[0] = make_n(12);
+    nodes[1] = make_n(13);
+    list_insert_sorted_n(l, (void **)nodes, 2, cmp_node);
+    assert(nodes[0] == list_at(list_advance(list_begin(l), 15)));
+    assert(l->finger == &nodes[1]->link);
+    assert(17 == list_size(l));
+
+    list_delete(l, free);
+    list_delete(l2, free);
+}
+
+static void test_list_unchecked(void)
+{
+    struct list *l;
+    struct list_iter *it;
+    struct node *n;
+
+    l = list_new(offsetof(struct node, link));
+
+    list_push_back_unchecked(l, make_n(2));
+    list_push_front_unchecked(l, make_n(1));
+    it = list_insert_unchecked(list_end(l), make_n(4));
+    it = list_insert_unchecked(it, make_n(3));
+    assert(4 == list_size(l));
+    assert(3 == ((struct node *)list_at_unchecked(it))->n);
+
+    it = list_begin(l);
+    for (int i = 1; i <= 4; i++) {
+        assert(i == ((struct node *)list_at_unchecked(it))->n);
+        it = list_next_unchecked(it);
+    }
+    assert(it == list_end(l));
+
+    it = list_prev_unchecked(it);
+    assert(4 == ((struct node *)list_at_unchecked(it))->n);
+    it = list_prev_unchecked(it);
+    assert(3 == ((struct node *)list_at_unchecked(it))->n);
+
+    // Unchecked erase marks the node unlinked, so checked calls still detect reuse.
+    n = list_at_unchecked(it);
+    list_erase_unchecked(it, NULL);
+    assert(3 == list_size(l));
+    errno = 0;
+    assert(NULL == list_at(it));
+    assert(EINVAL == errno);
+    free(n);
+
+    n = list_pop_front_unchecked(l);
+    assert(1 == n->n);
+    free(n);
+
+    n = list_pop_back_unchecked(l);
+    assert(4 == n->n);
+    free(n);
+
+    list_erase_unchecked(list_begin(l), free);
+    assert(list_empty(l));
+
+    list_delete(l, free);
+}
+
+/// Record visited values into ctx; stop at value 5 if ctx->stop.
+struct visit {
+    int values[16];
+    size_t n;
+    bool stop;
+    bool erase;
+};
+
+static int visit(void *element, void *ctx)
+{
+    struct visit *v = ctx;
+    struct node *node = element;
+
+    v->values[v->n++] = node->n;
+
+    if (v->erase) {
+        list_erase(list_element(node, offsetof(struct node, link)), free);
+    }
+
+    return (v->stop && node->n == 5) ? 42 : 0;
+}
+
+static void test_list_for_each(void)
+{
+    struct list *l = make_list(0, 10);
+    struct visit v;
+
+    assert(-EFAULT == list_for_each(NULL, visit, NULL));
+    assert(-EFAULT == list_for_each(l, NULL, NULL));
+    assert(-EFAULT == list_for_each_reverse(NULL, visit, NULL));
+    assert(-EFAULT == list_for_each_prefetch(NULL, visit, NULL, 1, 0));
+    assert(-EFAULT == list_for_each_reverse_prefetch(l, NULL, NULL, 1, 0));
+
+    memset(&v, 0, sizeof(v));
+    assert(0 == list_for_each(l, visit, &v));
+    assert(10 == v.n);
+    for (int i = 0; i < 10; i++) {
+        assert(i == v.values[i]);
+    }
+
+    memset(&v, 0, sizeof(v));
+    assert(0 == list_for_each_reverse(l, visit, &v));
+    assert(10 == v.n);
+    for (int i = 0; i < 10; i++) {
+        assert(9 - i == v.values[i]);
+    }
+
+    // Early exit.
+    memset(&v, 0, sizeof(v));
+    v.stop = true;
+    assert(42 == list_for_each(l, visit, &v));
+    assert(6 == v.n);
+
+    memset(&v, 0, sizeof(v));
+    v.stop = true;
+    assert(42 == list_for_each_reverse(l, visit, &v));
+    assert(5 == v.n);
+
+    // Any distance, with and without payload prefetch.
+    for (size_t distance = 0; distance < 12; distance++) {
+        memset(&v, 0, sizeof(v));
+        assert(0 == list_for_each_prefetch(l, visit, &v, distance, offsetof(struct node, n)));
+        assert(10 == v.n);
+        assert(9 == v.values[9]);
+
+        memset(&v, 0, sizeof(v));
+        assert(0 == list_for_each_reverse_prefetch(l, visit, &v, distance, LIST_PREFETCH_NO_PAYLOAD));
+        assert(10 == v.n);
+        assert(0 == v.values[9]);
+    }
+
+    // Callback may erase the visited element.
+    memset(&v, 0, sizeof(v));
+    v.erase = true;
+    assert(0 == list_for_each(l, visit, &v));
+    assert(10 == v.n);
+    assert(list_empty(l));
+
+    memset(&v, 0, sizeof(v));
+    assert(0 == list_for_each(l, visit, &v));
+    assert(0 == v.n);
+
+    list_delete(l, free);
+}
+
+static void test_list_index(void)
+{
+    struct list *l = make_list(0, 100);
+    int expect[100];
+
+    assert(0 == list_index_enable(l));
+
+    // Long jumps use the index.
+    assert(list_nth(l, 50) == list_advance(list_begin(l), 50));
+    assert(list_end(l) == list_advance(list_begin(l), 100));
+    assert(list_begin(l) == list_advance(list_end(l), -100));
+    assert(list_nth(l, 70) == list_advance(list_nth(l, 90), -20));
+    errno = 0;
+    assert(NULL == list_advance(list_begin(l), 101));
+    assert(ERANGE == errno);
+    errno = 0;
+    assert(NULL == list_advance(list_nth(l, 20), -21));
+    assert(ERANGE == errno);
+
+    // Index follows single-element changes.
+    free(list_pop_front(l));
+    list_push_front(l, make_n(0));
+    assert(0 == list_splice_range(list_begin(l), list_nth(l, 98), list_end(l)));
+    assert(0 == list_splice_range(list_end(l), list_begin(l), list_nth(l, 2)));
+    for (int i = 0; i < 100; i++) {
+        expect[i] = i;
+    }
+    assert_values(l, expect, 100);
+    assert(42 == list_index_of(list_nth(l, 42)));
+    assert(list_index_current(l));
+
+    list_delete(l, free);
+}
+
+static void test_list_order(void)
+{
+    struct list *l = make_list(0, 10);
+    int expect[10] = { 8, 9, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+    assert(0 == list_order_enable(l));
+    assert(list_precedes(list_begin(l), list_end(l)));
+
+    free(list_pop_front(l));
+    list_push_front(l, make_n(0));
+    assert(0 == list_splice_range(list_begin(l), list_advance(list_begin(l), 8), list_end(l)));
+    assert_values(l, expect, 10);
+    assert(list_order_current(l));
+    assert(list_precedes(list_begin(l), list_next(list_begin(l))));
+    assert(!list_precedes(list_next(list_begin(l)), list_begin(l)));
+
+    list_delete(l, free);
+}
+
+static void test_list_stats(void)
+{
+    struct list *l = make_list(0, 4);
+    struct list *other = make_list(10, 12);
+    struct list_stats stats;
+    void *batch[2];
+
+    assert(-EFAULT == list_stats_get(NULL, &stats));
+    assert(-EFAULT == list_stats_get(l, NULL));
+    assert(-EFAULT == list_stats_reset(NULL));
+
+#ifdef LLIST_STATS
+    assert(0 == list_stats_get(l, &stats));
+    assert(4 == stats.inserts);
+    assert(4 == stats.high_water);
+
+    // Reset keeps the current size as the high-water mark.
+    assert(0 == list_stats_reset(l));
+    assert(0 == list_stats_get(l, &stats));
+    assert(0 == stats.inserts);
+    assert(4 == stats.high_water);
+
+    batch[0] = make_n(4);
+    batch[1] = make_n(5);
+    assert(NULL != list_insert_n(list_end(l), batch, 2));
+    batch[0] = make_n(6);
+    batch[1] = make_n(7);
+    assert(NULL != list_insert_sorted_n(l, batch, 2, cmp_node));
+    assert(NULL != list_insert_sorted(l, make_n(8), cmp_node, NULL));
+    assert(NULL == list_insert(NULL, batch[0]));
+    free(list_pop_front(l));
+    free(list_pop_back(l));
+    assert(NULL == list_pop_front(NULL));
+    assert(0 == list_erase(list_begin(l), free));
+    assert(0 == list_erase_range(list_begin(l), list_nth(l, 2), free));
+    assert(-EINVAL == list_splice(list_begin(l), list_begin(l)));
+    assert(0 == list_splice(list_begin(l), list_prev(list_end(l))));
+    assert(0 == list_splice_range(list_end(l), list_begin(other), list_next(list_begin(other))));
+    assert(0 == list_concat(l, other));
+    list_push_back(other, make_n(12));
+    assert(0 == list_merge(l, other, cmp_node));
+    assert(0 == list_stats_get(l, &stats));
+    assert(5 == stats.inserts);
+    assert(3 == stats.erases);
+    assert(2 == stats.pops);
+    assert(4 == stats.splices);
+    assert(9 == stats.high_water);
+    assert(7 == list_size(l));
+
+    // Walks count steps; jumps through the index count only the distance.
+    assert(0 == list_stats_reset(l));
+    assert(list_begin(l) == list_advance(list_begin(l), 0));
+    assert(list_nth(l, 5) == list_advance(list_begin(l), 5));
+    assert(list_begin(l) == list_advance(list_nth(l, 5), -5));
+    assert(NULL == list_advance(list_begin(l), 9));
+    assert(0 == list_stats_get(l, &stats));
+    assert(10 == stats.advance_steps);
+    assert(1 == stats.advance_log2[0]);
+    assert(2 == stats.advance_log2[3]);
+
+    list_delete(other, free);
+    other = make_list(0, 40);
+    assert(0 == list_index_enable(other));
+    assert(list_nth(other, 20) == list_advance(list_begin(other), 20));
+    assert(0 == list_stats_get(other, &stats));
+    assert(0 == stats.advance_steps);
+    assert(1 == stats.advance_log2[5]);
+#else
+    (void)batch;
+    (void)other;
+    assert(-ENOTSUP == list_stats_get(l, &stats));
+    assert(-ENOTSUP == list_stats_reset(l));
+#endif
+
+    list_delete(other, free);
+    list_delete(l, free);
+}
+
 static void test_stress(void)
 {
     struct list *l;
@@ -683,6 +1608,7 @@ int main(void)
     test_list_empty();
     test_list_size();
     test_list_clear();
+    test_list_clear_batch();
     test_list_iterator();
     test_list_iterator_const();
     test_list_advance();
@@ -691,11 +1617,24 @@ int main(void)
     test_list_insert();
     test_list_push_front();
     test_list_push_back();
+    test_list_insert_n();
     test_list_pop_front();
     test_list_pop_back();
     test_list_at();
     test_list_erase();
+    test_list_erase_range();
     test_list_splice();
+    test_list_splice_range();
+    test_list_concat();
+    test_list_split();
+    test_list_sort();
+    test_list_merge();
+    test_list_insert_sorted();
+    test_list_unchecked();
+    test_list_for_each();
+    test_list_index();
+    test_list_order();
+    test_list_stats();
     test_stress();
     return 0;
 }
@@ -0,0 +1,314 @@
+#include "llist_compact.h"
+
+#include "memory_shim.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+
+#include "llist_compact.c"
+
+struct node
+{
+    int n;
+    LIST_NODE_COMPACT(link);
+};
+
+static struct node *make(void)
+{
+    return calloc(1, sizeof(struct node));
+}
+
+static struct node *make_n(int n)
+{
+    struct node *node = make();
+    node->n = n;
+    return node;
+}
+
+/// Assert that list @c l holds exactly the values @c expect[0..n).
+static void assert_values(struct list_compact *l, const int *expect, size_t n)
+{
+    struct list_compact_iter *it = list_compact_begin(l);
+
+    assert(n == list_compact_size(l));
+    for (size_t i = 0; i < n; i++) {
+        assert(expect[i] == ((struct node *)list_compact_at(l, it))->n);
+        it = list_compact_next(l, it);
+    }
+    assert(it == list_compact_end(l));
+
+    for (size_t i = n; i > 0; i--) {
+        it = list_compact_prev(l, it);
+        assert(expect[i - 1] == ((struct node *)list_compact_at(l, it))->n);
+    }
+}
+
+static void test_layout(void)
+{
+    assert(sizeof(struct list_compact_node) == 2 * sizeof(void *));
+}
+
+static void test_list_compact_new(void)
+{
+    struct list_compact *l;
+
+    errno = 0;
+    l = list_compact_new(1);
+    assert(NULL == l);
+    assert(EINVAL == errno);
+
+    memory_shim_fail_at(1);
+    errno = 0;
+    l = list_compact_new(offsetof(struct node, link));
+    memory_shim_reset();
+    assert(NULL == l);
+    assert(ENOMEM == errno);
+
+    list_compact_delete(NULL, NULL);
+}
+
+static void test_list_compact_size(void)
+{
+    struct list_compact *l;
+
+    assert(list_compact_empty(NULL));
+    assert(0 == list_compact_size(NULL));
+    assert(-EFAULT == list_compact_clear(NULL, NULL));
+
+    l = list_compact_new(offsetof(struct node, link));
+    assert(list_compact_empty(l));
+
+    list_compact_push_back(l, make_n(1));
+    assert(!list_compact_empty(l));
+    assert(1 == list_compact_size(l));
+
+    assert(0 == list_compact_clear(l, free));
+    assert(list_compact_empty(l));
+    assert(list_compact_begin(l) == list_compact_end(l));
+
+    list_compact_delete(l, free);
+}
+
+static void test_list_compact_iterator(void)
+{
+    struct list_compact *l;
+    struct list_compact_iter *it;
+    struct node *n;
+
+    errno = 0;
+    assert(NULL == list_compact_begin(NULL));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == list_compact_end(NULL));
+    assert(EFAULT == errno);
+
+    l = list_compact_new(offsetof(struct node, link));
+
+    errno = 0;
+    assert(NULL == list_compact_next(l, NULL));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == list_compact_prev(NULL, list_compact_end(l)));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == list_compact_next(l, list_compact_end(l)));
+    assert(ERANGE == errno);
+
+    errno = 0;
+    assert(NULL == list_compact_prev(l, list_compact_begin(l)));
+    assert(ERANGE == errno);
+
+    errno = 0;
+    assert(NULL == list_compact_at(l, list_compact_end(l)));
+    assert(ENOENT == errno);
+
+    errno = 0;
+    assert(NULL == list_compact_at(NULL, list_compact_end(l)));
+    assert(EFAULT == errno);
+
+    // Unlinked node.
+    n = make_n(0);
+    it = list_compact_element(l, n);
+    errno = 0;
+    assert(NULL == list_compact_at(l, it));
+    assert(EINVAL == errno);
+
+    errno = 0;
+    assert(NULL == list_compact_element(l, NULL));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == list_compact_element(NULL, n));
+    assert(EFAULT == errno);
+
+    list_compact_push_back(l, n);
+    assert(it == list_compact_begin(l));
+    assert(n == list_compact_at(l, it));
+
+    list_compact_delete(l, free);
+}
+
+static void test_list_compact_insert(void)
+{
+    struct list_compact *l;
+    struct list_compact_iter *it;
+    struct node *n;
+
+    l = list_compact_new(offsetof(struct node, link));
+
+    errno = 0;
+    assert(NULL == list_compact_insert(l, list_compact_end(l), NULL));
+    assert(EFAULT == errno);
+
+    n = make_n(0);
+    errno = 0;
+    assert(NULL == list_compact_insert(l, NULL, n));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == list_compact_push_back(NULL, n));
+    assert(EFAULT == errno);
+
+    // Simulate size overflow.
+    l->size = SIZE_MAX;
+    errno = 0;
+    assert(NULL == list_compact_insert(l, list_compact_end(l), n));
+    assert(EOVERFLOW == errno);
+    l->size = 0;
+    free(n);
+
+    list_compact_push_back(l, make_n(3));
+    list_compact_push_front(l, make_n(1));
+    it = list_compact_insert(l, list_compact_prev(l, list_compact_end(l)), make_n(2));
+    assert(2 == ((struct node *)list_compact_at(l, it))->n);
+    assert_values(l, (const int[]){1, 2, 3}, 3);
+
+    list_compact_delete(l, free);
+}
+
+static void test_list_compact_erase(void)
+{
+    struct list_compact *l;
+    struct list_compact_iter *it;
+    struct node *n;
+
+    l = list_compact_new(offsetof(struct node, link));
+
+    errno = 0;
+    assert(NULL == list_compact_pop_front(l));
+    assert(ENOENT == errno);
+
+    errno = 0;
+    assert(NULL == list_compact_pop_back(l));
+    assert(EFAULT == errno);
+
+    assert(-ENOENT == list_compact_erase(l, list_compact_end(l), free));
+    assert(-EFAULT == list_compact_erase(l, NULL, free));
+
+    for (int i = 1; i <= 4; i++) {
+        list_compact_push_back(l, make_n(i));
+    }
+
+    n = list_compact_pop_front(l);
+    assert(1 == n->n);
+    free(n);
+
+    n = list_compact_pop_back(l);
+    assert(4 == n->n);
+    free(n);
+
+    it = list_compact_begin(l);
+    n = list_compact_at(l, it);
+    assert(0 == list_compact_erase(l, it, NULL));
+
+    // Iterator is invalid after erase.
+    assert(-EINVAL == list_compact_erase(l, it, free));
+    free(n);
+
+    assert_values(l, (const int[]){3}, 1);
+
+    assert(0 == list_compact_erase(l, list_compact_begin(l), free));
+    assert(list_compact_empty(l));
+
+    list_compact_delete(l, free);
+}
+
+static void test_list_compact_splice(void)
+{
+    struct list_compact *l;
+    struct list_compact *l2;
+    struct list_compact *l3;
+    struct node *n;
+
+    l = list_compact_new(offsetof(struct node, link));
+    l2 = list_compact_new(offsetof(struct node, link));
+    for (int i = 1; i <= 3; i++) {
+        list_compact_push_back(l, make_n(i));
+        list_compact_push_back(l2, make_n(i * 10));
+    }
+
+    assert(-EFAULT == list_compact_splice(NULL, list_compact_begin(l), l, list_compact_begin(l)));
+    assert(-EFAULT == list_compact_splice(l, list_compact_begin(l), NULL, list_compact_begin(l)));
+
+    // Source must be linked.
+    n = make();
+    assert(-EINVAL == list_compact_splice(l, list_compact_begin(l), l, list_compact_element(l, n)));
+    free(n);
+
+    // Disallow splicing an element to right before itself.
+    assert(-EINVAL == list_compact_splice(l, list_compact_begin(l), l, list_compact_begin(l)));
+
+    // Source list_compact_end() not allowed.
+    assert(-ENOENT == list_compact_splice(l, list_compact_begin(l), l, list_compact_end(l)));
+
+    // Lists must use the same offset.
+    l3 = list_compact_new(0);
+    assert(-EINVAL == list_compact_splice(l3, list_compact_end(l3), l, list_compact_begin(l)));
+    assert(-EINVAL == list_compact_concat(l3, l));
+    list_compact_delete(l3, NULL);
+
+    // Within a list.
+    assert(0 == list_compact_splice(l, list_compact_begin(l), l, list_compact_prev(l, list_compact_end(l))));
+    assert_values(l, (const int[]){3, 1, 2}, 3);
+
+    // Between lists.
+    assert(0 == list_compact_splice(l2, list_compact_end(l2), l, list_compact_begin(l)));
+    assert_values(l, (const int[]){1, 2}, 2);
+    assert_values(l2, (const int[]){10, 20, 30, 3}, 4);
+
+    // Simulate size overflow.
+    l->size = SIZE_MAX;
+    assert(-EOVERFLOW == list_compact_splice(l, list_compact_end(l), l2, list_compact_begin(l2)));
+    assert(-EOVERFLOW == list_compact_concat(l, l2));
+    l->size = 2;
+
+    assert(-EFAULT == list_compact_concat(NULL, l2));
+    assert(-EINVAL == list_compact_concat(l, l));
+
+    assert(0 == list_compact_concat(l, l2));
+    assert_values(l, (const int[]){1, 2, 10, 20, 30, 3}, 6);
+    assert_values(l2, NULL, 0);
+
+    // Concatenating an empty list is a no-op.
+    assert(0 == list_compact_concat(l, l2));
+    assert_values(l, (const int[]){1, 2, 10, 20, 30, 3}, 6);
+
+    list_compact_delete(l, free);
+    list_compact_delete(l2, free);
+}
+
+int main(void)
+{
+    test_layout();
+    test_list_compact_new();
+    test_list_compact_size();
+    test_list_compact_iterator();
+    test_list_compact_insert();
+    test_list_compact_erase();
+    test_list_compact_splice();
+    return 0;
+}
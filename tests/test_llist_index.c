@@ -0,0 +1,324 @@
+#include "llist.h"
+
+#include "memory_shim.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "llist_index.c"
+
+struct node
+{
+    int n;
+    LIST_NODE(link);
+};
+
+static struct node *make_n(int n)
+{
+    struct node *node = calloc(1, sizeof(struct node));
+    node->n = n;
+    return node;
+}
+
+static int value(struct list_iter *it)
+{
+    return ((struct node *)list_at(it))->n;
+}
+
+/// Assert that positional queries on @c l agree with @c expect[0..n).
+static void assert_positions(struct list *l, const int *expect, size_t n)
+{
+    struct list_iter *it = list_begin(l);
+
+    assert(n == list_size(l));
+    for (size_t i = 0; i < n; i++) {
+        assert(expect[i] == value(it));
+        assert((ssize_t)i == list_index_of(it));
+        assert(it == list_nth(l, i));
+        it = list_next(it);
+    }
+    assert(it == list_end(l));
+    assert((ssize_t)n == list_index_of(it));
+    assert(it == list_nth(l, n));
+}
+
+/// Assert that the index is current and consistent with the list.
+static void assert_index(struct list *l)
+{
+    struct list_index *ix = l->index;
+    size_t i = 0;
+
+    assert(list_index_current(l));
+    assert(list_size(l) == impl_count(ix, ix->root));
+    assert(list_size(l) == ix->map.count);
+    for (struct list_node *node = l->sentinel.next; node != &l->sentinel; node = node->next, i++) {
+        assert(i == impl_rank(ix, impl_find(ix, node)));
+    }
+}
+
+static void test_list_index_enable(void)
+{
+    struct list *l = list_new(offsetof(struct node, link));
+
+    assert(-EFAULT == list_index_enable(NULL));
+    assert(-EFAULT == list_index_disable(NULL));
+
+    memory_shim_fail_at(1);
+    assert(-ENOMEM == list_index_enable(l));
+    memory_shim_reset();
+    assert(NULL == l->index);
+
+    // Empty list allocates only the hash table.
+    memory_shim_fail_at(2);
+    assert(-ENOMEM == list_index_enable(l));
+    memory_shim_reset();
+    assert(NULL == l->index);
+
+    for (int i = 0; i < 100; i++) {
+        list_push_back(l, make_n(i));
+    }
+
+    memory_shim_fail_at(2);
+    assert(-ENOMEM == list_index_enable(l));
+    memory_shim_fail_at(3);
+    assert(-ENOMEM == list_index_enable(l));
+    memory_shim_reset();
+    assert(NULL == l->index);
+
+    assert(0 == list_index_enable(l));
+    assert(0 == list_index_enable(l));
+    assert_index(l);
+
+    assert(0 == list_index_disable(l));
+    assert(NULL == l->index);
+    assert(0 == list_index_disable(l));
+    assert(-EINVAL == list_index_refresh(l));
+
+    // Delete releases the index.
+    assert(0 == list_index_enable(l));
+    list_delete(l, free);
+}
+
+static void test_list_nth(void)
+{
+    struct list *l = list_new(offsetof(struct node, link));
+    int expect[100];
+
+    errno = 0;
+    assert(NULL == list_nth(NULL, 0));
+    assert(EFAULT == errno);
+
+    assert(list_end(l) == list_nth(l, 0));
+    errno = 0;
+    assert(NULL == list_nth(l, 1));
+    assert(ERANGE == errno);
+
+    assert(-EFAULT == list_index_of(NULL));
+    {
+        struct node unlinked = { 0, { NULL, NULL, NULL } };
+        assert(-EINVAL == list_index_of(list_element(&unlinked, offsetof(struct node, link))));
+    }
+
+    for (int i = 0; i < 100; i++) {
+        list_push_back(l, make_n(i));
+        expect[i] = i;
+    }
+
+    // Without index.
+    assert_positions(l, expect, 100);
+
+    // With index.
+    assert(0 == list_index_enable(l));
+    assert_positions(l, expect, 100);
+    errno = 0;
+    assert(NULL == list_nth(l, 101));
+    assert(ERANGE == errno);
+
+    list_delete(l, free);
+}
+
+static void test_list_index_update(void)
+{
+    struct list *l = list_new(offsetof(struct node, link));
+    struct node *node;
+    int expect[16];
+
+    assert(0 == list_index_enable(l));
+
+    for (int i = 0; i < 16; i++) {
+        list_push_back(l, make_n(i));
+        expect[i] = i;
+    }
+    assert_index(l);
+
+    // Grow nodes and hash table.
+    node = make_n(16);
+    memory_shim_fail_at(1);
+    list_push_back(l, node);
+    memory_shim_reset();
+    assert(!list_index_current(l));
+    assert(0 == list_erase_range(list_prev(list_end(l)), list_end(l), free));
+    assert_positions(l, expect, 16);
+    assert(0 == list_index_refresh(l));
+    assert_index(l);
+
+    node = make_n(16);
+    memory_shim_fail_at(2);
+    list_push_back(l, node);
+    memory_shim_reset();
+    assert(!list_index_current(l));
+    assert(0 == list_erase_range(list_prev(list_end(l)), list_end(l), free));
+    assert_positions(l, expect, 16);
+    assert(0 == list_index_refresh(l));
+    assert_index(l);
+
+    // Queries walk past an out of date index without rebuilding it.
+    list_clear(l, free);
+    {
+        void *batch[40];
+
+        for (int i = 0; i < 40; i++) {
+            batch[i] = make_n(i);
+        }
+        assert(NULL != list_push_back_n(l, batch, 40));
+    }
+    assert(!list_index_current(l));
+    assert(list_begin(l) == list_nth(l, 0));
+    assert(39 == list_index_of(list_prev(list_end(l))));
+    assert(list_nth(l, 30) == list_advance(list_begin(l), 30));
+    assert(NULL == list_advance(list_end(l), -SSIZE_MAX - 1));
+    assert(ERANGE == errno);
+    assert(!list_index_current(l));
+
+    // An explicit refresh rebuilds it; if that fails, it stays out of date.
+    assert(-EFAULT == list_index_refresh(NULL));
+    memory_shim_fail_at(1);
+    assert(-ENOMEM == list_index_refresh(l));
+    memory_shim_reset();
+    assert(!list_index_current(l));
+    assert(0 == list_index_refresh(l));
+    assert_index(l);
+    assert(0 == list_index_refresh(l));
+
+    // So does the next single-element change.
+    list_clear(l, free);
+    for (int i = 0; i < 4; i++) {
+        list_push_back(l, make_n(i));
+    }
+    assert_index(l);
+
+    list_delete(l, free);
+}
+
+static void test_list_index_moved(void)
+{
+    struct list *l = list_new(offsetof(struct node, link));
+    int expect[20];
+
+    for (int i = 0; i < 20; i++) {
+        list_push_back(l, make_n(i));
+        expect[i] = i;
+    }
+    assert(0 == list_index_enable(l));
+
+    // Move [10, 15) before 3.
+    assert(0 == list_splice_range(list_nth(l, 3), list_nth(l, 10), list_nth(l, 15)));
+    {
+        int e[20] = { 0, 1, 2, 10, 11, 12, 13, 14, 3, 4, 5, 6, 7, 8, 9, 15, 16, 17, 18, 19 };
+        memcpy(expect, e, sizeof(e));
+    }
+    assert(list_index_current(l));
+    assert_index(l);
+    assert_positions(l, expect, 20);
+
+    // Move [0, 3) to the end.
+    assert(0 == list_splice_range(list_end(l), list_nth(l, 0), list_nth(l, 3)));
+    {
+        int e[20] = { 10, 11, 12, 13, 14, 3, 4, 5, 6, 7, 8, 9, 15, 16, 17, 18, 19, 0, 1, 2 };
+        memcpy(expect, e, sizeof(e));
+    }
+    assert(list_index_current(l));
+    assert_index(l);
+    assert_positions(l, expect, 20);
+
+    // Single element moves.
+    assert(0 == list_splice(list_nth(l, 0), list_nth(l, 19)));
+    assert(0 == list_splice(list_end(l), list_nth(l, 1)));
+    {
+        int e[20] = { 2, 11, 12, 13, 14, 3, 4, 5, 6, 7, 8, 9, 15, 16, 17, 18, 19, 0, 1, 10 };
+        memcpy(expect, e, sizeof(e));
+    }
+    assert(list_index_current(l));
+    assert_index(l);
+    assert_positions(l, expect, 20);
+
+    list_delete(l, free);
+}
+
+static void test_stress(void)
+{
+    enum { N = 2000 };
+    struct list *l = list_new(offsetof(struct node, link));
+    static int expect[N];
+    size_t n = 0;
+    unsigned seed = 7;
+
+    assert(0 == list_index_enable(l));
+
+    for (int round = 0; round < 20000; round++) {
+        size_t pos;
+        unsigned op;
+
+        seed = seed * 1103515245u + 12345u;
+        op = (seed >> 16) % 8;
+        pos = n ? (seed >> 3) % n : 0;
+
+        if (n < N && (op < 4 || n == 0)) {
+            list_insert(list_nth(l, pos), make_n(round));
+            memmove(&expect[pos + 1], &expect[pos], (n - pos) * sizeof(int));
+            expect[pos] = round;
+            n++;
+        } else if (op < 6) {
+            list_erase(list_nth(l, pos), free);
+            memmove(&expect[pos], &expect[pos + 1], (n - pos - 1) * sizeof(int));
+            n--;
+        } else {
+            // Move one element to another position.
+            size_t to = (seed >> 9) % (n + 1);
+            int x = expect[pos];
+
+            list_splice(list_nth(l, to), list_nth(l, pos));
+            if (to != pos && to != pos + 1) {
+                if (to > pos) {
+                    memmove(&expect[pos], &expect[pos + 1], (to - pos - 1) * sizeof(int));
+                    expect[to - 1] = x;
+                } else {
+                    memmove(&expect[to + 1], &expect[to], (pos - to) * sizeof(int));
+                    expect[to] = x;
+                }
+            }
+        }
+
+        assert(list_index_current(l));
+        if (round % 500 == 0) {
+            assert_index(l);
+            assert_positions(l, expect, n);
+        }
+    }
+
+    assert_positions(l, expect, n);
+    list_delete(l, free);
+}
+
+int main(void)
+{
+    test_list_index_enable();
+    test_list_nth();
+    test_list_index_update();
+    test_list_index_moved();
+    test_stress();
+    return 0;
+}
@@ -0,0 +1,246 @@
+#include "llist_mpsc.h"
+
+#include "memory_shim.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "llist_mpsc.c"
+
+struct node
+{
+    int n;
+    int producer;
+    LIST_NODE(link);
+};
+
+enum { PRODUCERS = 4, PER_PRODUCER = 20000 };
+
+static struct node *make_n(int n)
+{
+    struct node *node = calloc(1, sizeof(struct node));
+    node->n = n;
+    return node;
+}
+
+/// Exchange the head for @c node without linking it, as a producer preempted mid-push would.
+/// @return The previous head, to be linked by @c push_finish.
+static struct list_node *push_start(struct list_mpsc *q, struct node *node)
+{
+    __atomic_store_n(&node->link.next, NULL, __ATOMIC_RELAXED);
+    return __atomic_exchange_n(&q->head, &node->link, __ATOMIC_ACQ_REL);
+}
+
+static void push_finish(struct list_node *prev, struct node *node)
+{
+    __atomic_store_n(&prev->next, &node->link, __ATOMIC_RELEASE);
+}
+
+static void test_list_mpsc_new(void)
+{
+    struct list_mpsc *q;
+
+    errno = 0;
+    assert(NULL == list_mpsc_new(1));
+    assert(EINVAL == errno);
+
+    memory_shim_fail_at(1);
+    errno = 0;
+    q = list_mpsc_new(offsetof(struct node, link));
+    memory_shim_reset();
+    assert(NULL == q);
+    assert(ENOMEM == errno);
+
+    q = list_mpsc_new(offsetof(struct node, link));
+    assert(q);
+    assert(list_mpsc_empty(q));
+    assert(list_mpsc_empty(NULL));
+    list_mpsc_delete(q, NULL);
+    list_mpsc_delete(NULL, NULL);
+}
+
+static void test_list_mpsc_push_pop(void)
+{
+    struct list_mpsc *q = list_mpsc_new(offsetof(struct node, link));
+    struct node *a = make_n(1);
+    struct node *b = make_n(2);
+    struct node *c = make_n(3);
+
+    assert(-EFAULT == list_mpsc_push(NULL, a));
+    assert(-EFAULT == list_mpsc_push(q, NULL));
+    errno = 0;
+    assert(NULL == list_mpsc_pop(NULL));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == list_mpsc_pop(q));
+    assert(ENOENT == errno);
+
+    // FIFO order, including through the stub when the queue runs dry.
+    assert(0 == list_mpsc_push(q, a));
+    assert(!list_mpsc_empty(q));
+    assert(a == list_mpsc_pop(q));
+    assert(list_mpsc_empty(q));
+    assert(0 == list_mpsc_push(q, b));
+    assert(0 == list_mpsc_push(q, c));
+    assert(b == list_mpsc_pop(q));
+    assert(!list_mpsc_empty(q));
+    assert(c == list_mpsc_pop(q));
+    assert(list_mpsc_empty(q));
+    errno = 0;
+    assert(NULL == list_mpsc_pop(q));
+    assert(ENOENT == errno);
+
+    // Popped elements are unlinked, and may join a list.
+    assert(NULL == a->link.list);
+
+    list_mpsc_push(q, a);
+    list_mpsc_push(q, b);
+    list_mpsc_delete(q, free);
+    free(c);
+}
+
+static void test_list_mpsc_push_in_progress(void)
+{
+    struct list_mpsc *q = list_mpsc_new(offsetof(struct node, link));
+    struct list *l = list_new(offsetof(struct node, link));
+    struct node *a = make_n(1);
+    struct node *b = make_n(2);
+    struct list_node *prev;
+
+    // First push not yet linked behind the stub.
+    prev = push_start(q, a);
+    assert(!list_mpsc_empty(q));
+    errno = 0;
+    assert(NULL == list_mpsc_pop(q));
+    assert(EAGAIN == errno);
+    push_finish(prev, a);
+
+    // Tail is the last node, but a push behind it is not yet linked.
+    prev = push_start(q, b);
+    errno = 0;
+    assert(NULL == list_mpsc_pop(q));
+    assert(EAGAIN == errno);
+    assert(0 == list_mpsc_drain(q, l));
+    push_finish(prev, b);
+    assert(a == list_mpsc_pop(q));
+    assert(b == list_mpsc_pop(q));
+    assert(list_mpsc_empty(q));
+
+    list_delete(l, NULL);
+    list_mpsc_delete(q, NULL);
+    free(a);
+    free(b);
+}
+
+static void test_list_mpsc_drain(void)
+{
+    struct list_mpsc *q = list_mpsc_new(offsetof(struct node, link));
+    struct list *l = list_new(offsetof(struct node, link));
+    struct list *other = list_new(offsetof(struct node, n));
+    struct node *before = make_n(0);
+    size_t generation;
+    int n = 1;
+
+    assert(-EFAULT == list_mpsc_drain(NULL, l));
+    assert(-EFAULT == list_mpsc_drain(q, NULL));
+    assert(-EINVAL == list_mpsc_drain(q, other));
+    assert(0 == list_mpsc_drain(q, l));
+
+    list_push_back(l, before);
+    for (int i = 1; i <= 5; i++) {
+        list_mpsc_push(q, make_n(i));
+    }
+
+    generation = l->generation;
+    assert(5 == list_mpsc_drain(q, l));
+    assert(list_mpsc_empty(q));
+    assert(6 == list_size(l));
+    assert(generation != l->generation);
+
+    // Appended in FIFO order, linked both ways.
+    assert(before == list_at(list_begin(l)));
+    for (struct list_iter *it = list_next(list_begin(l)); it != list_end(l); it = list_next(it)) {
+        assert(n++ == ((struct node *)list_at(it))->n);
+        assert(list_next(list_prev(it)) == it);
+    }
+    assert(5 == ((struct node *)list_at(list_prev(list_end(l))))->n);
+
+    list_delete(other, NULL);
+    list_delete(l, free);
+    list_mpsc_delete(q, NULL);
+}
+
+static struct list_mpsc *g_queue;
+
+static void *producer_run(void *arg)
+{
+    int producer = (int)(size_t)arg;
+
+    for (int i = 0; i < PER_PRODUCER; i++) {
+        struct node *node = make_n(i);
+        node->producer = producer;
+        assert(0 == list_mpsc_push(g_queue, node));
+    }
+
+    return NULL;
+}
+
+static void test_list_mpsc_concurrent(void)
+{
+    struct list *l = list_new(offsetof(struct node, link));
+    pthread_t threads[PRODUCERS];
+    int expect[PRODUCERS] = { 0 };
+    size_t total = 0;
+
+    g_queue = list_mpsc_new(offsetof(struct node, link));
+
+    for (size_t i = 0; i < PRODUCERS; i++) {
+        assert(0 == pthread_create(&threads[i], NULL, producer_run, (void *)i));
+    }
+
+    // Alternate between single pops and batch drains until every element has arrived.
+    while (total < PRODUCERS * PER_PRODUCER) {
+        struct node *node = list_mpsc_pop(g_queue);
+        ssize_t r;
+
+        if (node) {
+            list_push_back(l, node);
+            total++;
+        }
+
+        r = list_mpsc_drain(g_queue, l);
+        assert(r >= 0);
+        total += (size_t)r;
+    }
+
+    for (size_t i = 0; i < PRODUCERS; i++) {
+        assert(0 == pthread_join(threads[i], NULL));
+    }
+
+    // Each producer's elements arrive in the order pushed.
+    while (!list_empty(l)) {
+        struct node *node = list_pop_front(l);
+        assert(expect[node->producer]++ == node->n);
+        free(node);
+    }
+    for (size_t i = 0; i < PRODUCERS; i++) {
+        assert(PER_PRODUCER == expect[i]);
+    }
+
+    assert(list_mpsc_empty(g_queue));
+    list_mpsc_delete(g_queue, NULL);
+    list_delete(l, NULL);
+}
+
+int main(void)
+{
+    test_list_mpsc_new();
+    test_list_mpsc_push_pop();
+    test_list_mpsc_push_in_progress();
+    test_list_mpsc_drain();
+    test_list_mpsc_concurrent();
+    return 0;
+}
@@ -0,0 +1,261 @@
+#include "llist.h"
+
+#include "memory_shim.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+
+#include "llist_order.c"
+
+struct node
+{
+    int n;
+    LIST_NODE(link);
+};
+
+static struct node *make_n(int n)
+{
+    struct node *node = calloc(1, sizeof(struct node));
+    node->n = n;
+    return node;
+}
+
+/// Assert that labels are current, and increase along the list.
+static void assert_labels(struct list *l)
+{
+    uint64_t previous = 0;
+    bool first = true;
+
+    assert(list_order_current(l));
+    assert(list_size(l) == l->order->labels.count);
+    for (struct list_node *node = l->sentinel.next; node != &l->sentinel; node = node->next) {
+        uint64_t label = impl_label(l->order, node);
+        assert(label < ORDER_MAX);
+        assert(first || previous < label);
+        previous = label;
+        first = false;
+    }
+}
+
+/// Assert that list_precedes agrees with list positions, for every pair.
+static void assert_precedes(struct list *l)
+{
+    size_t i = 0;
+
+    for (struct list_iter *a = list_begin(l); a != list_end(l); a = list_next(a), i++) {
+        size_t j = 0;
+        for (struct list_iter *b = list_begin(l); b != list_end(l); b = list_next(b), j++) {
+            assert((i < j) == list_precedes(a, b));
+        }
+        assert(list_precedes(a, list_end(l)));
+        assert(!list_precedes(list_end(l), a));
+    }
+}
+
+static void test_list_order_enable(void)
+{
+    struct list *l = list_new(offsetof(struct node, link));
+
+    assert(-EFAULT == list_order_enable(NULL));
+    assert(-EFAULT == list_order_disable(NULL));
+
+    memory_shim_fail_at(1);
+    assert(-ENOMEM == list_order_enable(l));
+    memory_shim_fail_at(2);
+    assert(-ENOMEM == list_order_enable(l));
+    memory_shim_reset();
+    assert(NULL == l->order);
+
+    for (int i = 0; i < 10; i++) {
+        list_push_back(l, make_n(i));
+    }
+
+    assert(0 == list_order_enable(l));
+    assert(0 == list_order_enable(l));
+    assert_labels(l);
+
+    assert(0 == list_order_disable(l));
+    assert(NULL == l->order);
+    assert(0 == list_order_disable(l));
+    assert(-EINVAL == list_order_refresh(l));
+
+    // Delete releases the labels.
+    assert(0 == list_order_enable(l));
+    list_delete(l, free);
+}
+
+static void test_list_precedes(void)
+{
+    struct list *l = list_new(offsetof(struct node, link));
+    struct list *other = list_new(offsetof(struct node, link));
+    struct node unlinked = { 0, { NULL, NULL, NULL } };
+    struct list_iter *u = list_element(&unlinked, offsetof(struct node, link));
+
+    for (int i = 0; i < 10; i++) {
+        list_push_back(l, make_n(i));
+        list_push_back(other, make_n(i));
+    }
+
+    assert(!list_precedes(NULL, list_begin(l)));
+    assert(!list_precedes(list_begin(l), NULL));
+    assert(!list_precedes(u, list_begin(l)));
+    assert(!list_precedes(list_begin(l), u));
+    assert(!list_precedes(list_begin(l), list_begin(other)));
+    assert(!list_precedes(list_begin(l), list_begin(l)));
+    assert(!list_precedes(list_end(l), list_end(l)));
+
+    // Without labels.
+    assert_precedes(l);
+
+    // With labels.
+    assert(0 == list_order_enable(l));
+    assert_precedes(l);
+
+    // Queries walk past out of date labels without relabelling.
+    list_splice_range(list_begin(l), list_begin(other), list_end(other));
+    assert(!list_order_current(l));
+    assert(list_precedes(list_begin(l), list_prev(list_end(l))));
+    assert(!list_precedes(list_prev(list_end(l)), list_begin(l)));
+    assert_precedes(l);
+    assert(!list_order_current(l));
+
+    // An explicit refresh relabels; if that fails, the labels stay out of date.
+    assert(-EFAULT == list_order_refresh(NULL));
+    memory_shim_fail_at(1);
+    assert(-ENOMEM == list_order_refresh(l));
+    memory_shim_reset();
+    assert(!list_order_current(l));
+    assert(0 == list_order_refresh(l));
+    assert(0 == list_order_refresh(l));
+    assert_labels(l);
+
+    // So does the next single-element change.
+    assert(0 == list_erase_range(list_begin(l), list_next(list_begin(l)), free));
+    assert(!list_order_current(l));
+    free(list_pop_front(l));
+    assert_labels(l);
+
+    list_delete(l, free);
+    list_delete(other, free);
+}
+
+static void test_list_order_relabel(void)
+{
+    struct list *l = list_new(offsetof(struct node, link));
+    struct list_iter *it;
+    struct node *node;
+
+    assert(0 == list_order_enable(l));
+
+    // Map growth failure leaves labels out of date.
+    for (int i = 0; i < 8; i++) {
+        list_push_back(l, make_n(i));
+    }
+    node = make_n(8);
+    memory_shim_fail_at(1);
+    list_push_back(l, node);
+    memory_shim_reset();
+    assert(!list_order_current(l));
+    assert_precedes(l);
+    assert(0 == list_order_refresh(l));
+    assert_labels(l);
+
+    // Repeated insertion at one point exhausts the gap.
+    it = list_nth(l, 3);
+    for (int i = 0; i < 500; i++) {
+        list_insert(it, make_n(100 + i));
+        assert_labels(l);
+    }
+
+    // Repeated insertion at both ends.
+    for (int i = 0; i < 500; i++) {
+        list_push_front(l, make_n(-i));
+        list_push_back(l, make_n(1000 + i));
+    }
+    assert_labels(l);
+    assert(0 == impl_label(l->order, l->sentinel.next));
+
+    // Repeated insertion after the front element.
+    for (int i = 0; i < 500; i++) {
+        list_insert(list_next(list_begin(l)), make_n(2000 + i));
+    }
+    assert_labels(l);
+    assert_precedes(l);
+
+    list_delete(l, free);
+}
+
+static void test_list_order_moved(void)
+{
+    struct list *l = list_new(offsetof(struct node, link));
+
+    for (int i = 0; i < 300; i++) {
+        list_push_back(l, make_n(i));
+    }
+    assert(0 == list_order_enable(l));
+
+    // Ranges moved within the list keep labels current.
+    for (int i = 0; i < 100; i++) {
+        struct list_iter *first = list_nth(l, (size_t)(i * 7) % 250);
+        struct list_iter *last = list_advance(first, 40);
+        struct list_iter *to = (i % 2) ? list_begin(l) : list_end(l);
+
+        assert(0 == list_splice_range(to, first, last));
+        assert_labels(l);
+    }
+    assert_precedes(l);
+
+    // Unlinking.
+    while (!list_empty(l)) {
+        free(list_pop_front(l));
+        assert_labels(l);
+    }
+
+    list_delete(l, free);
+}
+
+static void test_stress(void)
+{
+    struct list *l = list_new(offsetof(struct node, link));
+    unsigned seed = 3;
+
+    assert(0 == list_order_enable(l));
+
+    for (int round = 0; round < 20000; round++) {
+        size_t n = list_size(l);
+        size_t pos;
+        unsigned op;
+
+        seed = seed * 1103515245u + 12345u;
+        op = (seed >> 16) % 8;
+        pos = n ? (seed >> 3) % n : 0;
+
+        if (op < 5 || n == 0) {
+            // Skew insertions towards a few hot spots.
+            list_insert(list_nth(l, op < 3 ? n / 3 : pos), make_n(round));
+        } else if (op < 7) {
+            list_erase(list_nth(l, pos), free);
+        } else {
+            list_splice(list_nth(l, (seed >> 9) % (n + 1)), list_nth(l, pos));
+        }
+
+        assert(list_order_current(l));
+        if (round % 1000 == 0) {
+            assert_labels(l);
+        }
+    }
+
+    assert_labels(l);
+    list_delete(l, free);
+}
+
+int main(void)
+{
+    test_list_order_enable();
+    test_list_precedes();
+    test_list_order_relabel();
+    test_list_order_moved();
+    test_stress();
+    return 0;
+}
@@ -0,0 +1,352 @@
+#include "llist_parallel.h"
+
+#include "memory_shim.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#include "llist_parallel.c"
+
+struct node
+{
+    int key;
+    int id;
+    LIST_NODE(link);
+};
+
+static int cmp_key(const void *a, const void *b)
+{
+    const struct node *x = a;
+    const struct node *y = b;
+    return (x->key > y->key) - (x->key < y->key);
+}
+
+/// @return New list of @c n elements with many duplicate keys.
+static struct list *make_list(int n)
+{
+    struct list *l = list_new(offsetof(struct node, link));
+    unsigned seed = 1;
+
+    for (int i = 0; i < n; i++) {
+        struct node *node = calloc(1, sizeof(struct node));
+        seed = seed * 1103515245u + 12345u;
+        node->key = (int)((seed >> 16) % 97);
+        node->id = i;
+        list_push_back(l, node);
+    }
+
+    return l;
+}
+
+/// Assert that @c l and @c expect hold the same elements in the same order.
+static void assert_same(struct list *l, struct list *expect)
+{
+    const struct list_iter *a = list_cbegin(l);
+    const struct list_iter *b = list_cbegin(expect);
+
+    assert(list_size(l) == list_size(expect));
+    while (a != list_cend(l)) {
+        const struct node *x = list_at_const(a);
+        const struct node *y = list_at_const(b);
+        assert(x->key == y->key);
+        assert(x->id == y->id);
+        assert(a->node.list == l);
+        assert(a->node.next->prev == &a->node);
+        a = list_cnext(a);
+        b = list_cnext(b);
+    }
+    assert(b == list_cend(expect));
+}
+
+static void check(int n, size_t nthreads)
+{
+    struct list *l = make_list(n);
+    struct list *expect = make_list(n);
+
+    assert(0 == list_sort(expect, cmp_key));
+    assert(0 == list_sort_parallel(l, cmp_key, nthreads));
+    assert_same(l, expect);
+
+    list_delete(l, free);
+    list_delete(expect, free);
+}
+
+static void test_list_sort_parallel(void)
+{
+    struct list *l;
+    struct list_iter *it;
+    int id;
+
+    l = make_list(0);
+
+    assert(-EFAULT == list_sort_parallel(NULL, cmp_key, 1));
+    assert(-EFAULT == list_sort_parallel(l, NULL, 1));
+    assert(-EINVAL == list_sort_parallel(l, cmp_key, 0));
+
+    // Empty list.
+    assert(0 == list_sort_parallel(l, cmp_key, 4));
+    assert(list_empty(l));
+    list_delete(l, free);
+
+    // Too small to split.
+    check(100, 4);
+
+    // Single thread.
+    check(10000, 1);
+
+    // Power-of-two and odd numbers of parts.
+    check(10000, 2);
+    check(10000, 3);
+    check(10000, 4);
+    check(10001, 5);
+    check(20000, 8);
+
+    // More threads than worthwhile.
+    check(3000, 64);
+
+    // Iterators remain valid.
+    l = make_list(5000);
+    it = list_advance(list_begin(l), 1234);
+    id = ((struct node *)list_at(it))->id;
+    assert(0 == list_sort_parallel(l, cmp_key, 4));
+    assert(id == ((struct node *)list_at(it))->id);
+    list_delete(l, free);
+}
+
+static void test_list_sort_parallel_failure(void)
+{
+    struct list *l;
+    struct list *expect;
+
+    expect = make_list(5000);
+    l = make_list(5000);
+
+    // Allocation failures leave the list unchanged.
+    for (unsigned nth = 1; nth <= 5; nth++) {
+        memory_shim_fail_at(nth);
+        assert(-ENOMEM == list_sort_parallel(l, cmp_key, 4));
+        memory_shim_reset();
+        assert_same(l, expect);
+    }
+
+    // Thread creation failure; the calling thread does the work.
+    assert(0 == list_sort(expect, cmp_key));
+    memory_shim_fail_at(6);
+    assert(0 == list_sort_parallel(l, cmp_key, 4));
+    memory_shim_reset();
+    assert_same(l, expect);
+
+    list_delete(l, free);
+    list_delete(expect, free);
+}
+
+/// Sum of ids, and a visit count per element.
+struct tally {
+    atomic_long sum;
+    atomic_int *visits;
+    int stop_at;
+};
+
+static int visit_tally(void *element, void *ctx)
+{
+    struct node *node = element;
+    struct tally *t = ctx;
+
+    atomic_fetch_add(&t->sum, node->id);
+    atomic_fetch_add(&t->visits[node->id], 1);
+    return node->id == t->stop_at ? node->id : 0;
+}
+
+static void check_for_each(int n, size_t nthreads, bool indexed)
+{
+    struct list *l = make_list(n);
+    struct tally t = { .visits = calloc((size_t)n + 1, sizeof(atomic_int)), .stop_at = -1 };
+
+    if (indexed) {
+        assert(0 == list_index_enable(l));
+    }
+
+    assert(0 == list_parallel_for_each(l, visit_tally, &t, nthreads));
+    assert((long)n * (n - 1) / 2 == atomic_load(&t.sum));
+    for (int i = 0; i < n; i++) {
+        assert(1 == atomic_load(&t.visits[i]));
+    }
+
+    free(t.visits);
+    list_delete(l, free);
+}
+
+static void test_list_parallel_for_each(void)
+{
+    struct list *l = make_list(10000);
+    struct tally t = { .visits = calloc(10000, sizeof(atomic_int)), .stop_at = -1 };
+    int visits;
+
+    assert(-EFAULT == list_parallel_for_each(NULL, visit_tally, &t, 1));
+    assert(-EFAULT == list_parallel_for_each(l, NULL, &t, 1));
+    assert(-EINVAL == list_parallel_for_each(l, visit_tally, &t, 0));
+
+    // A non-zero return stops the traversal.
+    t.stop_at = 9999;
+    assert(9999 == list_parallel_for_each(l, visit_tally, &t, 4));
+
+    // Other ranges stop too: the second range falls back to the calling thread, after the first range stopped.
+    visits = atomic_load(&t.visits[2500]);
+    t.stop_at = 10;
+    memory_shim_fail_at(2);
+    assert(10 == list_parallel_for_each(l, visit_tally, &t, 4));
+    memory_shim_reset();
+    assert(visits == atomic_load(&t.visits[2500]));
+
+    free(t.visits);
+    list_delete(l, free);
+
+    check_for_each(0, 4, false);
+    check_for_each(100, 4, false);
+    check_for_each(10000, 1, false);
+    check_for_each(10000, 3, false);
+    check_for_each(10001, 4, true);
+    check_for_each(3000, 64, true);
+}
+
+static void fold_sum(void *acc, const void *element, void *ctx)
+{
+    (void)ctx;
+    *(long *)acc += ((const struct node *)element)->id;
+}
+
+static void combine_sum(void *acc, const void *other, void *ctx)
+{
+    (void)ctx;
+    *(long *)acc += *(const long *)other;
+}
+
+/// Non-commutative reduction: first and last id of the list, in order.
+struct span {
+    int first;
+    int last;
+};
+
+static void fold_span(void *acc, const void *element, void *ctx)
+{
+    struct span *s = acc;
+    int id = ((const struct node *)element)->id;
+
+    (void)ctx;
+    if (s->first < 0) {
+        s->first = id;
+    }
+    s->last = id;
+}
+
+static void combine_span(void *acc, const void *other, void *ctx)
+{
+    struct span *s = acc;
+    const struct span *o = other;
+
+    (void)ctx;
+    if (s->first < 0) {
+        s->first = o->first;
+    }
+    if (o->last >= 0) {
+        s->last = o->last;
+    }
+}
+
+static void test_list_parallel_reduce(void)
+{
+    struct list *l = make_list(10000);
+    struct span span = { -1, -1 };
+    long sum = 0;
+
+    assert(-EFAULT == list_parallel_reduce(NULL, &sum, sizeof(sum), fold_sum, combine_sum, NULL, 1));
+    assert(-EFAULT == list_parallel_reduce(l, NULL, sizeof(sum), fold_sum, combine_sum, NULL, 1));
+    assert(-EFAULT == list_parallel_reduce(l, &sum, sizeof(sum), NULL, combine_sum, NULL, 1));
+    assert(-EFAULT == list_parallel_reduce(l, &sum, sizeof(sum), fold_sum, NULL, NULL, 1));
+    assert(-EINVAL == list_parallel_reduce(l, &sum, 0, fold_sum, combine_sum, NULL, 1));
+    assert(-EINVAL == list_parallel_reduce(l, &sum, sizeof(sum), fold_sum, combine_sum, NULL, 0));
+
+    for (size_t nthreads = 1; nthreads <= 8; nthreads++) {
+        sum = 0;
+        assert(0 == list_parallel_reduce(l, &sum, sizeof(sum), fold_sum, combine_sum, NULL, nthreads));
+        assert(10000L * 9999 / 2 == sum);
+
+        span = (struct span){ -1, -1 };
+        assert(0 == list_parallel_reduce(l, &span, sizeof(span), fold_span, combine_span, NULL, nthreads));
+        assert(0 == span.first);
+        assert(9999 == span.last);
+    }
+
+    list_clear(l, free);
+    sum = 0;
+    assert(0 == list_parallel_reduce(l, &sum, sizeof(sum), fold_sum, combine_sum, NULL, 4));
+    assert(0 == sum);
+
+    list_delete(l, free);
+}
+
+static bool is_even(const void *element, void *ctx)
+{
+    (void)ctx;
+    return ((const struct node *)element)->id % 2 == 0;
+}
+
+static void test_list_parallel_count_if(void)
+{
+    struct list *l = make_list(10001);
+
+    assert(-EFAULT == list_parallel_count_if(NULL, is_even, NULL, 1));
+    assert(-EFAULT == list_parallel_count_if(l, NULL, NULL, 1));
+    assert(-EINVAL == list_parallel_count_if(l, is_even, NULL, 0));
+
+    assert(5001 == list_parallel_count_if(l, is_even, NULL, 1));
+    assert(5001 == list_parallel_count_if(l, is_even, NULL, 4));
+
+    // An out of date index is not used.
+    assert(0 == list_index_enable(l));
+    assert(0 == list_sort(l, cmp_key));
+    assert(!list_index_current(l));
+    assert(5001 == list_parallel_count_if(l, is_even, NULL, 5));
+
+    list_delete(l, free);
+}
+
+static void test_list_parallel_failure(void)
+{
+    struct list *l = make_list(10000);
+    struct tally t = { .visits = calloc(10000, sizeof(atomic_int)), .stop_at = -1 };
+    long sum = 0;
+
+    memory_shim_fail_at(1);
+    assert(-ENOMEM == list_parallel_for_each(l, visit_tally, &t, 4));
+    memory_shim_fail_at(1);
+    assert(-ENOMEM == list_parallel_count_if(l, is_even, NULL, 4));
+    memory_shim_fail_at(1);
+    assert(-ENOMEM == list_parallel_reduce(l, &sum, sizeof(sum), fold_sum, combine_sum, NULL, 4));
+    memory_shim_fail_at(2);
+    assert(-ENOMEM == list_parallel_reduce(l, &sum, sizeof(sum), fold_sum, combine_sum, NULL, 4));
+    memory_shim_reset();
+    assert(0 == atomic_load(&t.sum));
+    assert(0 == sum);
+
+    // Thread creation failure; the calling thread visits the range.
+    memory_shim_fail_at(2);
+    assert(5000 == list_parallel_count_if(l, is_even, NULL, 4));
+    memory_shim_reset();
+
+    free(t.visits);
+    list_delete(l, free);
+}
+
+int main(void)
+{
+    test_list_sort_parallel();
+    test_list_sort_parallel_failure();
+    test_list_parallel_for_each();
+    test_list_parallel_reduce();
+    test_list_parallel_count_if();
+    test_list_parallel_failure();
+    return 0;
+}
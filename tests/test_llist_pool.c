@@ -0,0 +1,144 @@
+#include "llist_pool.h"
+
+#include "memory_shim.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "llist_pool.c"
+
+struct node
+{
+    int n;
+    LIST_NODE(link);
+};
+
+static void test_list_pool_new(void)
+{
+    struct list_pool *pool;
+
+    errno = 0;
+    pool = list_pool_new(0);
+    assert(NULL == pool);
+    assert(EINVAL == errno);
+
+    errno = 0;
+    pool = list_pool_new(LIST_POOL_SLAB_SIZE);
+    assert(NULL == pool);
+    assert(EINVAL == errno);
+
+    memory_shim_fail_at(1);
+    errno = 0;
+    pool = list_pool_new(sizeof(struct node));
+    memory_shim_reset();
+    assert(NULL == pool);
+    assert(ENOMEM == errno);
+
+    // Size is rounded up to pointer alignment.
+    pool = list_pool_new(1);
+    assert(pool);
+    assert(sizeof(void *) == pool->element_size);
+    list_pool_delete(pool);
+
+    list_pool_delete(NULL);
+}
+
+static void test_list_pool_alloc(void)
+{
+    struct list_pool *pool = list_pool_new(sizeof(struct node));
+    struct node *a;
+    struct node *b;
+
+    errno = 0;
+    assert(NULL == list_pool_alloc(NULL));
+    assert(EFAULT == errno);
+
+    memory_shim_fail_at(1);
+    errno = 0;
+    assert(NULL == list_pool_alloc(pool));
+    memory_shim_reset();
+    assert(ENOMEM == errno);
+
+    a = list_pool_alloc(pool);
+    b = list_pool_alloc(pool);
+    assert(a && b && a != b);
+    assert(0 == (uintptr_t)a % sizeof(void *));
+    assert(0 == (uintptr_t)b % sizeof(void *));
+
+    // Freed elements are reused, and handed out zero-filled.
+    a->n = 42;
+    list_pool_free(a);
+    assert(a == list_pool_alloc(pool));
+    assert(0 == a->n);
+
+    list_pool_free(NULL);
+    list_pool_free(a);
+    list_pool_free(b);
+    list_pool_delete(pool);
+}
+
+static void test_list_pool_slabs(void)
+{
+    struct list_pool *pool = list_pool_new(sizeof(struct node));
+    const size_t per_slab = (LIST_POOL_SLAB_SIZE - SLAB_HEADER) / pool->element_size;
+    struct node *first;
+    struct node *last = NULL;
+
+    memory_shim_reset();
+    first = list_pool_alloc(pool);
+    for (size_t i = 1; i < per_slab; i++) {
+        last = list_pool_alloc(pool);
+    }
+    assert(1 == memory_shim_count_get());
+
+    // Same slab.
+    assert(((uintptr_t)first & ~(LIST_POOL_SLAB_SIZE - 1)) == ((uintptr_t)last & ~(LIST_POOL_SLAB_SIZE - 1)));
+
+    // Next allocation starts a new slab.
+    last = list_pool_alloc(pool);
+    assert(2 == memory_shim_count_get());
+    assert(((uintptr_t)first & ~(LIST_POOL_SLAB_SIZE - 1)) != ((uintptr_t)last & ~(LIST_POOL_SLAB_SIZE - 1)));
+
+    list_pool_delete(pool);
+}
+
+static void test_list_pool_list(void)
+{
+    struct list_pool *pool = list_pool_new(sizeof(struct node));
+    struct list *l = list_new(offsetof(struct node, link));
+    int i;
+
+    for (i = 0; i < 10000; i++) {
+        struct node *node = list_pool_alloc(pool);
+        node->n = i;
+        assert(list_push_back(l, node));
+    }
+
+    // Compatible with list destructors.
+    assert(0 == list_erase(list_begin(l), list_pool_free));
+    assert(0 == list_erase_range(list_begin(l), list_advance(list_begin(l), 100), list_pool_free));
+    assert(9899 == list_size(l));
+    assert(101 == ((struct node *)list_at(list_begin(l)))->n);
+
+    i = 101;
+    for (struct list_iter *it = list_begin(l); it != list_end(l); it = list_next(it)) {
+        assert(i++ == ((struct node *)list_at(it))->n);
+    }
+
+    list_pool_release(pool, l);
+
+    // Either argument may be NULL.
+    list_pool_release(NULL, NULL);
+    list_pool_release(list_pool_new(1), NULL);
+}
+
+int main(void)
+{
+    test_list_pool_new();
+    test_list_pool_alloc();
+    test_list_pool_slabs();
+    test_list_pool_list();
+    return 0;
+}
@@ -0,0 +1,469 @@
+#include "llist_rcu.h"
+#include "llist.h"
+
+#include "memory_shim.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "llist_rcu.c"
+
+struct node
+{
+    int n;
+    LIST_NODE(link);
+};
+
+enum { READERS = 3, VALUES = 64, WRITES = 4000 };
+
+static struct node *make_n(int n)
+{
+    struct node *node = calloc(1, sizeof(struct node));
+    node->n = n;
+    return node;
+}
+
+static atomic_int destroyed;
+
+static void destroy(void *element)
+{
+    // Poison, so that a reader still holding the element would notice.
+    ((struct node *)element)->n = -1;
+    atomic_fetch_add(&destroyed, 1);
+    free(element);
+}
+
+static int value(const struct list_iter *it)
+{
+    return ((const struct node *)list_at_const(it))->n;
+}
+
+/// Assert that list @c l holds exactly the values @c expect[0..n).
+static void assert_values(const struct list *l, const int *expect, size_t n)
+{
+    const struct list_iter *it;
+    size_t i = 0;
+
+    assert(n == list_size(l));
+    for (it = list_rcu_cbegin(l); it != list_cend(l); it = list_rcu_cnext(it)) {
+        assert(i < n);
+        assert(expect[i++] == value(it));
+    }
+    assert(n == i);
+}
+
+static struct list *make_list(int n)
+{
+    struct list *l = list_new(offsetof(struct node, link));
+
+    for (int i = 0; i < n; i++) {
+        assert(list_rcu_push_back(l, make_n(i)));
+    }
+
+    return l;
+}
+
+static void test_registration(void)
+{
+    // Must run first: the main thread is not yet registered.
+    memory_shim_fail_at(1);
+    assert(-ENOMEM == list_rcu_register());
+    memory_shim_reset();
+
+    list_rcu_unregister();
+    assert(0 == list_rcu_register());
+    assert(0 == list_rcu_register());
+
+    // Records are reused.
+    list_rcu_unregister();
+    assert(0 == list_rcu_register());
+    assert(atomic_load(&g_readers) == t_reader);
+    assert(!atomic_load(&g_readers)->next);
+
+    // Sections nest.
+    list_rcu_read_lock();
+    list_rcu_read_lock();
+    assert(0 != atomic_load(&t_reader->ctr));
+    list_rcu_read_unlock();
+    assert(0 != atomic_load(&t_reader->ctr));
+    list_rcu_read_unlock();
+    assert(0 == atomic_load(&t_reader->ctr));
+}
+
+static void test_iteration(void)
+{
+    struct list *l = make_list(3);
+    struct node loose = { .n = 0 };
+    const struct list_iter *it;
+
+    errno = 0;
+    assert(NULL == list_rcu_cbegin(NULL));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == list_rcu_cnext(NULL));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == list_rcu_cnext((const struct list_iter *)&loose.link));
+    assert(EINVAL == errno);
+
+    errno = 0;
+    assert(NULL == list_rcu_cnext(list_cend(l)));
+    assert(ERANGE == errno);
+
+    list_rcu_read_lock();
+    it = list_rcu_cbegin(l);
+    assert(0 == value(it));
+    it = list_rcu_cnext(it);
+    assert(1 == value(it));
+    it = list_rcu_cnext(list_rcu_cnext(it));
+    assert(list_cend(l) == it);
+    list_rcu_read_unlock();
+
+    list_delete(l, free);
+}
+
+static void test_insert(void)
+{
+    struct list *l = list_new(offsetof(struct node, link));
+    struct node loose = { .n = 0 };
+    struct node *node = make_n(1);
+    size_t generation = l->generation;
+
+    errno = 0;
+    assert(NULL == list_rcu_insert(NULL, node));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == list_rcu_insert(list_end(l), NULL));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == list_rcu_insert((struct list_iter *)&loose.link, node));
+    assert(EINVAL == errno);
+
+    l->size = SIZE_MAX;
+    errno = 0;
+    assert(NULL == list_rcu_push_back(l, node));
+    assert(EOVERFLOW == errno);
+    l->size = 0;
+
+    assert(&node->link == &list_rcu_push_back(l, node)->node);
+    assert(list_rcu_push_front(l, make_n(0)));
+    assert(list_rcu_push_back(l, make_n(3)));
+    assert(list_rcu_insert(list_prev(list_end(l)), make_n(2)));
+    assert(generation != l->generation);
+    assert_values(l, (const int[]){ 0, 1, 2, 3 }, 4);
+
+    // Backward links are maintained for the writer.
+    assert(2 == *(int *)list_at(list_prev(list_prev(list_end(l)))));
+
+    list_delete(l, free);
+}
+
+static void test_erase(void)
+{
+    struct list *l = make_list(4);
+    struct node loose = { .n = 0 };
+    struct node *owned = list_at(list_begin(l));
+    struct list_iter *erased;
+
+    assert(-EFAULT == list_rcu_erase(NULL, destroy));
+    assert(-EINVAL == list_rcu_erase((struct list_iter *)&loose.link, destroy));
+    assert(-ENOENT == list_rcu_erase(list_end(l), destroy));
+
+    memory_shim_fail_at(1);
+    assert(-ENOMEM == list_rcu_erase(list_begin(l), destroy));
+    memory_shim_reset();
+    assert_values(l, (const int[]){ 0, 1, 2, 3 }, 4);
+
+    atomic_store(&destroyed, 0);
+
+    // Destruction is deferred while a reader could hold the element.
+    list_rcu_read_lock();
+    erased = list_next(list_begin(l));
+    assert(0 == list_rcu_erase(erased, destroy));
+    assert(0 == atomic_load(&destroyed));
+
+    // A reader on the erased element still reads it and moves on; every other function rejects it.
+    assert(1 == value(erased));
+    assert(2 == value(list_rcu_cnext(erased)));
+    assert(-EINVAL == list_rcu_erase(erased, destroy));
+    assert(-EINVAL == list_erase(erased, destroy));
+    assert(-EINVAL == list_rcu_splice(list_end(l), erased));
+    errno = 0;
+    assert(!list_next(erased));
+    assert(EINVAL == errno);
+    errno = 0;
+    assert(!list_rcu_insert(erased, &loose));
+    assert(EINVAL == errno);
+    assert(3 == list_size(l));
+    list_rcu_read_unlock();
+    assert_values(l, (const int[]){ 0, 2, 3 }, 3);
+
+    // Without readers, the next erase reclaims the previous one, and itself.
+    assert(0 == list_rcu_erase(list_prev(list_end(l)), destroy));
+    assert(2 == atomic_load(&destroyed));
+
+    // The caller regains ownership after a grace period; the node is unlinked.
+    assert(0 == list_rcu_erase(list_begin(l), NULL));
+    list_rcu_synchronize();
+    assert(!owned->link.list);
+    free(owned);
+    assert_values(l, (const int[]){ 2 }, 1);
+
+    list_delete(l, free);
+}
+
+static void test_erase_partial_reclaim(void)
+{
+    struct list *l = make_list(3);
+
+    atomic_store(&destroyed, 0);
+    g_membarrier = false;
+
+    list_rcu_read_lock();
+    assert(0 == list_rcu_erase(list_begin(l), destroy));
+    list_rcu_read_unlock();
+
+    // A reader entering now can no longer reach the first element, but may reach the second.
+    list_rcu_read_lock();
+    assert(0 == list_rcu_erase(list_begin(l), destroy));
+    assert(1 == atomic_load(&destroyed));
+    list_rcu_read_unlock();
+
+    g_membarrier = true;
+    list_rcu_synchronize();
+    assert(2 == atomic_load(&destroyed));
+    assert_values(l, (const int[]){ 2 }, 1);
+
+    list_delete(l, free);
+}
+
+static void test_splice(void)
+{
+    struct list *l = make_list(5);
+    struct list *m = make_list(2);
+    struct list *o = list_new(0);
+    struct node loose = { .n = 0 };
+    size_t generation = m->generation;
+
+    assert(-EFAULT == list_rcu_splice(NULL, list_begin(l)));
+    assert(-EFAULT == list_rcu_splice(list_begin(l), NULL));
+    assert(-EINVAL == list_rcu_splice((struct list_iter *)&loose.link, list_begin(l)));
+    assert(-EINVAL == list_rcu_splice(list_begin(m), list_begin(l)));
+    assert(-EINVAL == list_rcu_splice(list_begin(l), list_begin(l)));
+    assert(-ENOENT == list_rcu_splice(list_begin(l), list_end(l)));
+
+    assert(-EFAULT == list_rcu_splice_range(NULL, list_begin(l), list_end(l)));
+    assert(-EFAULT == list_rcu_splice_range(list_end(m), NULL, list_end(l)));
+    assert(-EFAULT == list_rcu_splice_range(list_end(m), list_begin(l), NULL));
+    assert(-EINVAL == list_rcu_splice_range((struct list_iter *)&loose.link, list_begin(l), list_end(l)));
+    assert(-EINVAL == list_rcu_splice_range(list_end(m), (struct list_iter *)&loose.link, list_end(l)));
+    assert(-EINVAL == list_rcu_splice_range(list_end(m), list_begin(l), list_end(m)));
+    assert(-EINVAL == list_rcu_splice_range(list_end(m), list_next(list_begin(l)), list_begin(l)));
+    assert(-EINVAL == list_rcu_splice_range(list_end(o), list_begin(l), list_end(l)));
+    assert(-EINVAL == list_rcu_splice_range(list_begin(l), list_begin(l), list_end(l)));
+    assert(-ENOENT == list_rcu_splice_range(list_end(m), list_end(l), list_next(list_begin(l))));
+    assert(0 == list_rcu_splice_range(list_end(m), list_begin(l), list_begin(l)));
+    assert(0 == list_rcu_splice_range(list_next(list_begin(l)), list_begin(l), list_next(list_begin(l))));
+
+    m->size = SIZE_MAX - 1;
+    assert(-EOVERFLOW == list_rcu_splice_range(list_end(m), list_begin(l), list_end(l)));
+    m->size = 2;
+    assert(generation == m->generation);
+    assert_values(l, (const int[]){ 0, 1, 2, 3, 4 }, 5);
+
+    // Within one list.
+    assert(0 == list_rcu_splice(list_begin(l), list_prev(list_end(l))));
+    assert_values(l, (const int[]){ 4, 0, 1, 2, 3 }, 5);
+    assert(0 == list_rcu_splice_range(list_end(l), list_begin(l), list_next(list_next(list_begin(l)))));
+    assert_values(l, (const int[]){ 1, 2, 3, 4, 0 }, 5);
+
+    // Between lists.
+    g_membarrier = false;
+    assert(0 == list_rcu_splice_range(list_begin(m), list_next(list_begin(l)), list_prev(list_end(l))));
+    g_membarrier = true;
+    assert_values(l, (const int[]){ 1, 0 }, 2);
+    assert_values(m, (const int[]){ 2, 3, 4, 0, 1 }, 5);
+    assert(m == list_begin(m)->node.list);
+    assert(generation != m->generation);
+
+    // Plain operations see a consistent list.
+    assert(2 == *(int *)list_at(list_begin(m)));
+    assert(1 == *(int *)list_at(list_prev(list_end(m))));
+
+    list_delete(l, free);
+    list_delete(m, free);
+    list_delete(o, NULL);
+}
+
+struct holder {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    bool inside;
+};
+
+/// Hold a read-side critical section for a while, in another thread.
+static void *holder_run(void *arg)
+{
+    struct holder *h = arg;
+    struct timespec delay = { .tv_nsec = 20 * 1000 * 1000 };
+
+    assert(0 == list_rcu_register());
+    list_rcu_read_lock();
+
+    pthread_mutex_lock(&h->lock);
+    h->inside = true;
+    pthread_cond_signal(&h->cond);
+    pthread_mutex_unlock(&h->lock);
+
+    nanosleep(&delay, NULL);
+    list_rcu_read_unlock();
+    return NULL;
+}
+
+static pthread_t start_holder(struct holder *h)
+{
+    pthread_t thread;
+
+    *h = (struct holder){ PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, false };
+    assert(0 == pthread_create(&thread, NULL, holder_run, h));
+
+    pthread_mutex_lock(&h->lock);
+    while (!h->inside) {
+        pthread_cond_wait(&h->cond, &h->lock);
+    }
+    pthread_mutex_unlock(&h->lock);
+
+    return thread;
+}
+
+static void test_grace_period(void)
+{
+    struct list *l = make_list(3);
+    struct holder h;
+    pthread_t thread;
+
+    // Splice waits for the reader to leave.
+    thread = start_holder(&h);
+    assert(0 == list_rcu_splice(list_begin(l), list_prev(list_end(l))));
+    assert_values(l, (const int[]){ 2, 0, 1 }, 3);
+    assert(0 == pthread_join(thread, NULL));
+
+    // So does synchronize.
+    atomic_store(&destroyed, 0);
+    thread = start_holder(&h);
+    assert(0 == list_rcu_erase(list_begin(l), destroy));
+    assert(0 == atomic_load(&destroyed));
+    list_rcu_synchronize();
+    assert(1 == atomic_load(&destroyed));
+    assert(0 == pthread_join(thread, NULL));
+
+    list_delete(l, free);
+}
+
+struct reader {
+    struct list *l;
+    atomic_bool *stop;
+    atomic_long passes;
+};
+
+/// Traverse the list until told to stop. Each pass must end at the list's own end, visit no value twice, and never
+/// touch a destroyed element.
+static void *reader_run(void *arg)
+{
+    struct reader *r = arg;
+
+    assert(0 == list_rcu_register());
+
+    while (!atomic_load(r->stop)) {
+        bool seen[VALUES] = { false };
+        const struct list_iter *it;
+
+        list_rcu_read_lock();
+        for (it = list_rcu_cbegin(r->l); it != list_cend(r->l); it = list_rcu_cnext(it)) {
+            int n;
+
+            assert(it);
+            n = value(it);
+            assert(n >= 0 && n < VALUES);
+            assert(!seen[n]);
+            seen[n] = true;
+        }
+        list_rcu_read_unlock();
+        atomic_fetch_add(&r->passes, 1);
+    }
+
+    return NULL;
+}
+
+static void test_concurrent(void)
+{
+    struct list *l = list_new(offsetof(struct node, link));
+    struct list *spare = list_new(offsetof(struct node, link));
+    struct reader readers[READERS];
+    pthread_t threads[READERS];
+    atomic_bool stop = false;
+    bool present[VALUES] = { false };
+    unsigned seed = 1;
+
+    for (int i = 0; i < READERS; i++) {
+        readers[i] = (struct reader){ .l = l, .stop = &stop };
+        assert(0 == pthread_create(&threads[i], NULL, reader_run, &readers[i]));
+    }
+
+    // Make sure every reader is running before the writer starts.
+    for (int i = 0; i < READERS; i++) {
+        while (atomic_load(&readers[i].passes) == 0) {
+            sched_yield();
+        }
+    }
+
+    for (int i = 0; i < WRITES; i++) {
+        int n = (int)(rand_r(&seed) % VALUES);
+        unsigned op = rand_r(&seed) % 4;
+        struct list_iter *it;
+
+        if (op == 0 && !present[n]) {
+            assert(list_rcu_push_front(l, make_n(n)));
+            present[n] = true;
+        } else if (op == 1 && list_size(l) > 0) {
+            it = list_begin(l);
+            present[*(int *)list_at(it)] = false;
+            assert(0 == list_rcu_erase(it, destroy));
+        } else if (op == 2 && list_size(l) > 1) {
+            assert(0 == list_rcu_splice(list_begin(l), list_prev(list_end(l))));
+        } else if (op == 3 && list_size(l) > 2) {
+            // Park a range in another list, and bring it back.
+            assert(0 == list_rcu_splice_range(list_end(spare), list_next(list_begin(l)), list_prev(list_end(l))));
+            assert(0 == list_rcu_splice_range(list_begin(l), list_begin(spare), list_end(spare)));
+        }
+    }
+
+    atomic_store(&stop, true);
+    for (int i = 0; i < READERS; i++) {
+        assert(0 == pthread_join(threads[i], NULL));
+    }
+
+    list_rcu_synchronize();
+    list_delete(l, free);
+    list_delete(spare, free);
+}
+
+int main(void)
+{
+    test_registration();
+    test_iteration();
+    test_insert();
+    test_erase();
+    test_erase_partial_reclaim();
+    test_splice();
+    test_grace_period();
+    test_concurrent();
+    return 0;
+}
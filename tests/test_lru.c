@@ -0,0 +1,390 @@
+#include "lru.h"
+
+#include "memory_shim.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+
+#include "lru.c"
+
+struct node
+{
+    int key;
+    LRU_NODE(link);
+};
+
+static size_t hash_key(const void *element)
+{
+    return (size_t)((const struct node *)element)->key;
+}
+
+/// Forces every key into the same bucket.
+static size_t hash_zero(const void *element)
+{
+    (void)element;
+    return 0;
+}
+
+static int cmp_key(const void *a, const void *b)
+{
+    return ((const struct node *)a)->key != ((const struct node *)b)->key;
+}
+
+static struct node *make_n(int key)
+{
+    struct node *node = calloc(1, sizeof(struct node));
+    node->key = key;
+    return node;
+}
+
+/// Evicted keys, in the order passed to the callback.
+struct evicted {
+    int keys[64];
+    size_t count;
+    size_t calls;
+};
+
+static void evict_free(struct list *victims, void *ctx)
+{
+    struct evicted *e = ctx;
+    struct node *node;
+
+    e->calls++;
+    while ((node = list_pop_front(victims))) {
+        e->keys[e->count++] = node->key;
+        free(node);
+    }
+}
+
+/// Leaves the victims in the list; the cache unlinks them.
+static void evict_keep(struct list *victims, void *ctx)
+{
+    struct evicted *e = ctx;
+
+    e->calls++;
+    for (struct list_iter *it = list_begin(victims); it != list_end(victims); it = list_next(it)) {
+        e->keys[e->count++] = ((struct node *)list_at(it))->key;
+    }
+}
+
+/// Assert that cache @c c holds exactly the keys @c expect[0..n), most recently used first.
+static void assert_keys(struct lru *c, const int *expect, size_t n)
+{
+    struct list_iter *it = list_begin(c->list);
+
+    assert(n == lru_size(c));
+    for (size_t i = 0; i < n; i++) {
+        struct node *node = list_at(it);
+        assert(expect[i] == node->key);
+        assert(node == lru_peek(c, node));
+        it = list_next(it);
+    }
+    assert(it == list_end(c->list));
+}
+
+static void test_lru_new(void)
+{
+    struct lru *c;
+
+    errno = 0;
+    assert(NULL == lru_new(offsetof(struct node, link), NULL, cmp_key));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == lru_new(offsetof(struct node, link), hash_key, NULL));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == lru_new(1, hash_key, cmp_key));
+    assert(EINVAL == errno);
+
+    for (unsigned nth = 1; nth <= 4; nth++) {
+        memory_shim_fail_at(nth);
+        errno = 0;
+        c = lru_new(offsetof(struct node, link), hash_key, cmp_key);
+        memory_shim_reset();
+        assert(NULL == c);
+        assert(ENOMEM == errno);
+    }
+
+    c = lru_new(offsetof(struct node, link), hash_key, cmp_key);
+    assert(c);
+    assert(0 == lru_size(c));
+    assert(0 == lru_bytes(c));
+    assert(0 == lru_size(NULL));
+    assert(0 == lru_bytes(NULL));
+    lru_delete(c, free);
+    lru_delete(NULL, NULL);
+}
+
+static void test_lru_ops(void)
+{
+    struct lru *c = lru_new(offsetof(struct node, link), hash_key, cmp_key);
+    struct node key = { .key = 0 };
+    struct node *dup = make_n(2);
+    struct node loose = { .key = 9 };
+    struct node *node;
+
+    assert(-EFAULT == lru_put(NULL, dup, 0));
+    assert(-EFAULT == lru_put(c, NULL, 0));
+    assert(-EFAULT == lru_touch(NULL, dup));
+    assert(-EFAULT == lru_touch(c, NULL));
+    errno = 0;
+    assert(NULL == lru_get(NULL, &key));
+    assert(EFAULT == errno);
+    errno = 0;
+    assert(NULL == lru_get(c, NULL));
+    assert(EFAULT == errno);
+    errno = 0;
+    assert(NULL == lru_peek(NULL, &key));
+    assert(EFAULT == errno);
+    errno = 0;
+    assert(NULL == lru_peek(c, NULL));
+    assert(EFAULT == errno);
+    errno = 0;
+    assert(NULL == lru_remove(NULL, &key));
+    assert(EFAULT == errno);
+    errno = 0;
+    assert(NULL == lru_remove(c, NULL));
+    assert(EFAULT == errno);
+
+    for (int i = 1; i <= 4; i++) {
+        assert(0 == lru_put(c, make_n(i), (size_t)i));
+    }
+    assert(-EEXIST == lru_put(c, dup, 0));
+    assert_keys(c, (const int[]){ 4, 3, 2, 1 }, 4);
+    assert(10 == lru_bytes(c));
+
+    // Misses.
+    key.key = 7;
+    errno = 0;
+    assert(NULL == lru_get(c, &key));
+    assert(ENOENT == errno);
+    errno = 0;
+    assert(NULL == lru_peek(c, &key));
+    assert(ENOENT == errno);
+    errno = 0;
+    assert(NULL == lru_remove(c, &key));
+    assert(ENOENT == errno);
+
+    // Get promotes, peek does not.
+    key.key = 2;
+    node = lru_get(c, &key);
+    assert(2 == node->key);
+    assert_keys(c, (const int[]){ 2, 4, 3, 1 }, 4);
+    assert(node == lru_get(c, &key));
+    key.key = 1;
+    assert(1 == ((struct node *)lru_peek(c, &key))->key);
+    assert_keys(c, (const int[]){ 2, 4, 3, 1 }, 4);
+
+    // Touch.
+    assert(-EINVAL == lru_touch(c, &loose));
+    assert(0 == lru_touch(c, lru_peek(c, &key)));
+    assert_keys(c, (const int[]){ 1, 2, 4, 3 }, 4);
+
+    // Remove returns ownership.
+    key.key = 4;
+    node = lru_remove(c, &key);
+    assert(4 == node->key);
+    assert(!node->link.link.list);
+    assert(6 == lru_bytes(c));
+    assert_keys(c, (const int[]){ 1, 2, 3 }, 3);
+    assert(-EINVAL == lru_touch(c, node));
+
+    // Reinsert.
+    assert(0 == lru_put(c, node, 4));
+    assert_keys(c, (const int[]){ 4, 1, 2, 3 }, 4);
+
+    // Overflow.
+    assert(-EOVERFLOW == lru_put(c, dup, SIZE_MAX));
+    free(dup);
+
+    lru_delete(c, free);
+}
+
+static void test_lru_collisions(void)
+{
+    struct lru *c = lru_new(offsetof(struct node, link), hash_zero, cmp_key);
+    struct evicted e = { .count = 0 };
+    struct node key = { .key = 0 };
+
+    lru_set_eviction(c, evict_free, &e, 0);
+
+    for (int i = 0; i < 8; i++) {
+        assert(0 == lru_put(c, make_n(i), 0));
+    }
+
+    // Unchain from the middle, the head and the tail of one chain.
+    key.key = 4;
+    free(lru_remove(c, &key));
+    key.key = 0;
+    free(lru_remove(c, &key));
+    key.key = 7;
+    free(lru_remove(c, &key));
+    assert_keys(c, (const int[]){ 6, 5, 3, 2, 1 }, 5);
+
+    // Evict from the middle of a chain.
+    key.key = 1;
+    assert(lru_get(c, &key));
+    assert(2 == lru_evict(c, 2));
+    assert_keys(c, (const int[]){ 1, 6, 5 }, 3);
+    assert(2 == e.keys[1]);
+
+    lru_delete(c, free);
+}
+
+static void test_lru_grow(void)
+{
+    struct lru *c = lru_new(offsetof(struct node, link), hash_key, cmp_key);
+    struct node key = { .key = 0 };
+
+    for (int i = 0; i < 1000; i++) {
+        assert(0 == lru_put(c, make_n(i), 0));
+    }
+    assert(1023 == c->mask);
+
+    for (int i = 0; i < 1000; i++) {
+        key.key = i;
+        assert(i == ((struct node *)lru_peek(c, &key))->key);
+    }
+
+    // Without memory for more buckets, chains grow longer.
+    for (int i = 1000; i < 1100; i++) {
+        struct node *node = make_n(i);
+        memory_shim_fail_at(1);
+        assert(0 == lru_put(c, node, 0));
+        memory_shim_reset();
+    }
+    assert(1023 == c->mask);
+    key.key = 1050;
+    assert(1050 == ((struct node *)lru_peek(c, &key))->key);
+
+    lru_delete(c, free);
+}
+
+static void test_lru_capacity(void)
+{
+    struct lru *c = lru_new(offsetof(struct node, link), hash_key, cmp_key);
+    struct evicted e = { .count = 0 };
+    struct node key = { .key = 0 };
+
+    assert(-EFAULT == lru_set_capacity(NULL, 1, 0));
+    assert(-EFAULT == lru_set_eviction(NULL, evict_free, &e, 0));
+    assert(0 == lru_set_eviction(c, evict_free, &e, 0));
+
+    // By count.
+    assert(0 == lru_set_capacity(c, 3, 0));
+    for (int i = 0; i < 5; i++) {
+        assert(0 == lru_put(c, make_n(i), 10));
+    }
+    assert_keys(c, (const int[]){ 4, 3, 2 }, 3);
+    assert(30 == lru_bytes(c));
+    assert(2 == e.count);
+    assert(0 == e.keys[0]);
+    assert(1 == e.keys[1]);
+
+    // A recently used element survives.
+    key.key = 2;
+    assert(lru_get(c, &key));
+    assert(0 == lru_put(c, make_n(5), 10));
+    assert_keys(c, (const int[]){ 5, 2, 4 }, 3);
+    assert(3 == e.keys[2]);
+
+    // By bytes: shrinking evicts at once.
+    e = (struct evicted){ .count = 0 };
+    assert(0 == lru_set_capacity(c, 0, 25));
+    assert_keys(c, (const int[]){ 5, 2 }, 2);
+    assert(1 == e.calls);
+    assert(4 == e.keys[0]);
+
+    assert(0 == lru_put(c, make_n(6), 5));
+    assert_keys(c, (const int[]){ 6, 5, 2 }, 3);
+    assert(25 == lru_bytes(c));
+    assert(0 == lru_put(c, make_n(7), 15));
+    assert_keys(c, (const int[]){ 7, 6 }, 2);
+    assert(20 == lru_bytes(c));
+
+    // An element larger than the capacity is evicted at once.
+    e = (struct evicted){ .count = 0 };
+    assert(0 == lru_put(c, make_n(8), 100));
+    assert(0 == lru_size(c));
+    assert(0 == lru_bytes(c));
+    assert(3 == e.count);
+    assert(1 == e.calls);
+    assert(8 == e.keys[0]);
+
+    // Unlimited.
+    assert(0 == lru_set_capacity(c, 0, 0));
+    for (int i = 0; i < 10; i++) {
+        assert(0 == lru_put(c, make_n(i), 100));
+    }
+    assert(10 == lru_size(c));
+
+    lru_delete(c, free);
+}
+
+static void test_lru_batch(void)
+{
+    struct lru *c = lru_new(offsetof(struct node, link), hash_key, cmp_key);
+    struct evicted e = { .count = 0 };
+    struct node *nodes[12];
+
+    assert(0 == lru_set_eviction(c, evict_keep, &e, 4));
+    assert(0 == lru_set_capacity(c, 10, 0));
+
+    for (int i = 0; i < 10; i++) {
+        nodes[i] = make_n(i);
+        assert(0 == lru_put(c, nodes[i], 1));
+    }
+    assert(0 == e.calls);
+
+    // Going over capacity by one evicts a batch of four, most recently used first.
+    nodes[10] = make_n(10);
+    assert(0 == lru_put(c, nodes[10], 1));
+    assert(1 == e.calls);
+    assert(4 == e.count);
+    assert(3 == e.keys[0]);
+    assert(0 == e.keys[3]);
+    assert(7 == lru_size(c));
+    assert(7 == lru_bytes(c));
+
+    // The callback left them in the list; they are unlinked and owned by the caller again.
+    for (int i = 0; i < 4; i++) {
+        assert(!nodes[i]->link.link.list);
+        assert(-EINVAL == lru_touch(c, nodes[i]));
+        free(nodes[i]);
+    }
+
+    // Explicit eviction, without a callback.
+    assert(0 == lru_set_eviction(c, NULL, NULL, 0));
+    assert(0 == lru_evict(NULL, 1));
+    assert(0 == lru_evict(c, 0));
+    assert(2 == lru_evict(c, 2));
+    assert(5 == lru_size(c));
+    assert(!nodes[4]->link.link.list);
+    assert(!nodes[5]->link.link.list);
+    free(nodes[4]);
+    free(nodes[5]);
+
+    // Everything.
+    assert(5 == lru_evict(c, 100));
+    assert(0 == lru_size(c));
+    assert(0 == lru_bytes(c));
+    for (int i = 6; i <= 10; i++) {
+        free(nodes[i]);
+    }
+
+    lru_delete(c, free);
+}
+
+int main(void)
+{
+    test_lru_new();
+    test_lru_ops();
+    test_lru_collisions();
+    test_lru_grow();
+    test_lru_capacity();
+    test_lru_batch();
+    return 0;
+}
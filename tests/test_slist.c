@@ -0,0 +1,275 @@
+#include "slist.h"
+
+#include "memory_shim.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+
+#include "slist.c"
+
+struct node
+{
+    int n;
+    SLIST_NODE(link);
+};
+
+static struct node *make(void)
+{
+    return calloc(1, sizeof(struct node));
+}
+
+static struct node *make_n(int n)
+{
+    struct node *node = make();
+    node->n = n;
+    return node;
+}
+
+/// Assert that list @c l holds exactly the values @c expect[0..n).
+static void assert_values(struct slist *l, const int *expect, size_t n)
+{
+    struct slist_iter *it = slist_begin(l);
+
+    assert(n == slist_size(l));
+    for (size_t i = 0; i < n; i++) {
+        assert(expect[i] == ((struct node *)slist_at(l, it))->n);
+        it = slist_next(l, it);
+    }
+    assert(it == slist_end(l));
+}
+
+static void test_layout(void)
+{
+    assert(sizeof(struct slist_node) == sizeof(void *));
+}
+
+static void test_slist_new(void)
+{
+    struct slist *l;
+
+    errno = 0;
+    l = slist_new(1);
+    assert(NULL == l);
+    assert(EINVAL == errno);
+
+    memory_shim_fail_at(1);
+    errno = 0;
+    l = slist_new(offsetof(struct node, link));
+    memory_shim_reset();
+    assert(NULL == l);
+    assert(ENOMEM == errno);
+
+    slist_delete(NULL, NULL);
+}
+
+static void test_slist_size(void)
+{
+    struct slist *l;
+
+    assert(slist_empty(NULL));
+    assert(0 == slist_size(NULL));
+    assert(-EFAULT == slist_clear(NULL, NULL));
+
+    l = slist_new(offsetof(struct node, link));
+    assert(slist_empty(l));
+
+    slist_push_back(l, make_n(1));
+    slist_push_back(l, make_n(2));
+    assert(!slist_empty(l));
+    assert(2 == slist_size(l));
+
+    assert(0 == slist_clear(l, free));
+    assert(slist_empty(l));
+    assert(slist_begin(l) == slist_end(l));
+
+    // Tail is reset.
+    slist_push_back(l, make_n(3));
+    assert_values(l, (const int[]){3}, 1);
+
+    slist_delete(l, free);
+}
+
+static void test_slist_iterator(void)
+{
+    struct slist *l;
+    struct node *n;
+
+    errno = 0;
+    assert(NULL == slist_begin(NULL));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == slist_end(NULL));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == slist_before_begin(NULL));
+    assert(EFAULT == errno);
+
+    l = slist_new(offsetof(struct node, link));
+
+    errno = 0;
+    assert(NULL == slist_next(l, NULL));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == slist_next(NULL, slist_end(l)));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == slist_next(l, slist_end(l)));
+    assert(ERANGE == errno);
+
+    errno = 0;
+    assert(NULL == slist_at(l, slist_end(l)));
+    assert(ENOENT == errno);
+
+    errno = 0;
+    assert(NULL == slist_at(l, NULL));
+    assert(EFAULT == errno);
+
+    // Unlinked node.
+    n = make_n(0);
+    errno = 0;
+    assert(NULL == slist_at(l, (struct slist_iter *)&n->link));
+    assert(EINVAL == errno);
+    free(n);
+
+    slist_delete(l, free);
+}
+
+static void test_slist_insert(void)
+{
+    struct slist *l;
+    struct slist_iter *it;
+    struct node *n;
+
+    l = slist_new(offsetof(struct node, link));
+
+    errno = 0;
+    assert(NULL == slist_push_back(NULL, NULL));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == slist_push_front(l, NULL));
+    assert(EFAULT == errno);
+
+    n = make_n(0);
+    errno = 0;
+    assert(NULL == slist_insert_after(l, NULL, n));
+    assert(EFAULT == errno);
+
+    // Simulate size overflow.
+    l->size = SIZE_MAX;
+    errno = 0;
+    assert(NULL == slist_push_back(l, n));
+    assert(EOVERFLOW == errno);
+    l->size = 0;
+    free(n);
+
+    slist_push_back(l, make_n(2));
+    slist_push_front(l, make_n(1));
+    it = slist_push_back(l, make_n(4));
+    slist_insert_after(l, slist_begin(l), make_n(3));
+    assert_values(l, (const int[]){1, 3, 2, 4}, 4);
+
+    // Insert after the tail extends the list.
+    slist_insert_after(l, it, make_n(5));
+    slist_push_back(l, make_n(6));
+    assert_values(l, (const int[]){1, 3, 2, 4, 5, 6}, 6);
+
+    slist_delete(l, free);
+}
+
+static void test_slist_erase(void)
+{
+    struct slist *l;
+    struct slist_iter *it;
+    struct node *n;
+
+    l = slist_new(offsetof(struct node, link));
+
+    errno = 0;
+    assert(NULL == slist_pop_front(NULL));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == slist_pop_front(l));
+    assert(ENOENT == errno);
+
+    assert(-EFAULT == slist_erase_after(l, NULL, free));
+    assert(-ENOENT == slist_erase_after(l, slist_before_begin(l), free));
+
+    for (int i = 1; i <= 4; i++) {
+        slist_push_back(l, make_n(i));
+    }
+
+    n = slist_pop_front(l);
+    assert(1 == n->n);
+    free(n);
+
+    // Erase the tail; push_back continues from the new tail.
+    it = slist_begin(l);
+    it = slist_next(l, it);
+    assert(-ENOENT == slist_erase_after(l, slist_next(l, it), free));
+    assert(0 == slist_erase_after(l, it, free));
+    assert_values(l, (const int[]){2, 3}, 2);
+    slist_push_back(l, make_n(5));
+    assert_values(l, (const int[]){2, 3, 5}, 3);
+
+    // Erase without destructor; the node is marked unlinked.
+    it = slist_next(l, slist_begin(l));
+    n = slist_at(l, it);
+    assert(0 == slist_erase_after(l, slist_begin(l), NULL));
+    assert(-EINVAL == slist_erase_after(l, it, free));
+    free(n);
+    assert_values(l, (const int[]){2, 5}, 2);
+
+    // Drain.
+    free(slist_pop_front(l));
+    free(slist_pop_front(l));
+    assert(slist_empty(l));
+    slist_push_back(l, make_n(7));
+    assert_values(l, (const int[]){7}, 1);
+
+    slist_delete(l, free);
+}
+
+static void test_stress(void)
+{
+    struct slist *l;
+    size_t n;
+    int next = 1;
+
+    l = slist_new(offsetof(struct node, link));
+
+    n = 0;
+    for (int i = 1; i <= 1000; i++) {
+        slist_push_back(l, make_n(i));
+        n++;
+        assert(n == slist_size(l));
+
+        if (i % 3 == 0) {
+            struct node *node = slist_pop_front(l);
+            assert(next++ == node->n);
+            free(node);
+            n--;
+            assert(n == slist_size(l));
+        }
+    }
+
+    slist_delete(l, free);
+}
+
+int main(void)
+{
+    test_layout();
+    test_slist_new();
+    test_slist_size();
+    test_slist_iterator();
+    test_slist_insert();
+    test_slist_erase();
+    test_stress();
+    return 0;
+}
@@ -0,0 +1,254 @@
+#include "timerwheel.h"
+
+#include "memory_shim.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+
+#include "timerwheel.c"
+
+struct node
+{
+    TIMERWHEEL_NODE(timer);
+    int key;
+};
+
+/// Expiry log, and what the callback does with each batch.
+struct expired {
+    int keys[64];
+    uint64_t ticks[64];
+    size_t count;
+    size_t calls;
+    /// Wheel to reschedule timers into, or NULL.
+    struct timerwheel *rearm;
+    /// Key of a timer to cancel from within the batch, or -1.
+    int cancel;
+};
+
+static struct expired g_log;
+
+/// Records the batch, pops the first timer, and leaves the rest for the wheel to unlink.
+static void on_expire(struct list *batch, void *ctx)
+{
+    struct expired *e = ctx;
+
+    assert(!list_empty(batch));
+    e->calls++;
+    for (struct list_iter *it = list_begin(batch); it != list_end(batch); it = list_next(it)) {
+        struct node *node = list_at(it);
+        e->keys[e->count] = node->key;
+        e->ticks[e->count++] = timerwheel_now(e->rearm);
+    }
+    list_pop_front(batch);
+}
+
+/// Reschedules every timer one tick later, except the one to cancel.
+static void on_expire_rearm(struct list *batch, void *ctx)
+{
+    struct expired *e = ctx;
+    struct node *node;
+
+    e->calls++;
+    while (!list_empty(batch)) {
+        node = list_at(list_begin(batch));
+        e->keys[e->count] = node->key;
+        e->ticks[e->count++] = timerwheel_now(e->rearm);
+        if (node->key == e->cancel) {
+            assert(0 == timerwheel_cancel(e->rearm, node));
+            e->cancel = -1;
+        } else {
+            assert(0 == timerwheel_schedule(e->rearm, node, node->timer.expires + 1));
+        }
+    }
+}
+
+static struct timerwheel *make_w(uint64_t now, void (*expire)(struct list *, void *))
+{
+    g_log = (struct expired){ .cancel = -1 };
+    g_log.rearm = timerwheel_new(offsetof(struct node, timer), now, expire, &g_log);
+    return g_log.rearm;
+}
+
+static void test_timerwheel_new(void)
+{
+    struct timerwheel *w;
+
+    errno = 0;
+    assert(NULL == timerwheel_new(0, 0, NULL, NULL));
+    assert(EFAULT == errno);
+
+    errno = 0;
+    assert(NULL == timerwheel_new(1, 0, on_expire, NULL));
+    assert(EINVAL == errno);
+
+    // The wheel, its first slot, and the spare slot.
+    const unsigned fail[] = { 1, 2, 2 + TIMERWHEEL_LEVELS * TIMERWHEEL_SLOTS };
+    for (size_t k = 0; k < sizeof(fail) / sizeof(fail[0]); k++) {
+        memory_shim_fail_at(fail[k]);
+        errno = 0;
+        w = timerwheel_new(0, 0, on_expire, NULL);
+        memory_shim_reset();
+        assert(NULL == w);
+        assert(ENOMEM == errno);
+    }
+
+    w = timerwheel_new(0, 42, on_expire, NULL);
+    assert(w);
+    assert(0 == timerwheel_size(w));
+    assert(42 == timerwheel_now(w));
+    assert(0 == timerwheel_size(NULL));
+    assert(0 == timerwheel_now(NULL));
+    assert(0 == timerwheel_advance(NULL, 1));
+    timerwheel_delete(w, free);
+    timerwheel_delete(NULL, NULL);
+}
+
+static void test_timerwheel_ops(void)
+{
+    struct timerwheel *w = make_w(100, on_expire);
+    struct node nodes[4] = { { .key = 0 }, { .key = 1 }, { .key = 2 }, { .key = 3 } };
+
+    assert(-EFAULT == timerwheel_schedule(NULL, &nodes[0], 1));
+    assert(-EFAULT == timerwheel_schedule(w, NULL, 1));
+    assert(-EFAULT == timerwheel_cancel(NULL, &nodes[0]));
+    assert(-EFAULT == timerwheel_cancel(w, NULL));
+    assert(-EINVAL == timerwheel_cancel(w, &nodes[0]));
+
+    assert(0 == timerwheel_schedule(w, &nodes[0], 105));
+    assert(0 == timerwheel_schedule(w, &nodes[1], 105));
+    assert(0 == timerwheel_schedule(w, &nodes[2], 103));
+    // Overdue timers expire on the next tick.
+    assert(0 == timerwheel_schedule(w, &nodes[3], 50));
+    assert(4 == timerwheel_size(w));
+
+    assert(1 == timerwheel_advance(w, 101));
+    assert(3 == g_log.keys[0]);
+    assert(101 == g_log.ticks[0]);
+    assert(3 == timerwheel_size(w));
+
+    // Time does not go backwards.
+    assert(0 == timerwheel_advance(w, 90));
+    assert(101 == timerwheel_now(w));
+
+    // Reschedule, then cancel.
+    assert(0 == timerwheel_schedule(w, &nodes[2], 104));
+    assert(0 == timerwheel_schedule(w, &nodes[2], 104));
+    assert(3 == timerwheel_size(w));
+    assert(0 == timerwheel_advance(w, 103));
+    assert(0 == timerwheel_cancel(w, &nodes[2]));
+    assert(!nodes[2].timer.link.list);
+    assert(-EINVAL == timerwheel_cancel(w, &nodes[2]));
+    assert(2 == timerwheel_size(w));
+
+    // One batch per tick, in scheduling order; the wheel unlinks what the callback leaves.
+    assert(2 == timerwheel_advance(w, 200));
+    assert(2 == g_log.calls);
+    assert(0 == g_log.keys[1]);
+    assert(1 == g_log.keys[2]);
+    assert(105 == g_log.ticks[1]);
+    assert(!nodes[0].timer.link.list);
+    assert(!nodes[1].timer.link.list);
+    assert(0 == timerwheel_size(w));
+
+    // An empty wheel skips ahead.
+    assert(0 == timerwheel_advance(w, 1u << 30));
+    assert(1u << 30 == timerwheel_now(w));
+
+    timerwheel_delete(w, NULL);
+}
+
+static void test_timerwheel_rearm(void)
+{
+    struct timerwheel *w = make_w(0, on_expire_rearm);
+    struct node nodes[3] = { { .key = 0 }, { .key = 1 }, { .key = 2 } };
+
+    for (int i = 0; i < 3; i++) {
+        assert(0 == timerwheel_schedule(w, &nodes[i], 10));
+    }
+
+    // The callback reschedules two timers and cancels one.
+    g_log.cancel = 1;
+    assert(3 == timerwheel_advance(w, 10));
+    assert(1 == g_log.calls);
+    assert(2 == timerwheel_size(w));
+    assert(!nodes[1].timer.link.list);
+
+    assert(2 == timerwheel_advance(w, 11));
+    assert(2 == timerwheel_size(w));
+    assert(12 == nodes[0].timer.expires);
+    assert(0 == g_log.keys[3]);
+    assert(2 == g_log.keys[4]);
+    assert(11 == g_log.ticks[4]);
+
+    timerwheel_delete(w, NULL);
+}
+
+/// Move time to just before @c tick, then process it; valid only if no timer is due before @c tick.
+static void jump(struct timerwheel *w, uint64_t tick)
+{
+    w->now = tick - 1;
+    assert(0 == timerwheel_advance(w, tick));
+}
+
+static void test_timerwheel_cascade(void)
+{
+    struct timerwheel *w = make_w(7, on_expire);
+    const uint64_t due[] = { 8, 263, 300, 70007, 70000 };
+    struct node *nodes[5];
+
+    for (int i = 0; i < 5; i++) {
+        nodes[i] = calloc(1, sizeof(struct node));
+        nodes[i]->key = i;
+        assert(0 == timerwheel_schedule(w, nodes[i], due[i]));
+    }
+
+    // Each timer expires exactly when due, after cascading down from its level.
+    assert(5 == timerwheel_advance(w, 80000));
+    assert(5 == g_log.calls);
+    assert(0 == g_log.keys[0] && 8 == g_log.ticks[0]);
+    assert(1 == g_log.keys[1] && 263 == g_log.ticks[1]);
+    assert(2 == g_log.keys[2] && 300 == g_log.ticks[2]);
+    assert(4 == g_log.keys[3] && 70000 == g_log.ticks[3]);
+    assert(3 == g_log.keys[4] && 70007 == g_log.ticks[4]);
+
+    // Level 3 holds timers up to 2^32 ticks ahead. Nothing else is pending, so skip ahead to just before each of its
+    // cascade points.
+    g_log.count = 0;
+    assert(0 == timerwheel_schedule(w, nodes[0], 80000 + ((uint64_t)1 << 24) + 5));
+    assert(w->slots[3][1] == nodes[0]->timer.link.list);
+    jump(w, (uint64_t)1 << 24);
+    assert(w->slots[2][1] == nodes[0]->timer.link.list);
+    assert(1 == timerwheel_advance(w, 90000 + ((uint64_t)1 << 24)));
+    assert(80000 + ((uint64_t)1 << 24) + 5 == g_log.ticks[0]);
+
+    // Beyond 2^32 ticks, timers park in the farthest slot and cascade again.
+    assert(0 == timerwheel_schedule(w, nodes[1], ((uint64_t)3 << 32) + 100));
+    assert(w->slots[3][1] == nodes[1]->timer.link.list);
+    jump(w, ((uint64_t)1 << 32) + ((uint64_t)1 << 24));
+    assert(w->slots[3][0] == nodes[1]->timer.link.list);
+    jump(w, (uint64_t)2 << 32);
+    assert(w->slots[3][255] == nodes[1]->timer.link.list);
+    jump(w, (uint64_t)767 << 24);
+    assert(w->slots[3][0] == nodes[1]->timer.link.list);
+    jump(w, (uint64_t)3 << 32);
+    assert(w->slots[0][100] == nodes[1]->timer.link.list);
+    assert(1 == timerwheel_advance(w, ((uint64_t)3 << 32) + 200));
+    assert(((uint64_t)3 << 32) + 100 == g_log.ticks[1]);
+    assert(1 == g_log.keys[1]);
+
+    assert(0 == timerwheel_size(w));
+    timerwheel_delete(w, NULL);
+    for (int i = 0; i < 5; i++) {
+        free(nodes[i]);
+    }
+}
+
+int main(void)
+{
+    test_timerwheel_new();
+    test_timerwheel_ops();
+    test_timerwheel_rearm();
+    test_timerwheel_cascade();
+    return 0;
+}
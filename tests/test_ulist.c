@@ -0,0 +1,341 @@
+#include "ulist.h"
+
+#include "memory_shim.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "ulist.c"
+
+/// Distinct element pointers for values 0..N.
+enum { N = 1000 };
+static int values[N];
+
+static void *v(int i)
+{
+    return &values[i];
+}
+
+static int value(void *element)
+{
+    return (int)((int *)element - values);
+}
+
+/// Assert that list @c l holds exactly the values @c expect[0..n), forwards and backwards.
+static void assert_values(struct ulist *l, const int *expect, size_t n)
+{
+    struct ulist_iter it = ulist_begin(l);
+
+    assert(n == ulist_size(l));
+    for (size_t i = 0; i < n; i++) {
+        assert(expect[i] == value(ulist_at(it)));
+        it = ulist_next(it);
+    }
+    assert(ulist_iter_equal(it, ulist_end(l)));
+
+    for (size_t i = n; i > 0; i--) {
+        it = ulist_prev(it);
+        assert(expect[i - 1] == value(ulist_at(it)));
+    }
+    assert(ulist_iter_equal(it, ulist_begin(l)));
+}
+
+/// Assert chunk invariants.
+static void assert_chunks(struct ulist *l)
+{
+    size_t total = 0;
+
+    for (struct ulist_chunk *c = impl_first(l); c; c = impl_chunk(l, c->link.next)) {
+        assert(c->count > 0 && c->count <= ULIST_CHUNK_CAPACITY);
+        total += c->count;
+    }
+    assert(total == ulist_size(l));
+}
+
+static void test_layout(void)
+{
+    assert(0 == sizeof(struct ulist_chunk) % 64 || sizeof(void *) != 8);
+}
+
+static void test_ulist_new(void)
+{
+    struct ulist *l;
+
+    memory_shim_fail_at(1);
+    errno = 0;
+    l = ulist_new();
+    memory_shim_reset();
+    assert(NULL == l);
+    assert(ENOMEM == errno);
+
+    memory_shim_fail_at(2);
+    errno = 0;
+    l = ulist_new();
+    memory_shim_reset();
+    assert(NULL == l);
+    assert(ENOMEM == errno);
+
+    l = ulist_new();
+    assert(l);
+    assert(ulist_empty(l));
+    assert(0 == ulist_size(l));
+    ulist_delete(l, NULL);
+
+    ulist_delete(NULL, NULL);
+    assert(ulist_empty(NULL));
+    assert(0 == ulist_size(NULL));
+    assert(-EFAULT == ulist_clear(NULL, NULL));
+}
+
+static void test_ulist_iterator(void)
+{
+    struct ulist *l = ulist_new();
+    struct ulist_iter it;
+    struct ulist_iter none = { NULL, NULL, 0 };
+
+    it = ulist_begin(NULL);
+    assert(NULL == it.list && NULL == ulist_at(it));
+    assert(ulist_iter_equal(none, ulist_prev(none)));
+    assert(ulist_iter_equal(none, ulist_next(none)));
+
+    // Empty.
+    assert(ulist_iter_equal(ulist_begin(l), ulist_end(l)));
+    assert(ulist_iter_equal(ulist_end(l), ulist_prev(ulist_end(l))));
+    assert(ulist_iter_equal(ulist_end(l), ulist_next(ulist_end(l))));
+    assert(NULL == ulist_at(ulist_end(l)));
+
+    for (int i = 0; i < 30; i++) {
+        assert(0 == ulist_push_back(l, v(i)));
+    }
+
+    // Begin stays put.
+    assert(ulist_iter_equal(ulist_begin(l), ulist_prev(ulist_begin(l))));
+    assert(29 == value(ulist_at(ulist_prev(ulist_end(l)))));
+
+    ulist_delete(l, NULL);
+}
+
+static void test_ulist_insert(void)
+{
+    struct ulist *l = ulist_new();
+    struct ulist_iter it;
+    int expect[N];
+    size_t n = 0;
+
+    it = ulist_end(l);
+    assert(-EFAULT == ulist_insert(NULL, v(0)));
+    assert(-EFAULT == ulist_insert(&it, NULL));
+    it.list = NULL;
+    assert(-EFAULT == ulist_insert(&it, v(0)));
+    assert(-EFAULT == ulist_push_back(NULL, v(0)));
+    assert(-EFAULT == ulist_push_front(NULL, v(0)));
+    assert(-EFAULT == ulist_push_front(l, NULL));
+
+    // Fill one chunk, then insert into the middle to force a split.
+    for (int i = 0; i < ULIST_CHUNK_CAPACITY; i++) {
+        assert(0 == ulist_push_back(l, v(i)));
+        expect[n++] = i;
+    }
+
+    it = ulist_begin(l);
+    for (int i = 0; i < 3; i++) {
+        it = ulist_next(it);
+    }
+    assert(0 == ulist_insert(&it, v(100)));
+    assert(100 == value(ulist_at(it)));
+    memmove(&expect[4], &expect[3], (n - 3) * sizeof(int));
+    expect[3] = 100;
+    n++;
+    assert_values(l, expect, n);
+    assert_chunks(l);
+
+    // Split placing the new element in the upper chunk.
+    while (ulist_size(l) < 2 * ULIST_CHUNK_CAPACITY) {
+        assert(0 == ulist_push_back(l, v((int)n)));
+        expect[n] = (int)n;
+        n++;
+    }
+    it = ulist_prev(ulist_end(l));
+    assert(0 == ulist_insert(&it, v(200)));
+    assert(200 == value(ulist_at(it)));
+    expect[n] = expect[n - 1];
+    expect[n - 1] = 200;
+    n++;
+    assert_values(l, expect, n);
+    assert_chunks(l);
+
+    // Push front into full and partial chunks.
+    for (int i = 0; i < ULIST_CHUNK_CAPACITY + 1; i++) {
+        assert(0 == ulist_push_front(l, v(300 + i)));
+        memmove(&expect[1], &expect[0], n * sizeof(int));
+        expect[0] = 300 + i;
+        n++;
+    }
+    assert_values(l, expect, n);
+    assert_chunks(l);
+
+    // Allocation failure.
+    it = ulist_end(l);
+    while (impl_last(l)->count != ULIST_CHUNK_CAPACITY) {
+        assert(0 == ulist_insert(&it, v(0)));
+        it = ulist_end(l);
+        n++;
+    }
+    memory_shim_fail_at(1);
+    assert(-ENOMEM == ulist_push_back(l, v(0)));
+    memory_shim_fail_at(1);
+    it = ulist_begin(l);
+    it.chunk = impl_last(l);
+    assert(-ENOMEM == ulist_insert(&it, v(0)));
+    while (impl_first(l)->count != ULIST_CHUNK_CAPACITY) {
+        assert(0 == ulist_push_front(l, v(0)));
+        n++;
+    }
+    memory_shim_fail_at(1);
+    assert(-ENOMEM == ulist_push_front(l, v(0)));
+    memory_shim_reset();
+    assert(n == ulist_size(l));
+    assert_chunks(l);
+
+    // Overflow.
+    l->size = SIZE_MAX;
+    assert(-EOVERFLOW == ulist_push_back(l, v(0)));
+    assert(-EOVERFLOW == ulist_push_front(l, v(0)));
+    l->size = n;
+
+    ulist_delete(l, NULL);
+}
+
+static int destroyed;
+
+static void destroy(void *element)
+{
+    (void)element;
+    destroyed++;
+}
+
+static void test_ulist_erase(void)
+{
+    struct ulist *l = ulist_new();
+    struct ulist_iter it;
+    int expect[N];
+    size_t n = 0;
+
+    it = ulist_end(l);
+    assert(-EFAULT == ulist_erase(NULL, NULL));
+    assert(-ENOENT == ulist_erase(&it, NULL));
+    it.list = NULL;
+    assert(-EFAULT == ulist_erase(&it, NULL));
+
+    errno = 0;
+    assert(NULL == ulist_pop_front(NULL));
+    assert(EFAULT == errno);
+    errno = 0;
+    assert(NULL == ulist_pop_front(l));
+    assert(ENOENT == errno);
+    errno = 0;
+    assert(NULL == ulist_pop_back(l));
+    assert(ENOENT == errno);
+
+    for (int i = 0; i < 4 * ULIST_CHUNK_CAPACITY; i++) {
+        assert(0 == ulist_push_back(l, v(i)));
+        expect[n++] = i;
+    }
+
+    // Erase every other element; iterator advances to the successor each time.
+    destroyed = 0;
+    it = ulist_begin(l);
+    while (!ulist_iter_equal(it, ulist_end(l))) {
+        int next = value(ulist_at(it)) + 1;
+        assert(0 == ulist_erase(&it, destroy));
+        if (!ulist_iter_equal(it, ulist_end(l))) {
+            assert(next == value(ulist_at(it)));
+            it = ulist_next(it);
+        }
+        assert_chunks(l);
+    }
+    assert(2 * ULIST_CHUNK_CAPACITY == destroyed);
+    n = 0;
+    for (int i = 1; i < 4 * ULIST_CHUNK_CAPACITY; i += 2) {
+        expect[n++] = i;
+    }
+    assert_values(l, expect, n);
+
+    // Pop from both ends until empty.
+    while (n > 1) {
+        assert(expect[0] == value(ulist_pop_front(l)));
+        assert(expect[n - 1] == value(ulist_pop_back(l)));
+        memmove(&expect[0], &expect[1], (n - 2) * sizeof(int));
+        n -= 2;
+        assert_values(l, expect, n);
+        assert_chunks(l);
+    }
+
+    // Clear.
+    for (int i = 0; i < 100; i++) {
+        assert(0 == ulist_push_back(l, v(i)));
+    }
+    destroyed = 0;
+    assert(0 == ulist_clear(l, destroy));
+    assert(100 == destroyed);
+    assert(ulist_empty(l));
+
+    assert(0 == ulist_push_back(l, v(0)));
+    ulist_delete(l, destroy);
+    assert(101 == destroyed);
+}
+
+static void test_stress(void)
+{
+    struct ulist *l = ulist_new();
+    int expect[N];
+    size_t n = 0;
+    unsigned seed = 1;
+
+    for (int round = 0; round < 20000; round++) {
+        struct ulist_iter it = ulist_begin(l);
+        size_t pos;
+
+        seed = seed * 1103515245u + 12345u;
+        pos = n ? (seed >> 8) % (n + 1) : 0;
+        for (size_t i = 0; i < pos; i++) {
+            it = ulist_next(it);
+        }
+
+        if (n < N && ((seed >> 4) & 3) != 0 && n < 600) {
+            int x = round % N;
+            assert(0 == ulist_insert(&it, v(x)));
+            memmove(&expect[pos + 1], &expect[pos], (n - pos) * sizeof(int));
+            expect[pos] = x;
+            n++;
+        } else if (pos < n) {
+            assert(0 == ulist_erase(&it, NULL));
+            memmove(&expect[pos], &expect[pos + 1], (n - pos - 1) * sizeof(int));
+            n--;
+            if (pos < n) {
+                assert(expect[pos] == value(ulist_at(it)));
+            }
+        }
+
+        if (round % 97 == 0) {
+            assert_values(l, expect, n);
+            assert_chunks(l);
+        }
+    }
+
+    assert_values(l, expect, n);
+    ulist_delete(l, NULL);
+}
+
+int main(void)
+{
+    test_layout();
+    test_ulist_new();
+    test_ulist_iterator();
+    test_ulist_insert();
+    test_ulist_erase();
+    test_stress();
+    return 0;
+}
@@ -0,0 +1,244 @@
+#include "timerwheel.h"
+
+#include <errno.h>
+#include <stdlib.h>
+
+/// Number of levels.
+#define TIMERWHEEL_LEVELS 4
+/// Slots per level, as a power of two.
+#define TIMERWHEEL_BITS 8
+#define TIMERWHEEL_SLOTS (1u << TIMERWHEEL_BITS)
+#define TIMERWHEEL_MASK (TIMERWHEEL_SLOTS - 1)
+
+struct timerwheel {
+    /// Level @c n, slot @c i holds timers due within 256^(n+1) ticks whose bits [8n, 8n+8) of @c expires equal @c i.
+    struct list *slots[TIMERWHEEL_LEVELS][TIMERWHEEL_SLOTS];
+    /// Empty list swapped in for an expiring slot.
+    struct list *spare;
+    /// Batch being passed to the expiry callback, or NULL.
+    struct list *expired;
+    /// Last tick processed.
+    uint64_t now;
+    size_t size;
+    size_t offset;
+    void (*expire)(struct list *, void *);
+    void *ctx;
+};
+
+struct timerwheel *timerwheel_new(size_t offset, uint64_t now, void (*expire)(struct list *, void *), void *ctx)
+{
+    struct timerwheel *w;
+
+    if (!expire) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    if ((offset % sizeof(void *)) != 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    w = calloc(1, sizeof(struct timerwheel));
+    if (!w) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    for (size_t level = 0; level < TIMERWHEEL_LEVELS; level++) {
+        for (size_t i = 0; i < TIMERWHEEL_SLOTS; i++) {
+            w->slots[level][i] = list_new(offset);
+            if (!w->slots[level][i]) {
+                timerwheel_delete(w, NULL);
+                errno = ENOMEM;
+                return NULL;
+            }
+        }
+    }
+
+    w->spare = list_new(offset);
+    if (!w->spare) {
+        timerwheel_delete(w, NULL);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    w->now = now;
+    w->offset = offset;
+    w->expire = expire;
+    w->ctx = ctx;
+    return w;
+}
+
+void timerwheel_delete(struct timerwheel *w, void (*destructor)(void *))
+{
+    if (!w) {
+        return;
+    }
+
+    for (size_t level = 0; level < TIMERWHEEL_LEVELS; level++) {
+        for (size_t i = 0; i < TIMERWHEEL_SLOTS; i++) {
+            list_delete(w->slots[level][i], destructor);
+        }
+    }
+
+    list_delete(w->spare, NULL);
+    free(w);
+}
+
+size_t timerwheel_size(const struct timerwheel *w)
+{
+    if (!w) {
+        return 0;
+    }
+
+    return w->size;
+}
+
+uint64_t timerwheel_now(const struct timerwheel *w)
+{
+    if (!w) {
+        return 0;
+    }
+
+    return w->now;
+}
+
+/// @return The slot for a timer due at @c expires, as seen from the next tick to process.
+static struct list *impl_slot(const struct timerwheel *w, uint64_t expires)
+{
+    uint64_t base = w->now + 1;
+    uint64_t delta;
+
+    if (expires < base) {
+        // Overdue: expire on the next tick.
+        expires = base;
+    }
+
+    delta = expires - base;
+    for (unsigned level = 0; level < TIMERWHEEL_LEVELS; level++) {
+        if (delta >> (TIMERWHEEL_BITS * (level + 1)) == 0) {
+            return w->slots[level][(expires >> (TIMERWHEEL_BITS * level)) & TIMERWHEEL_MASK];
+        }
+    }
+
+    // Beyond the wheel: park in the farthest slot, and cascade again from there.
+    expires = base + ((uint64_t)1 << (TIMERWHEEL_BITS * TIMERWHEEL_LEVELS)) - 1;
+    return w->slots[TIMERWHEEL_LEVELS - 1][(expires >> (TIMERWHEEL_BITS * (TIMERWHEEL_LEVELS - 1))) & TIMERWHEEL_MASK];
+}
+
+/// Link @c node at the end of its slot, moving it from its current list if any.
+static void impl_place(struct timerwheel *w, struct timerwheel_node *node)
+{
+    struct list *slot = impl_slot(w, node->expires);
+    struct list_iter *it = (struct list_iter *)&node->link;
+
+    if (node->link.list) {
+        list_splice_range(list_end(slot), it, list_next(it));
+    } else {
+        list_push_back(slot, (char *)node - w->offset);
+    }
+}
+
+int timerwheel_schedule(struct timerwheel *w, void *element, uint64_t expires)
+{
+    struct timerwheel_node *node;
+
+    if (!w || !element) {
+        return -EFAULT;
+    }
+
+    node = (struct timerwheel_node *)((char *)element + w->offset);
+    if (!node->link.list || node->link.list == w->expired) {
+        w->size++;
+    }
+
+    node->expires = expires;
+    impl_place(w, node);
+    return 0;
+}
+
+int timerwheel_cancel(struct timerwheel *w, void *element)
+{
+    struct timerwheel_node *node;
+
+    if (!w || !element) {
+        return -EFAULT;
+    }
+
+    node = (struct timerwheel_node *)((char *)element + w->offset);
+    if (!node->link.list) {
+        return -EINVAL;
+    }
+
+    if (node->link.list != w->expired) {
+        w->size--;
+    }
+
+    return list_erase((struct list_iter *)&node->link, NULL);
+}
+
+/// Redistribute the timers of slot @c i of @c level into the levels below.
+static void impl_cascade(struct timerwheel *w, unsigned level, size_t i)
+{
+    struct list *slot = w->slots[level][i];
+
+    while (!list_empty(slot)) {
+        impl_place(w, (struct timerwheel_node *)list_begin(slot));
+    }
+}
+
+/// Process tick @c now + 1.
+static size_t impl_tick(struct timerwheel *w)
+{
+    uint64_t tick = w->now + 1;
+    size_t i = tick & TIMERWHEEL_MASK;
+    size_t n;
+
+    // Entering a new slot of level n cascades it once the slot index of every level below wraps to zero.
+    for (unsigned level = 1; level < TIMERWHEEL_LEVELS; level++) {
+        if ((tick >> (TIMERWHEEL_BITS * (level - 1))) & TIMERWHEEL_MASK) {
+            break;
+        }
+        impl_cascade(w, level, (tick >> (TIMERWHEEL_BITS * level)) & TIMERWHEEL_MASK);
+    }
+
+    w->now = tick;
+
+    n = list_size(w->slots[0][i]);
+    if (n == 0) {
+        return 0;
+    }
+
+    // Detach the slot whole, so that timers the callback reschedules go to a fresh one.
+    w->expired = w->slots[0][i];
+    w->slots[0][i] = w->spare;
+    w->size -= n;
+
+    w->expire(w->expired, w->ctx);
+
+    list_clear(w->expired, NULL);
+    w->spare = w->expired;
+    w->expired = NULL;
+    return n;
+}
+
+size_t timerwheel_advance(struct timerwheel *w, uint64_t now)
+{
+    size_t n = 0;
+
+    if (!w) {
+        return 0;
+    }
+
+    while (w->now < now) {
+        if (w->size == 0) {
+            // Nothing to expire or cascade.
+            w->now = now;
+            break;
+        }
+        n += impl_tick(w);
+    }
+
+    return n;
+}
@@ -0,0 +1,102 @@
+#ifndef LIBLIST_TIMERWHEEL_H_
+#define LIBLIST_TIMERWHEEL_H_
+
+/// Hierarchical hashed timing wheel.
+///
+/// Elements embed @c TIMERWHEEL_NODE, which links them into one slot of the wheel; each slot is a @c struct list.
+/// Scheduling appends to a slot, cancelling is @c list_erase and rescheduling splices the timer to another slot, so
+/// all three are O(1) regardless of the number of timers.
+///
+/// Example:
+///
+///     struct my_conn {
+///         int fd;
+///         TIMERWHEEL_NODE(timeout);
+///     };
+///
+///     struct timerwheel *w = timerwheel_new(offsetof(struct my_conn, timeout), now_ms(), on_timeouts, NULL);
+///
+///     timerwheel_schedule(w, conn, now_ms() + 5000);
+///     ...
+///     timerwheel_advance(w, now_ms());
+///
+/// Time is counted in ticks of any unit. The wheel has four levels of 256 slots; level @c n holds timers due within
+/// 256^(n+1) ticks, and its slots are cascaded into the level below as time reaches them. Timers due further ahead
+/// than 2^32 ticks are cascaded again until they are within range.
+///
+/// Return conventions follow @c llist.h.
+
+#define TIMERWHEEL_NODE(name) struct timerwheel_node name
+
+#include "llist.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// Timing wheel object.
+/// This library is **not** thread-safe.
+struct timerwheel;
+
+struct timerwheel_node {
+    /// Slot link; must come first, so that the slot list offset equals the @c timerwheel_node offset.
+    struct list_node link;
+    /// Tick at which the timer expires.
+    uint64_t expires;
+};
+
+/// Constructor.
+/// @param offset The offset to @c timerwheel_node in elements.
+/// @param now Current tick.
+/// @param expire Function called with each batch of expired timers and @c ctx; it takes ownership of the timers, and
+///               may remove them from the list, reschedule or cancel them. Timers left in the list are unlinked when
+///               it returns.
+/// @return Pointer to wheel on success.
+/// @return NULL on failure, and errno is set to:
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Offset invalid.
+///   - ENOMEM: Insufficient memory.
+/// @note Memory ownership: Caller must timerwheel_delete() the returned pointer.
+struct timerwheel *timerwheel_new(size_t offset, uint64_t now, void (*expire)(struct list *expired, void *ctx),
+                                  void *ctx) PUBLIC;
+
+/// Destructor.
+/// @see list_delete.
+/// @note The expiry callback is not called.
+void timerwheel_delete(struct timerwheel *, void (*destructor)(void *)) PUBLIC;
+
+/// Get number of scheduled timers.
+/// @return The number of timers, or zero if NULL.
+size_t timerwheel_size(const struct timerwheel *) PUBLIC;
+
+/// Get the current tick.
+/// @return The tick last passed to @c timerwheel_advance or @c timerwheel_new, or zero if NULL.
+uint64_t timerwheel_now(const struct timerwheel *) PUBLIC;
+
+/// Schedule @c element to expire at tick @c expires, or reschedule it if already scheduled.
+/// A timer due at or before the current tick expires on the next one.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+/// @warning The element must not be in any list other than this wheel or the batch passed to the expiry callback.
+/// @note Memory ownership: On success the wheel takes ownership of the element.
+/// @note Complexity: O(1).
+int timerwheel_schedule(struct timerwheel *, void *element, uint64_t expires) PUBLIC;
+
+/// Cancel @c element.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - EINVAL: Element not scheduled.
+/// @warning The element must be in this wheel, or in the batch passed to the expiry callback.
+/// @note Memory ownership: On success the caller regains ownership of the element.
+/// @note Complexity: O(1).
+int timerwheel_cancel(struct timerwheel *, void *element) PUBLIC;
+
+/// Advance time to tick @c now, expiring due timers.
+/// Timers expiring on the same tick are detached together with their slot, and passed to the expiry callback in one
+/// call, in the order they were scheduled into that slot.
+/// @return Number of timers expired.
+/// @warning Must not be called from the expiry callback.
+/// @note Complexity: O(t + e) for t elapsed ticks and e expired timers; each timer is also cascaded at most once per
+///       level.
+size_t timerwheel_advance(struct timerwheel *, uint64_t now) PUBLIC;
+
+#endif
@@ -0,0 +1,345 @@
+#include "ulist.h"
+#include "llist_inline.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct ulist_chunk {
+    LIST_NODE(link);
+    size_t count;
+    void *elements[ULIST_CHUNK_CAPACITY];
+};
+
+struct ulist {
+    /// Chunks, in element order; never holds an empty chunk.
+    struct list *chunks;
+    size_t size;
+};
+
+/// @return Chunk embedding @c node, or NULL if @c node is the sentinel of @c l.
+static struct ulist_chunk *impl_chunk(const struct ulist *l, struct list_node *node)
+{
+    if (node == &l->chunks->sentinel) {
+        return NULL;
+    }
+
+    return (struct ulist_chunk *)((char *)node - offsetof(struct ulist_chunk, link));
+}
+
+static struct ulist_chunk *impl_first(const struct ulist *l)
+{
+    return impl_chunk(l, l->chunks->sentinel.next);
+}
+
+static struct ulist_chunk *impl_last(const struct ulist *l)
+{
+    return impl_chunk(l, l->chunks->sentinel.prev);
+}
+
+/// Allocate an empty chunk and link it before @c pos.
+/// @return Chunk on success, NULL otherwise.
+static struct ulist_chunk *impl_chunk_new(struct list_node *pos)
+{
+    struct ulist_chunk *chunk = malloc(sizeof(struct ulist_chunk));
+    if (!chunk) {
+        return NULL;
+    }
+
+    chunk->count = 0;
+    list_inline_insert((struct list_iter *)pos, chunk);
+    return chunk;
+}
+
+static void impl_chunk_delete(struct ulist_chunk *chunk)
+{
+    list_inline_unlink((struct list_iter *)&chunk->link);
+    free(chunk);
+}
+
+struct ulist *ulist_new(void)
+{
+    struct ulist *l = calloc(1, sizeof(struct ulist));
+    if (!l) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    l->chunks = list_new(offsetof(struct ulist_chunk, link));
+    if (!l->chunks) {
+        free(l);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    return l;
+}
+
+void ulist_delete(struct ulist *l, void (*destructor)(void *))
+{
+    if (!l) {
+        return;
+    }
+
+    ulist_clear(l, destructor);
+    list_delete(l->chunks, NULL);
+    free(l);
+}
+
+bool ulist_empty(const struct ulist *l)
+{
+    return !l || l->size == 0;
+}
+
+size_t ulist_size(const struct ulist *l)
+{
+    return l ? l->size : 0;
+}
+
+int ulist_clear(struct ulist *l, void (*destructor)(void *))
+{
+    struct ulist_chunk *chunk;
+
+    if (!l) {
+        return -EFAULT;
+    }
+
+    while ((chunk = impl_first(l))) {
+        if (destructor) {
+            for (size_t i = 0; i < chunk->count; i++) {
+                destructor(chunk->elements[i]);
+            }
+        }
+        impl_chunk_delete(chunk);
+    }
+
+    l->size = 0;
+    return 0;
+}
+
+struct ulist_iter ulist_begin(struct ulist *l)
+{
+    struct ulist_iter it = { l, l ? impl_first(l) : NULL, 0 };
+    return it;
+}
+
+struct ulist_iter ulist_end(struct ulist *l)
+{
+    struct ulist_iter it = { l, NULL, 0 };
+    return it;
+}
+
+struct ulist_iter ulist_next(struct ulist_iter it)
+{
+    if (!it.chunk) {
+        return it;
+    }
+
+    if (++it.index == it.chunk->count) {
+        it.chunk = impl_chunk(it.list, it.chunk->link.next);
+        it.index = 0;
+    }
+
+    return it;
+}
+
+struct ulist_iter ulist_prev(struct ulist_iter it)
+{
+    struct ulist_chunk *chunk;
+
+    if (!it.list) {
+        return it;
+    }
+
+    if (it.chunk && it.index > 0) {
+        it.index--;
+        return it;
+    }
+
+    chunk = it.chunk ? impl_chunk(it.list, it.chunk->link.prev) : impl_last(it.list);
+    if (chunk) {
+        it.chunk = chunk;
+        it.index = chunk->count - 1;
+    }
+
+    return it;
+}
+
+bool ulist_iter_equal(struct ulist_iter a, struct ulist_iter b)
+{
+    return a.list == b.list && a.chunk == b.chunk && a.index == b.index;
+}
+
+void *ulist_at(struct ulist_iter it)
+{
+    return it.chunk ? it.chunk->elements[it.index] : NULL;
+}
+
+int ulist_insert(struct ulist_iter *it, void *element)
+{
+    struct ulist *l;
+    struct ulist_chunk *chunk;
+    size_t index;
+
+    if (!it || !it->list || !element) {
+        return -EFAULT;
+    }
+
+    l = it->list;
+    if (l->size == SIZE_MAX) {
+        return -EOVERFLOW;
+    }
+
+    chunk = it->chunk;
+    index = it->index;
+
+    if (!chunk) {
+        // Append to the last chunk, or start a new one.
+        chunk = impl_last(l);
+        if (!chunk || chunk->count == ULIST_CHUNK_CAPACITY) {
+            chunk = impl_chunk_new(&l->chunks->sentinel);
+            if (!chunk) {
+                return -ENOMEM;
+            }
+        }
+        index = chunk->count;
+    } else if (chunk->count == ULIST_CHUNK_CAPACITY) {
+        // Split: move the upper half to a new successor chunk.
+        const size_t half = ULIST_CHUNK_CAPACITY / 2;
+        struct ulist_chunk *upper = impl_chunk_new(chunk->link.next);
+        if (!upper) {
+            return -ENOMEM;
+        }
+
+        memcpy(upper->elements, &chunk->elements[half], (ULIST_CHUNK_CAPACITY - half) * sizeof(void *));
+        upper->count = ULIST_CHUNK_CAPACITY - half;
+        chunk->count = half;
+
+        if (index > half) {
+            chunk = upper;
+            index -= half;
+        }
+    }
+
+    memmove(&chunk->elements[index + 1], &chunk->elements[index], (chunk->count - index) * sizeof(void *));
+    chunk->elements[index] = element;
+    chunk->count++;
+    l->size++;
+
+    it->chunk = chunk;
+    it->index = index;
+    return 0;
+}
+
+int ulist_push_front(struct ulist *l, void *element)
+{
+    struct ulist_iter it;
+
+    if (!l || !element) {
+        return -EFAULT;
+    }
+
+    it = ulist_begin(l);
+    if (it.chunk && it.chunk->count == ULIST_CHUNK_CAPACITY) {
+        // Prefer a fresh chunk over splitting, so that repeated pushes fill it.
+        if (l->size == SIZE_MAX) {
+            return -EOVERFLOW;
+        }
+
+        it.chunk = impl_chunk_new(l->chunks->sentinel.next);
+        if (!it.chunk) {
+            return -ENOMEM;
+        }
+    }
+
+    return ulist_insert(&it, element);
+}
+
+int ulist_push_back(struct ulist *l, void *element)
+{
+    struct ulist_iter it = ulist_end(l);
+    return ulist_insert(&it, element);
+}
+
+/// Unlink and return element at @c it.
+static void *impl_pop(struct ulist_iter it)
+{
+    void *element;
+
+    if (!it.list) {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    element = ulist_at(it);
+    if (!element) {
+        errno = ENOENT;
+        return NULL;
+    }
+
+    ulist_erase(&it, NULL);
+    return element;
+}
+
+void *ulist_pop_front(struct ulist *l)
+{
+    return impl_pop(ulist_begin(l));
+}
+
+void *ulist_pop_back(struct ulist *l)
+{
+    return impl_pop(ulist_prev(ulist_end(l)));
+}
+
+int ulist_erase(struct ulist_iter *it, void (*destructor)(void *))
+{
+    struct ulist *l;
+    struct ulist_chunk *chunk;
+    struct ulist_chunk *next;
+    size_t index;
+    void *element;
+
+    if (!it || !it->list) {
+        return -EFAULT;
+    }
+
+    if (!it->chunk) {
+        return -ENOENT;
+    }
+
+    l = it->list;
+    chunk = it->chunk;
+    index = it->index;
+    element = chunk->elements[index];
+
+    chunk->count--;
+    memmove(&chunk->elements[index], &chunk->elements[index + 1], (chunk->count - index) * sizeof(void *));
+    l->size--;
+
+    next = impl_chunk(l, chunk->link.next);
+
+    if (chunk->count == 0) {
+        impl_chunk_delete(chunk);
+        chunk = next;
+        index = 0;
+    } else if (next && chunk->count + next->count <= ULIST_CHUNK_CAPACITY / 2) {
+        // Merge sparse neighbours to keep chunks dense.
+        memcpy(&chunk->elements[chunk->count], next->elements, next->count * sizeof(void *));
+        chunk->count += next->count;
+        impl_chunk_delete(next);
+    } else if (index == chunk->count) {
+        chunk = next;
+        index = 0;
+    }
+
+    it->chunk = chunk;
+    it->index = index;
+
+    if (destructor) {
+        destructor(element);
+    }
+
+    return 0;
+}
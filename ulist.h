@@ -0,0 +1,134 @@
+#ifndef LIBLIST_ULIST_H_
+#define LIBLIST_ULIST_H_
+
+/// Unrolled list, suited to scanning many small elements.
+///
+/// Element pointers are stored in chunks of @c ULIST_CHUNK_CAPACITY, and the chunks are linked by @c struct
+/// @c list_node. A scan therefore takes one cache miss per chunk rather than one per element.
+/// Elements do not embed any list management data.
+///
+/// Example:
+///
+///     struct ulist *l = ulist_new();
+///
+///     ulist_push_back(l, item);
+///     for (struct ulist_iter it = ulist_begin(l); !ulist_iter_equal(it, ulist_end(l)); it = ulist_next(it)) {
+///         use(ulist_at(it));
+///     }
+///
+/// Return conventions follow @c llist.h.
+///
+/// Iterators are values that address a slot in a chunk. Unlike @c llist.h, inserting or erasing shifts elements:
+/// - @c ulist_insert, @c ulist_erase, @c ulist_push_front and @c ulist_pop_front invalidate iterators into the
+///   affected chunk and its successor. The iterator passed to @c ulist_insert or @c ulist_erase is updated in place.
+/// - @c ulist_push_back and @c ulist_pop_back only invalidate iterators to the removed element.
+/// - @c ulist_clear and @c ulist_delete invalidate all iterators.
+
+#include "llist.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/// Number of element pointers per chunk.
+/// Together with the chunk header this makes a chunk two 64-byte cache lines on LP64.
+#define ULIST_CHUNK_CAPACITY 12
+
+/// Unrolled list object.
+/// This library is **not** thread-safe.
+struct ulist;
+
+/// Chunk of element pointers.
+struct ulist_chunk;
+
+/// Iterator value.
+/// @c chunk is NULL for @c ulist_end.
+struct ulist_iter {
+    struct ulist *list;
+    struct ulist_chunk *chunk;
+    size_t index;
+};
+
+/// Constructor.
+/// @return Pointer to list on success.
+/// @return NULL on failure, and errno is set to:
+///   - ENOMEM: Insufficient memory.
+/// @note Memory ownership: Caller must ulist_delete() the returned pointer.
+struct ulist *ulist_new(void) PUBLIC;
+
+/// Destructor.
+/// @see list_delete.
+void ulist_delete(struct ulist *, void (*destructor)(void *)) PUBLIC;
+
+/// Test if list is empty.
+/// @return True if list is empty or NULL, false otherwise.
+bool ulist_empty(const struct ulist *) PUBLIC;
+
+/// Get number of elements in list.
+/// @return The number of elements in the list, or zero if empty or NULL.
+/// @note Complexity: O(1).
+size_t ulist_size(const struct ulist *) PUBLIC;
+
+/// Erases all elements from the container.
+/// @see list_clear.
+int ulist_clear(struct ulist *, void (*destructor)(void *)) PUBLIC;
+
+/// Get iterator to first element of list.
+/// @return Iterator to first element, or @c ulist_end if the list is empty or NULL.
+struct ulist_iter ulist_begin(struct ulist *) PUBLIC;
+
+/// Get an iterator past the last element of list.
+/// @return Iterator past the last element.
+struct ulist_iter ulist_end(struct ulist *) PUBLIC;
+
+/// Forward move iterator.
+/// @return Iterator to next element, or @c it unchanged if @c it is @c ulist_end.
+struct ulist_iter ulist_next(struct ulist_iter it) PUBLIC;
+
+/// Backward move iterator.
+/// @return Iterator to previous element, or @c it unchanged if @c it is @c ulist_begin.
+struct ulist_iter ulist_prev(struct ulist_iter it) PUBLIC;
+
+/// Compare iterators.
+/// @return True if @c a and @c b address the same position.
+bool ulist_iter_equal(struct ulist_iter a, struct ulist_iter b) PUBLIC;
+
+/// Dereference iterator.
+/// @return Pointer to element, or NULL for @c ulist_end.
+void *ulist_at(struct ulist_iter it) PUBLIC;
+
+/// Insert @c element before the element pointed to by @c it.
+/// A full chunk is split in two.
+/// @param it Position; on success updated to address the inserted element.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - ENOMEM: Insufficient memory.
+///   - EOVERFLOW: List cannot grow.
+/// @note Complexity: O(ULIST_CHUNK_CAPACITY).
+int ulist_insert(struct ulist_iter *it, void *element) PUBLIC;
+
+/// Insert element at front of list.
+/// @see ulist_insert.
+int ulist_push_front(struct ulist *, void *element) PUBLIC;
+
+/// Insert element at back of list.
+/// @see ulist_insert.
+int ulist_push_back(struct ulist *, void *element) PUBLIC;
+
+/// Remove and return the first element of the list.
+/// @see list_pop_front.
+void *ulist_pop_front(struct ulist *) PUBLIC;
+
+/// Remove and return the last element of the list.
+/// @see list_pop_front.
+void *ulist_pop_back(struct ulist *) PUBLIC;
+
+/// Remove element from the list, calling @c destructor.
+/// Chunks are released when empty, and merged with their successor when both are sparse.
+/// @param it Position; on success updated to address the element that followed the erased one.
+/// @return Zero on success, negative errno otherwise.
+///   - EFAULT: NULL pointer argument.
+///   - ENOENT: Iterator @c ulist_end cannot be erased.
+/// @note Complexity: O(ULIST_CHUNK_CAPACITY).
+int ulist_erase(struct ulist_iter *it, void (*destructor)(void *)) PUBLIC;
+
+#endif